@@ -12,6 +12,10 @@ module.exports = b.suite(
     async () => readTestAsyncIterator('/vsimem/AROME_T2m_10.tiff', true)),
   b.add('RasterReadStream w/o blockOptimize w/async iterator',
     async () => readTestAsyncIterator('/vsimem/AROME_T2m_10.tiff', false)),
+  b.add('RasterReadStream w/ blockOptimize w/o prefetch',
+    async () => readTest('/vsimem/AROME_T2m_10.tiff', true, 1)),
+  b.add('RasterReadStream w/ blockOptimize w/async iterator w/o prefetch',
+    async () => readTestAsyncIterator('/vsimem/AROME_T2m_10.tiff', true, 1)),
 
   b.cycle(),
   b.complete()
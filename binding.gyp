@@ -14,6 +14,12 @@
 				"src/utils/number_list.cpp",
 				"src/utils/warp_options.cpp",
 				"src/utils/ptr_manager.cpp",
+				"src/utils/async_stats.cpp",
+				"src/utils/pinned_block.cpp",
+				"src/utils/pixel_conversion.cpp",
+				"src/utils/zonal_stats.cpp",
+				"src/utils/raster_expression.cpp",
+				"src/utils/tile_renderer.cpp",
 				"src/node_gdal.cpp",
 				"src/async.cpp",
 				"src/gdal_common.cpp",
@@ -50,6 +56,7 @@
 				"src/gdal_utils.cpp",
 				"src/gdal_fs.cpp",
 				"src/collections/dataset_bands.cpp",
+				"src/collections/dataset_pixels.cpp",
 				"src/collections/dataset_layers.cpp",
 				"src/collections/layer_features.cpp",
 				"src/collections/layer_fields.cpp",
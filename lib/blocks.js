@@ -0,0 +1,101 @@
+/**
+ * @typedef {object} RasterBlock
+ * @property {number} x Pixel offset of the region
+ * @property {number} y Line offset of the region
+ * @property {number} width
+ * @property {number} height
+ * @property {TypedArray} data The pixels of the region, `width * height` values in row-major order
+ */
+
+/**
+ * @typedef {object} BlocksOptions
+ * @property {string} [type]
+ * @property {{x: number, y: number, width: number, height: number}} [window]
+ * @property {number} [prefetch]
+ */
+
+module.exports = (gdal) =>
+/**
+ * Iterates asynchronously over the blocks of a raster band in the natural
+ * block order of the file - the blocks of the first block row from left to
+ * right, then the second block row and so on.
+ *
+ * The next blocks are read in background threads while the consumer
+ * processes the current one. The arrays are recycled: the `data` of a block
+ * remains valid only until the iterator is advanced, it must be copied if it
+ * is to be kept.
+ *
+ * When a `window` is given, only the blocks intersecting it are returned and
+ * each one is clipped to the window.
+ *
+ * @example
+ *
+ * for await (const blk of band.pixels.blocks({ type: gdal.GDT_Float64 })) {
+ *   console.log(blk.x, blk.y, blk.width, blk.height, blk.data[0])
+ * }
+ *
+ * @memberof RasterBandPixels
+ * @instance
+ * @method blocks
+ * @param {BlocksOptions} [options]
+ * @param {string} [options.type] Data type to convert to, default is the raster band data type, see {@link GDT|GDT constants}
+ * @param {{x: number, y: number, width: number, height: number}} [options.window] The region to iterate over, default is the whole raster
+ * @param {number} [options.prefetch=1] Number of blocks read in advance
+ * @returns {AsyncIterableIterator<RasterBlock>}
+ */
+  async function* blocks(options) {
+    options = options || {}
+    const band = this.band
+    const [ blockSize, rasterSize, dataType ] =
+      await Promise.all([ band.blockSizeAsync, band.sizeAsync, band.dataTypeAsync ])
+    const Type = gdal.fromDataType(options.type || dataType)
+
+    const window = options.window || { x: 0, y: 0, width: rasterSize.x, height: rasterSize.y }
+    if (window.x < 0 || window.y < 0 || window.width <= 0 || window.height <= 0 ||
+      window.x + window.width > rasterSize.x || window.y + window.height > rasterSize.y) {
+      throw new RangeError('window must be a non-empty region of the raster')
+    }
+
+    const prefetch = options.prefetch !== undefined ? Math.floor(options.prefetch) : 1
+    if (!(prefetch >= 0)) throw new TypeError('"prefetch" must be a positive number')
+
+    // The blocks intersecting the window
+    const regions = []
+    const xEnd = window.x + window.width
+    const yEnd = window.y + window.height
+    for (let by = Math.floor(window.y / blockSize.y); by * blockSize.y < yEnd; by++) {
+      const y = Math.max(by * blockSize.y, window.y)
+      const height = Math.min((by + 1) * blockSize.y, yEnd) - y
+      for (let bx = Math.floor(window.x / blockSize.x); bx * blockSize.x < xEnd; bx++) {
+        const x = Math.max(bx * blockSize.x, window.x)
+        const width = Math.min((bx + 1) * blockSize.x, xEnd) - x
+        regions.push({ x, y, width, height })
+      }
+    }
+
+    // The consumer holds one array while prefetch other arrays are being filled
+    const ring = new Array(prefetch + 1)
+    const queue = []
+    let next = 0
+    const start = () => {
+      if (next >= regions.length) return
+      const region = regions[next]
+      const slot = next % ring.length
+      next++
+      if (!ring[slot]) ring[slot] = new Type(blockSize.x * blockSize.y)
+      const data = ring[slot].subarray(0, region.width * region.height)
+      const q = this.readAsync(region.x, region.y, region.width, region.height, data)
+        .then(() => ({ ...region, data }))
+      // Errors are handled when the block is consumed
+      q.catch(() => undefined)
+      queue.push(q)
+    }
+
+    for (let i = 0; i < ring.length; i++) start()
+    while (queue.length > 0) {
+      const block = await queue.shift()
+      yield block
+      // The consumer has moved on, its array can be reused
+      start()
+    }
+  }
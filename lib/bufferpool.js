@@ -0,0 +1,115 @@
+/**
+ * @interface BufferPoolOptions
+ * @property {string} [type]
+ * @property {number} length
+ * @property {number} [max]
+ * @property {boolean} [shared]
+ */
+
+module.exports = (gdal) => {
+  /**
+   * A pool of recyclable TypedArrays of the same type and length
+   *
+   * Tile servers that read many regions of the same size can avoid allocating
+   * a new array (and the resulting garbage collections) for every read by
+   * passing the pool in the `pool` option of the read methods and by
+   * returning each array with `release()` once it has been sent.
+   *
+   * An array obtained from the pool must not be used after it has been released.
+   *
+   * @class BufferPool
+   * @constructor
+   * @param {BufferPoolOptions} options
+   * @param {string} [options.type=gdal.GDT_Byte] Data type of the arrays, see {@link GDT|GDT constants}
+   * @param {number} options.length Length of the arrays (in elements)
+   * @param {number} [options.max=16] Maximum number of free arrays kept in the pool
+   * @param {boolean} [options.shared=false] Allocate the arrays in SharedArrayBuffers
+   */
+  class BufferPool {
+    constructor(options) {
+      if (typeof options !== 'object' || options === null) {
+        throw new TypeError('options must be an object')
+      }
+      this.type = options.type || gdal.GDT_Byte
+      this.arrayConstructor = gdal.fromDataType(this.type)
+      this.length = Math.floor(options.length)
+      if (!(this.length > 0)) throw new TypeError('"length" must be a positive number')
+      this.max = options.max !== undefined ? Math.floor(options.max) : 16
+      if (!(this.max >= 0)) throw new TypeError('"max" must be a positive number')
+      this.shared = !!options.shared
+      this.free = []
+      // The ArrayBuffers allocated by this pool
+      this.owned = new WeakSet()
+    }
+
+    /**
+     * Get an array from the pool, a new one is allocated when the pool is empty
+     *
+     * @method get
+     * @instance
+     * @memberof BufferPool
+     * @returns {TypedArray}
+     */
+    get() {
+      if (this.free.length > 0) return this.free.pop()
+      const array = this.shared ?
+        new this.arrayConstructor(new SharedArrayBuffer(this.length * this.arrayConstructor.BYTES_PER_ELEMENT)) :
+        new this.arrayConstructor(this.length)
+      this.owned.add(array.buffer)
+      return array
+    }
+
+    /**
+     * Return an array to the pool, the arrays that were not allocated by this
+     * pool and the arrays exceeding `max` are left to the garbage collector
+     *
+     * @method release
+     * @instance
+     * @memberof BufferPool
+     * @param {TypedArray} array
+     * @returns {void}
+     */
+    release(array) {
+      if (!array || !this.owned.has(array.buffer) || this.free.length >= this.max) return
+      if (this.free.some((a) => a.buffer === array.buffer)) return
+      this.free.push(new this.arrayConstructor(array.buffer, 0, this.length))
+    }
+
+    /**
+     * Number of free arrays in the pool
+     *
+     * @kind member
+     * @name available
+     * @instance
+     * @memberof BufferPool
+     * @readonly
+     * @type {number}
+     */
+    get available() {
+      return this.free.length
+    }
+  }
+
+  /**
+   * Create a pool of recyclable TypedArrays for the read methods
+   *
+   * @example
+   *
+   * const pool = gdal.createBufferPool({ type: gdal.GDT_Byte, length: 256 * 256 })
+   * const data = await band.pixels.readAsync(0, 0, 256, 256, undefined, { pool })
+   * // ... send the data
+   * pool.release(data)
+   *
+   * @static
+   * @method createBufferPool
+   * @param {BufferPoolOptions} options
+   * @param {string} [options.type=gdal.GDT_Byte] Data type of the arrays, see {@link GDT|GDT constants}
+   * @param {number} options.length Length of the arrays (in elements)
+   * @param {number} [options.max=16] Maximum number of free arrays kept in the pool
+   * @param {boolean} [options.shared=false] Allocate the arrays in SharedArrayBuffers
+   * @returns {BufferPool}
+   */
+  const createBufferPool = (options) => new BufferPool(options)
+
+  return { BufferPool, createBufferPool }
+}
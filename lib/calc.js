@@ -4,6 +4,7 @@
  * @property {boolean} [convertNoData]
  * @property {boolean} [convertInput]
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  */
 
 /**
@@ -14,30 +15,37 @@
  * It is fully async and reading and decoding of input and output bands happen
  * in separate background threads for each band as long as they are in separate datasets.
  *
- * The main bottleneck is the passed function `fn` which must always run on the main Node.js/V8 thread.
- * This is a fundamental Node.js/V8 limitation that is impossible to overcome.
- *
- * This function is not to be used in server code that must remain responsive at all times.
+ * When `fn` is a JS function, the main bottleneck is the function itself which must always run
+ * on the main Node.js/V8 thread. This is a fundamental Node.js/V8 limitation that is impossible to overcome.
  * It does not directly block the event loop, but it is very CPU-heavy and cannot
  * run parallel to other instances of itself. If multiple instances run in parallel, they
  * will all compete for the main thread, executing `fn` on the incoming data chunks on turn by turn basis.
- *
- * It internally uses a {@link RasterTransform} which can also be used directly for
+ * This mode internally uses a {@link RasterTransform} which can also be used directly for
  * a finer-grained control over the transformation.
  *
- * You can check the `gdal-exprtk` plugin for an alternative implementation which uses
- * an ExprTk expression instead of a JS function and performs only O(1) operations on the main thread
+ * When `fn` is a string, it is an arithmetic expression of the names of the inputs that is
+ * compiled by the bindings and evaluated block by block in a background thread - the main
+ * thread is used only for parsing the expression. Several instances run in parallel.
+ * The expression supports:
+ * - numbers and the constants `pi`, `e` and `nan`
+ * - the operators `+ - * / % ^` (power), `< <= > >= == !=`, `&& || !` and `cond ? a : b`
+ * - the functions `abs sqrt exp log log10 sin cos tan asin acos atan atan2 floor ceil round pow min max isnan`
+ *
+ * The values are doubles, the comparisons and the logical operators return 1 or 0 and `NaN` is false,
+ * with `convertNoData` the NoData inputs are `NaN` and `NaN` propagates through the arithmetic.
+ * Only this mode should be used in server code that must remain responsive at all times.
  *
  * There is no sync version
  *
  * @function calcAsync
  * @param {Record<string, RasterBand>} inputs An object containing all the input bands
  * @param {RasterBand} output Output raster band
- * @param {(...args: number[]) => number} fn Function to apply on all pixels, it must have the same number of arguments as there are input bands
+ * @param {string | ((...args: number[]) => number)} fn Expression or function to apply on all pixels, a function must have the same number of arguments as there are input bands
  * @param {CalcOptions} [options] Options
  * @param {boolean} [options.convertNoData=false] Input bands will have their NoData pixels converted to NaN and a NaN output value of the given function will be converted to a NoData pixel, provided that the output raster band has its `RasterBand.noDataValue` set
  * @param {boolean} [options.convertInput=false] Input bands will have their pixels converted to the output data type before calling the user-supplied function, can be used to allow integer data types to get their NoData converted to `NaN`
  * @param {ProgressCb} [options.progress_cb=undefined] Progress callback
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered, only with an expression
  * @return {Promise<void>}
  * @static
  *
@@ -57,6 +65,12 @@
  *  t: await T2m.bands.getAsync(1),
  *  td: await D2m.bands.getAsync(1)
  * }, cloudBase.bands.getAsync(1), espyFn, { convertNoData: true });
+ *
+ * // The same computation without JS in the pixel loop
+ * await calcAsync({
+ *  t: await T2m.bands.getAsync(1),
+ *  td: await D2m.bands.getAsync(1)
+ * }, await cloudBase.bands.getAsync(1), '125 * (t - td)', { convertNoData: true });
  */
 
 const calc = (gdal) => function calcAsync(inputs, output, fn, options) {
@@ -72,12 +86,18 @@ const calc = (gdal) => function calcAsync(inputs, output, fn, options) {
   if (!(output instanceof gdal.RasterBand)) {
     return Promise.reject(new TypeError('output must be an instance of gdal.RasterBand'))
   }
-  if (typeof fn !== 'function') return Promise.reject(new TypeError('fn must be a function'))
+  if (typeof fn !== 'function' && typeof fn !== 'string') {
+    return Promise.reject(new TypeError('fn must be a function or a string'))
+  }
 
   if (progress !== undefined && typeof progress !== 'function') {
     return Promise.reject(new TypeError('progress_cb must be a function'))
   }
 
+  if (typeof fn === 'string') {
+    return gdal._calcExpressionAsync(inputs, output, fn, options || {})
+  }
+
   const inSizesQ = Object.keys(inputs).map((inp) => inputs[inp].sizeAsync)
   const outSizeQ = output.sizeAsync
   const outTypeQ = output.dataTypeAsync
@@ -143,6 +143,10 @@ gdal.RasterBandPixels.prototype.createWriteStream = writeStream.createWriteStrea
 gdal.RasterWriteStream = writeStream.RasterWriteStream
 gdal.RasterMuxStream = muxStream.RasterMuxStream
 gdal.RasterTransform = muxStream.RasterTransform
+gdal.RasterBandPixels.prototype.blocks = require('./blocks')(gdal)
+const bufferPool = require('./bufferpool')(gdal)
+gdal.BufferPool = bufferPool.BufferPool
+gdal.createBufferPool = bufferPool.createBufferPool
 
 gdal.calcAsync = require('./calc')(gdal)
 
@@ -228,6 +232,16 @@ gdal.createPixelFuncWithArgs = function createPixelFunc(fn) {
  * @property {ProgressCb} progress_cb
  */
 
+/**
+ * Options accepted by all async methods as their last argument before the callback
+ * (the native methods receive them right after the callback)
+ *
+ * @typedef {object} AsyncOptions
+ * @property {AbortSignal} [signal] Abort the operation when this AbortSignal is triggered
+ * @property {number} [priority=0] Operations with higher priority are started first
+ * @property {number} [deadline] Fail the operation if it has not started before this time (ms since the epoch, as returned by `Date.now()`)
+ */
+
 /**
  * Returns a TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) constructor from a GDAL data type
  *
@@ -654,6 +668,14 @@ function getTypedArrayType(array) {
   return 0 // gdal.GDT_Unknown
 }
 
+// Extract the async job options from a read/write options object
+const asyncOptions = (options) => {
+  if (options.signal === undefined && options.priority === undefined && options.deadline === undefined) {
+    return undefined
+  }
+  return { signal: options.signal, priority: options.priority, deadline: options.deadline }
+}
+
 const mangleWrite = (args) => {
   let [ x, y, width, height, data, options ] = args
   if (!options) options = {}
@@ -669,13 +691,94 @@ const mangleWrite = (args) => {
     options.pixel_space,
     options.line_space,
     options.progress_cb,
-    options.offset
+    options.offset,
+    options.convertNoData,
+    options.noDataFrom,
+    options.unscale,
+    undefined,
+    asyncOptions(options)
   ]
 }
 
 const mangleRead = (args) => {
   let [ x, y, width, height, data, options ] = args
   if (!options) options = {}
+  if (!data && options.pool) data = options.pool.get()
+  if (data) data._gdal_type = getTypedArrayType(data)
+  return [
+    x,
+    y,
+    width,
+    height,
+    data,
+    options.buffer_width,
+    options.buffer_height,
+    options.type,
+    options.pixel_space,
+    options.line_space,
+    options.resampling,
+    options.progress_cb,
+    options.offset,
+    options.parallel,
+    options.shared,
+    options.convertNoData,
+    options.noDataTo,
+    options.unscale,
+    undefined,
+    asyncOptions(options)
+  ]
+}
+
+const mangleReadWithMask = (args) => {
+  let [ x, y, width, height, data, options ] = args
+  if (!options) options = {}
+  if (data) data._gdal_type = getTypedArrayType(data)
+  if (options.mask) options.mask._gdal_type = getTypedArrayType(options.mask)
+  return [
+    x,
+    y,
+    width,
+    height,
+    data,
+    options.buffer_width,
+    options.buffer_height,
+    options.type,
+    options.resampling,
+    options.mask,
+    options.premultiply,
+    undefined,
+    asyncOptions(options)
+  ]
+}
+
+const mangleDatasetWrite = (args) => {
+  let [ x, y, width, height, data, options ] = args
+  if (!options) options = {}
+  if (data) data._gdal_type = getTypedArrayType(data)
+  return [
+    x,
+    y,
+    width,
+    height,
+    data,
+    options.bands,
+    options.interleave,
+    options.buffer_width,
+    options.buffer_height,
+    options.pixel_space,
+    options.line_space,
+    options.band_space,
+    options.progress_cb,
+    options.offset,
+    undefined,
+    asyncOptions(options)
+  ]
+}
+
+const mangleDatasetRead = (args) => {
+  let [ x, y, width, height, data, options ] = args
+  if (!options) options = {}
+  if (!data && options.pool) data = options.pool.get()
   if (data) data._gdal_type = getTypedArrayType(data)
   return [
     x,
@@ -683,22 +786,81 @@ const mangleRead = (args) => {
     width,
     height,
     data,
+    options.bands,
+    options.interleave,
     options.buffer_width,
     options.buffer_height,
     options.type,
     options.pixel_space,
     options.line_space,
+    options.band_space,
     options.resampling,
     options.progress_cb,
-    options.offset
+    options.offset,
+    undefined,
+    asyncOptions(options)
+  ]
+}
+
+const mangleAdvise = (args) => {
+  let [ x, y, width, height, options ] = args
+  if (!options) options = {}
+  return [
+    x,
+    y,
+    width,
+    height,
+    options.buffer_width,
+    options.buffer_height,
+    options.type,
+    undefined,
+    asyncOptions(options)
   ]
 }
 
 const mangleBlock = (args) => {
+  if (args[2] instanceof gdal.BufferPool) args[2] = args[2].get()
   if (args[2]) args[2]._gdal_type = getTypedArrayType(args[2])
   return args
 }
 
+const mangleStatistics = (args) => {
+  const [ approx, options ] = args
+  if (!options) return [ approx ]
+  return [ approx, options.parallel, undefined, asyncOptions(options) ]
+}
+
+// The options of computeHistogram/computePercentiles are parsed by the C++ code
+const mangleHistogram = (args) => {
+  const [ options ] = args
+  if (!options) return args
+  return [ options, undefined, asyncOptions(options) ]
+}
+
+const manglePercentiles = (args) => {
+  const [ percentiles, options ] = args
+  if (!options) return args
+  return [ percentiles, options, undefined, asyncOptions(options) ]
+}
+
+const mangleRenderTile = (args) => {
+  const [ options ] = args
+  if (typeof options !== 'object' || options === null) return args
+  return [ options, undefined, asyncOptions(options) ]
+}
+
+const mangleZonalStatistics = (args) => {
+  const [ band, layer, options ] = args
+  if (!options) return args
+  return [ band, layer, options, undefined, asyncOptions(options) ]
+}
+
+const mangleCalcExpression = (args) => {
+  const [ inputs, output, expression, options ] = args
+  if (!options) return args
+  return [ inputs, output, expression, options, undefined, asyncOptions(options) ]
+}
+
 const mangleMDArray = (args) => {
   if (typeof args[0] === 'object' && typeof args[0].data === 'object') {
     args[0].data._gdal_type = getTypedArrayType(args[0].data)
@@ -706,6 +868,29 @@ const mangleMDArray = (args) => {
   return args
 }
 
+const mangleBatch = (args) => {
+  if (Array.isArray(args[0])) {
+    for (const op of args[0]) {
+      if (op && typeof op.data === 'object' && op.data !== null) op.data._gdal_type = getTypedArrayType(op.data)
+    }
+  }
+  return args
+}
+
+gdal.Dataset.prototype.batch = (function () {
+  const batch = gdal.Dataset.prototype.batch
+  return function () {
+    return batch.apply(this, mangleBatch(arguments))
+  }
+})()
+
+gdal.RasterBand.prototype.computeStatistics = (function () {
+  const computeStatistics = gdal.RasterBand.prototype.computeStatistics
+  return function () {
+    return computeStatistics.apply(this, mangleStatistics(arguments))
+  }
+})()
+
 gdal.RasterBandPixels.prototype.read = (function () {
   const read = gdal.RasterBandPixels.prototype.read
   return function () {
@@ -713,6 +898,13 @@ gdal.RasterBandPixels.prototype.read = (function () {
   }
 })()
 
+gdal.RasterBandPixels.prototype.readWithMask = (function () {
+  const readWithMask = gdal.RasterBandPixels.prototype.readWithMask
+  return function () {
+    return readWithMask.apply(this, mangleReadWithMask(arguments))
+  }
+})()
+
 gdal.RasterBandPixels.prototype.write = (function () {
   const write = gdal.RasterBandPixels.prototype.write
   return function () {
@@ -720,11 +912,31 @@ gdal.RasterBandPixels.prototype.write = (function () {
   }
 })()
 
+gdal.RasterBandPixels.prototype.adviseRead = (function () {
+  const adviseRead = gdal.RasterBandPixels.prototype.adviseRead
+  return function () {
+    return adviseRead.apply(this, mangleAdvise(arguments))
+  }
+})()
+
+gdal.DatasetPixels.prototype.read = (function () {
+  const read = gdal.DatasetPixels.prototype.read
+  return function () {
+    return read.apply(this, mangleDatasetRead(arguments))
+  }
+})()
+
+gdal.DatasetPixels.prototype.write = (function () {
+  const write = gdal.DatasetPixels.prototype.write
+  return function () {
+    return write.apply(this, mangleDatasetWrite(arguments))
+  }
+})()
+
 gdal.RasterBandPixels.prototype.readBlock = (function () {
   const readBlock = gdal.RasterBandPixels.prototype.readBlock
-  return function (x, y, data) {
-    if (data) data._gdal_type = getTypedArrayType(data)
-    return readBlock.apply(this, arguments)
+  return function () {
+    return readBlock.apply(this, mangleBlock(arguments))
   }
 })()
 
@@ -762,7 +974,9 @@ const promisifiables = {
     buildOverviewsAsync: 4,
     executeSQLAsync: 3,
     getMetadataAsync: 1,
-    setMetadataAsync: 2
+    setMetadataAsync: 2,
+    batchAsync: 1,
+    renderTileAsync: 1
   },
   Layer: {
     flushAsync: 0
@@ -770,16 +984,25 @@ const promisifiables = {
   RasterBand: {
     flushAsync: 0,
     fillAsync: 2,
-    computeStatisticsAsync: 1,
+    computeStatisticsAsync: 2,
+    computeHistogramAsync: 1,
+    computePercentilesAsync: 2,
     getMetadataAsync: 1,
     setMetadataAsync: 2
   },
+  DatasetPixels: {
+    readAsync: 16,
+    writeAsync: 14
+  },
   RasterBandPixels: {
-    readAsync: 13,
-    writeAsync: 11,
+    readAsync: 18,
+    readWithMaskAsync: 11,
+    writeAsync: 14,
     readBlockAsync: 3,
     writeBlockAsync: 3,
     clampBlockAsync: 2,
+    lockBlockAsync: 2,
+    adviseReadAsync: 7,
     getAsync: 2,
     setAsync: 3
   },
@@ -876,6 +1099,7 @@ const promisifiables = {
     $sieveFilterAsync: 1,
     $checksumImageAsync: 5,
     $polygonizeAsync: 1,
+    $zonalStatisticsAsync: 3,
     $reprojectImageAsync: 1,
     $suggestedWarpOutputAsync: 1,
     $translateAsync: 4,
@@ -884,25 +1108,61 @@ const promisifiables = {
     $warpAsync: 5,
     $buildVRTAsync: 4,
     $rasterizeAsync: 4,
-    $_acquireLocksAsync: 3
+    $openPoolAsync: 2,
+    $_acquireLocksAsync: 3,
+    $_calcExpressionAsync: 4
   }
 }
 
 const argMangle = {
+  Dataset: {
+    batchAsync: mangleBatch,
+    renderTileAsync: mangleRenderTile
+  },
+  RasterBand: {
+    computeStatisticsAsync: mangleStatistics,
+    computeHistogramAsync: mangleHistogram,
+    computePercentilesAsync: manglePercentiles
+  },
+  DatasetPixels: {
+    readAsync: mangleDatasetRead,
+    writeAsync: mangleDatasetWrite
+  },
   RasterBandPixels: {
     readAsync: mangleRead,
+    readWithMaskAsync: mangleReadWithMask,
     writeAsync: mangleWrite,
     readBlockAsync: mangleBlock,
-    writeBlockAsync: mangleBlock
+    writeBlockAsync: mangleBlock,
+    adviseReadAsync: mangleAdvise
   },
   MDArray: {
     readAsync: mangleMDArray
+  },
+  $: {
+    $zonalStatisticsAsync: mangleZonalStatistics,
+    $_calcExpressionAsync: mangleCalcExpression
   }
 }
 
+// AbortSignal is a global only since Node.js 15
+const isAbortSignal = (a) => typeof a === 'object' && a !== null &&
+  typeof a.aborted === 'boolean' && typeof a.addEventListener === 'function'
+
+// An object containing only async job options
+const asyncOptionsKeys = [ 'signal', 'priority', 'deadline' ]
+const isAsyncOptions = (a) => {
+  if (isAbortSignal(a)) return true
+  if (typeof a !== 'object' || a === null || Object.getPrototypeOf(a) !== Object.prototype) return false
+  const keys = Object.keys(a)
+  return keys.length > 0 && keys.every((k) => asyncOptionsKeys.includes(k))
+}
+
 // For each *Async function create a function that checks if the last parameter is a callback
 // Then call either the original, either the promisified version with the callback
 // placed at the right argument number since the C++ code does not support floating callbacks
+// An optional AbortSignal or AsyncOptions object is accepted as the last argument
+// before the callback and is passed to the C++ code right after the callback
 for (const c of Object.keys(promisifiables)) {
   const klass = c === '$' ? gdal : gdal[c]
   if (klass === undefined) {
@@ -916,23 +1176,34 @@ for (const c of Object.keys(promisifiables)) {
       continue
     }
     base[m] = (function () {
-      const promisified = promisify(base[m])
       const original = base[m]
       const cbArg = promisifiables[c][_m]
       const mangle = argMangle[c] && argMangle[c][_m] ? argMangle[c][_m] : (a) => a
       return function () {
         let callback
-        if (typeof arguments[arguments.length - 1] === 'function') {
-          callback = arguments[arguments.length - 1]
-          arguments[arguments.length - 1] = undefined
+        let length = arguments.length
+        if (typeof arguments[length - 1] === 'function') {
+          callback = arguments[length - 1]
+          arguments[--length] = undefined
+        }
+        let jobOptions
+        if (length > 0 && isAsyncOptions(arguments[length - 1])) {
+          jobOptions = arguments[length - 1]
+          arguments[--length] = undefined
         }
-        let args = Array.prototype.slice.call(mangle(arguments), 0, cbArg)
+        const mangled = mangle(arguments)
+        if (isAsyncOptions(mangled[cbArg + 1])) jobOptions = mangled[cbArg + 1]
+        const args = Object.assign(new Array(cbArg).fill(undefined), Array.prototype.slice.call(mangled, 0, cbArg))
         if (callback) {
           args[cbArg] = callback
+          if (jobOptions) args[cbArg + 1] = jobOptions
           return original.apply(this, args)
         }
-        args = Object.assign(new Array(cbArg).fill(undefined), args)
-        return promisified.apply(this, args)
+        return new Promise((resolve, reject) => {
+          args[cbArg] = (err, result) => err ? reject(err) : resolve(result)
+          if (jobOptions) args[cbArg + 1] = jobOptions
+          original.apply(this, args)
+        })
       }
     })()
   }
@@ -10,6 +10,7 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_read|
  * @property {boolean} [blockOptimize]
  * @property {boolean} [convertNoData]
  * @property {new (len: number) => TypedArray} [type]
+ * @property {number} [prefetch]
  */
 
 /**
@@ -22,6 +23,7 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_read|
  * @param {boolean} [options.blockOptimize=true] Read by file blocks when possible (when `rasterSize.x == blockSize.x`)
  * @param {boolean} [options.convertNoData=true] Automatically convert `RasterBand.noDataValue` to `NaN`
  * @param {new (len: number) => TypedArray} [options.readAs=undefined] Data type to convert to, must be a `TypedArray` constructor
+ * @param {number} [options.prefetch=2] Number of chunks read in advance
  * @returns {RasterReadStream}
  */
 function createReadStream(options) {
@@ -37,6 +39,11 @@ function createReadStream(options) {
  *
  * Pixels are streamed in row-major order
  *
+ * Up to `prefetch` chunks are read in advance while the consumer
+ * processes the current one and the driver is advised of the upcoming
+ * region with `adviseReadAsync` so that network drivers can fetch it
+ * ahead of time
+ *
  * @class RasterReadStream
  * @extends stream.Readable
  * @constructor
@@ -45,15 +52,27 @@ function createReadStream(options) {
  * @param {boolean} [options.blockOptimize=true] Read by file blocks when possible (when `rasterSize.x == blockSize.x`)
  * @param {boolean} [options.convertNoData=false] Automatically convert `RasterBand.noDataValue` to `NaN`, requires float data types
  * @param {new (len: number) => TypedArray} [options.type=undefined] Data type to convert to, must be a `TypedArray` constructor, default is the raster band data type
+ * @param {number} [options.prefetch=2] Number of chunks read in advance, `1` disables the prefetching
  */
 class RasterReadStream extends Readable {
   constructor(options) {
     super({ ...options, objectMode: true })
     this.band = options.band
+    // Rows pushed to the consumer
     this.readingPos = 0
+    // Rows for which a read has been started
+    this.scheduledPos = 0
+    // Rows announced to the driver with adviseRead
+    this.advisedPos = 0
     this.blockPos = 0
     this.readingInProgress = false
     this.rasterEnded = false
+    // The reads in flight, in the order of the rows
+    this.queue = []
+    this.prefetch = options.prefetch !== undefined ? Math.max(Math.floor(options.prefetch), 1) : 2
+    if (isNaN(this.prefetch)) {
+      throw new TypeError('"prefetch" must be a number')
+    }
 
     if (typeof options.type !== 'undefined') {
       try {
@@ -74,11 +93,8 @@ class RasterReadStream extends Readable {
       .then(([ blockSize, rasterSize, noDataValue ]) => {
         this.blockSize = blockSize
         this.rasterSize = rasterSize
-        if (options.convertNoData && noDataValue !== null) {
-          this._convertNoData = this._doConvertNoData.bind(this, noDataValue)
-        } else {
-          this._convertNoData = () => undefined
-        }
+        // The NoData values are converted by the read jobs in the worker threads
+        this.readOptions = options.convertNoData && noDataValue !== null ? { convertNoData: true } : undefined
         if (blockSize.x == rasterSize.x && options.blockOptimize !== false) {
           debug('init done, optimized block read', blockSize, rasterSize)
           this._readNextBuffer = RasterReadStream.prototype._readNextBlock
@@ -96,24 +112,42 @@ class RasterReadStream extends Readable {
   }
 }
 
-RasterReadStream.prototype._doConvertNoData = function (noData, buffer) {
-  for (let i = 0; i < buffer.length; i++) {
-    if (buffer[i] === noData) buffer[i] = NaN
+// Starts the reads of the next chunks until there are prefetch chunks in flight
+// The reads are independent async operations, they are executed
+// on the thread pool while the consumer processes the previous chunks
+RasterReadStream.prototype._prefetch = function () {
+  while (this.queue.length < this.prefetch && this.scheduledPos < this.rasterSize.y) {
+    this._advise()
+    const q = this._readNextBuffer()
+    // Errors are handled when the chunk is consumed
+    q.catch(() => undefined)
+    this.queue.push(q)
   }
 }
 
+// Announces the next prefetch block rows to the driver
+RasterReadStream.prototype._advise = function () {
+  if (this.prefetch < 2 || this.scheduledPos < this.advisedPos) return
+  const end = Math.min(this.scheduledPos + this.prefetch * this.blockSize.y, this.rasterSize.y)
+  debug('advising', this.scheduledPos, end)
+  this.band.pixels.adviseReadAsync(0, this.scheduledPos, this.rasterSize.x, end - this.scheduledPos)
+    .catch((e) => debug('adviseRead failed', e))
+  this.advisedPos = end
+}
+
 RasterReadStream.prototype._readNext = function () {
   debug('reading next block', this.readingPos, this.readingInProgress)
   if (this.readingInProgress || this.rasterEnded) return
   this.readingInProgress = true
   this.initQ.then(() => {
-    debug('do read')
-    this._readNextBuffer()
+    this._prefetch()
+    debug('do read', this.queue.length)
+    this.queue.shift()
       .then((data) => {
         this.readingInProgress = false
-        this._convertNoData(data)
 
         debug('adding a new buffer', data.length)
+        this.readingPos += data.length / this.rasterSize.x
         const flowing = this.push(data)
         if (this.readingPos == this.rasterSize.y) {
           debug('raster ended at ', this.readingPos)
@@ -125,6 +159,8 @@ RasterReadStream.prototype._readNext = function () {
           this._readNext()
         } else {
           debug('push buffer is full')
+          // Keep reading in advance while the consumer is busy
+          this._prefetch()
         }
       })
       .catch((e) => {
@@ -137,16 +173,19 @@ RasterReadStream.prototype._readNext = function () {
 // Optimized reading when horizontally there is only one block (blockSize.x == rasterSize.x)
 // This is more often the case than not
 RasterReadStream.prototype._readNextBlock = function () {
-  const actualSize = this.readingPos + this.blockSize.y > this.rasterSize.y ?
-    this.rasterSize.y - this.readingPos :
+  const actualSize = this.scheduledPos + this.blockSize.y > this.rasterSize.y ?
+    this.rasterSize.y - this.scheduledPos :
     this.blockSize.y
   const array = this.arrayConstructor ? this.arrayConstructor() : undefined
-  const dataq = this.band.pixels.readBlockAsync(0, this.blockPos, array)
+  // readBlock has no options, the conversion needs a regular read of the block
+  const dataq = this.readOptions ?
+    this.band.pixels.readAsync(0, this.scheduledPos, this.rasterSize.x, actualSize, array, this.readOptions) :
+    this.band.pixels.readBlockAsync(0, this.blockPos, array)
+  this.scheduledPos += actualSize
+  this.blockPos++
 
   return dataq
     .then((data) => {
-      this.readingPos += actualSize
-      this.blockPos++
       // Edge blocks, need to be clamped as the data is smaller than the block
       if (actualSize != this.blockSize.y) {
         debug('clamping', this.blockSize, actualSize)
@@ -167,12 +206,10 @@ RasterReadStream.prototype._readNextLine = function () {
   } catch (e) {
     console.error(e)
   }
-  return this.band.pixels.readAsync(0, this.blockPos, this.rasterSize.x, 1, array)
-    .then((data) => {
-      this.readingPos++
-      this.blockPos++
-      return data
-    })
+  const dataq = this.band.pixels.readAsync(0, this.blockPos, this.rasterSize.x, 1, array, this.readOptions)
+  this.scheduledPos++
+  this.blockPos++
+  return dataq
 }
 
 RasterReadStream.prototype._read = function () {
@@ -76,11 +76,8 @@ class RasterWriteStream extends Writable {
         this.blockSize = blockSize
         this.blockLen = blockSize.x * blockSize.y
         this.rasterSize = rasterSize
-        if (options.convertNoData && noDataValue !== null) {
-          this._convertNoData = this._doConvertNoData.bind(this, noDataValue)
-        } else {
-          this._convertNoData = () => undefined
-        }
+        // The NaNs are converted by the write jobs in the worker threads
+        this.writeOptions = options.convertNoData && noDataValue !== null ? { convertNoData: true } : undefined
         if (blockSize.x == rasterSize.x && options.blockOptimize !== false) {
           debug('init done, optimized block write', blockSize, rasterSize)
           this._writeNextBuffer = RasterWriteStream.prototype._writeNextBlock
@@ -93,14 +90,11 @@ class RasterWriteStream extends Writable {
   }
 }
 
-RasterWriteStream.prototype._doConvertNoData = function (noData, buffer) {
-  for (let i = 0; i < buffer.length; i++) {
-    if (isNaN(buffer[i])) buffer[i] = noData
-  }
-}
-
 RasterWriteStream.prototype._writeNextBlock = function (buffer) {
-  const q = this.band.pixels.writeBlockAsync(0, this.blockPos, buffer)
+  // writeBlock has no options, the conversion needs a regular write of the block
+  const q = this.writeOptions ?
+    this.band.pixels.writeAsync(0, this.writingPos, this.rasterSize.x, this.blockSize.y, buffer, this.writeOptions) :
+    this.band.pixels.writeBlockAsync(0, this.blockPos, buffer)
   this.blockPos++
   this.writingPos += this.blockSize.y
   if (this.writingPos + this.blockSize.y > this.rasterSize.y) {
@@ -113,7 +107,7 @@ RasterWriteStream.prototype._writeNextBlock = function (buffer) {
 }
 
 RasterWriteStream.prototype._writeNextLine = function (buffer) {
-  const q = this.band.pixels.writeAsync(0, this.writingPos, this.rasterSize.x, 1, buffer)
+  const q = this.band.pixels.writeAsync(0, this.writingPos, this.rasterSize.x, 1, buffer, this.writeOptions)
   this.blockPos++
   this.writingPos++
   return q
@@ -150,7 +144,6 @@ RasterWriteStream.prototype._writeNext = function (cb) {
     }
 
     debug('writing', this.blockPos, this.writingPos, buffer.length)
-    this._convertNoData(buffer)
     q.push(this._writeNextBuffer(buffer))
     this.buffered -= buffer.length
     if (this.writingPos == this.rasterSize.y) {
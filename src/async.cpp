@@ -1,8 +1,8 @@
 #include "async.hpp"
 
-namespace node_gdal {
+#include <algorithm>
 
-std::thread::id mainV8ThreadId;
+namespace node_gdal {
 
 // *message coming from GDAL points to a statically allocated buffer
 GDALProgressInfo::GDALProgressInfo(double complete, const char *message) : complete(complete), message(message) {
@@ -17,8 +17,11 @@ GDALProgressInfo::GDALProgressInfo() : complete(0), message(nullptr) {
 // This is the GDAL form of the progress callback trampoline
 // It can be invoked both in the main thread (in sync mode) or in auxillary thread (in async mode)
 // It is essentially a gateway between the GDAL world and Node.js/V8 world
+// Returning 0 makes GDAL abort the current operation
 int ProgressTrampoline(double dfComplete, const char *pszMessage, void *pProgressArg) {
   GDALExecutionProgress *context = (GDALExecutionProgress *)pProgressArg;
+  if (context->isAborted()) return 0;
+  if (!context->isReporting()) return 1;
   // The dispatcher in async.hpp will delete it
   GDALProgressInfo *info = new GDALProgressInfo(dfComplete, pszMessage);
   // Go to the dispatcher
@@ -26,14 +29,57 @@ int ProgressTrampoline(double dfComplete, const char *pszMessage, void *pProgres
   return 1;
 }
 
+const char abortedError[] = "Operation has been aborted";
+const char deadlineError[] = "Deadline exceeded";
+
+bool parseAsyncOptions(Local<Value> arg, GDALAsyncOptions &options) {
+  if (arg->IsUndefined() || arg->IsNull()) return true;
+  if (!arg->IsObject()) {
+    Nan::ThrowTypeError("async options must be an object");
+    return false;
+  }
+  Local<Object> obj = arg.As<Object>();
+  // An AbortSignal given directly
+  if (Nan::Get(obj, Nan::New("aborted").ToLocalChecked()).ToLocalChecked()->IsBoolean()) {
+    options.signal = obj;
+    return true;
+  }
+  Local<Value> signal = Nan::Get(obj, Nan::New("signal").ToLocalChecked()).ToLocalChecked();
+  if (signal->IsObject()) options.signal = signal.As<Object>();
+  Local<Value> priority = Nan::Get(obj, Nan::New("priority").ToLocalChecked()).ToLocalChecked();
+  if (!priority->IsUndefined()) {
+    if (!priority->IsNumber()) {
+      Nan::ThrowTypeError("priority must be a number");
+      return false;
+    }
+    options.priority = Nan::To<int32_t>(priority).ToChecked();
+  }
+  Local<Value> deadline = Nan::Get(obj, Nan::New("deadline").ToLocalChecked()).ToLocalChecked();
+  if (!deadline->IsUndefined()) {
+    if (!deadline->IsNumber()) {
+      Nan::ThrowTypeError("deadline must be a number");
+      return false;
+    }
+    options.deadline = Nan::To<double>(deadline).ToChecked();
+  }
+  return true;
+}
+
 // From async.hpp:
 // typedef Nan::AsyncProgressWorkerBase<GDALProgressInfo> GDALAsyncProgressWorker;
 // typedef GDALAsyncProgressWorker::ExecutionProgress GDALAsyncExecutionProgress;
 // GDALAsyncExecutionProgress is an instance of a NAN templated class, in this case
 // the AsyncWorker is the final owner of the progress_callback
-GDALExecutionProgress::GDALExecutionProgress(const GDALAsyncExecutionProgress *async) : async(async), sync(nullptr) {
+GDALExecutionProgress::GDALExecutionProgress(
+  const GDALAsyncExecutionProgress *async, GDALDataset *handle, bool reporting, const std::atomic<bool> *abort_flag)
+  : async(async), sync(nullptr), handle(handle), reporting(reporting), abort_flag(abort_flag) {
+}
+GDALExecutionProgress::GDALExecutionProgress(const GDALSyncExecutionProgress *sync)
+  : async(nullptr), sync(sync), handle(nullptr), reporting(sync->hasCallback()), abort_flag(nullptr) {
 }
-GDALExecutionProgress::GDALExecutionProgress(const GDALSyncExecutionProgress *sync) : async(nullptr), sync(sync) {
+
+GDALProgressFunc GDALExecutionProgress::trampoline() const {
+  return reporting || abort_flag != nullptr ? ProgressTrampoline : nullptr;
 }
 
 GDALExecutionProgress::~GDALExecutionProgress() {
@@ -54,6 +100,18 @@ void GDALExecutionProgress::Send(GDALProgressInfo *info) const {
   if (sync) sync->Send(info);
 }
 
+// Pooled jobs are given a band of the main handle and must run
+// on the same band of the handle that the scheduler acquired for them
+GDALRasterBand *GDALExecutionProgress::pooledBand(GDALRasterBand *band) const {
+  if (handle == nullptr) return band;
+  return handle->GetRasterBand(band->GetBand());
+}
+
+GDALDataset *GDALExecutionProgress::pooledDataset(GDALDataset *ds) const {
+  if (handle == nullptr) return ds;
+  return handle;
+}
+
 // This is the sync execution context, it is the final owner of the progress_callback
 GDALSyncExecutionProgress::GDALSyncExecutionProgress(Nan::Callback *cb) : progress_callback(cb){};
 GDALSyncExecutionProgress::~GDALSyncExecutionProgress() {
@@ -69,4 +127,287 @@ void GDALSyncExecutionProgress::Send(GDALProgressInfo *info) const {
   if (try_catch.HasCaught()) throw "sync progress callback exception";
 }
 
+GDALAsyncWorkerBase::GDALAsyncWorkerBase(Nan::Callback *resultCallback, std::vector<long> &&ds_uids)
+  : GDALAsyncProgressWorker(resultCallback, "node-gdal:GDALAsyncWorker"),
+    pooled(false),
+    aborted(false),
+    abortable(false),
+    listening(false),
+    queued(false),
+    priority(0),
+    deadline(0),
+    seq(0),
+    stats(ds_uids),
+    enqueued_at(statsNow()),
+    started_at(0),
+    lock_uids(std::move(ds_uids)),
+    locks(),
+    pool_handle(nullptr) {
+  // Avoid deadlocks, the same order as ObjectStore::lockDatasets
+  std::sort(lock_uids.begin(), lock_uids.end());
+  lock_uids.erase(std::unique(lock_uids.begin(), lock_uids.end()), lock_uids.end());
+  if (!lock_uids.empty() && lock_uids.front() == 0) lock_uids.erase(lock_uids.begin());
+}
+
+// Size classes of 64 bytes, a GDALCallbackWorker is usually 400 to 700 bytes
+static const size_t workerSizeClass = 64;
+static const size_t workerSizeClasses = 32;
+static const size_t workerFreeListMax = 64;
+
+struct WorkerFreeLists {
+  std::vector<void *> lists[workerSizeClasses];
+  ~WorkerFreeLists() {
+    for (auto &list : lists)
+      for (void *p : list) ::operator delete(p);
+  }
+};
+
+// Each thread with an event loop has its own
+static thread_local WorkerFreeLists workerFreeLists;
+
+void *GDALAsyncWorkerBase::operator new(size_t size) {
+  size_t c = (size - 1) / workerSizeClass;
+  if (c >= workerSizeClasses) return ::operator new(size);
+  auto &list = workerFreeLists.lists[c];
+  if (!list.empty()) {
+    void *p = list.back();
+    list.pop_back();
+    return p;
+  }
+  return ::operator new((c + 1) * workerSizeClass);
+}
+
+void GDALAsyncWorkerBase::operator delete(void *p, size_t size) {
+  size_t c = (size - 1) / workerSizeClass;
+  if (c < workerSizeClasses && workerFreeLists.lists[c].size() < workerFreeListMax) {
+    workerFreeLists.lists[c].push_back(p);
+    return;
+  }
+  ::operator delete(p);
+}
+
+// Called in the worker thread once the job has finished
+void GDALAsyncWorkerBase::releaseLocks() {
+  if (locks.empty()) return;
+  std::vector<AsyncLock> to_release;
+  to_release.swap(locks);
+  object_store.unlockDatasets(to_release);
+}
+
+void GDALAsyncWorkerBase::setOptions(const GDALAsyncOptions &options) {
+  priority = options.priority;
+  deadline = options.deadline;
+  if (!options.signal.IsEmpty()) attachSignal(options.signal);
+}
+
+// The AbortSignal can be already aborted, otherwise we subscribe to its abort event
+void GDALAsyncWorkerBase::attachSignal(v8::Local<v8::Object> signal) {
+  abortable = true;
+  if (Nan::To<bool>(Nan::Get(signal, Nan::New("aborted").ToLocalChecked()).ToLocalChecked()).FromMaybe(false)) {
+    aborted = true;
+    return;
+  }
+  Local<Value> add = Nan::Get(signal, Nan::New("addEventListener").ToLocalChecked()).ToLocalChecked();
+  if (!add->IsFunction()) return;
+  Local<Function> listener =
+    Nan::GetFunction(Nan::New<FunctionTemplate>(abortListener, Nan::New<External>(this))).ToLocalChecked();
+  Local<Value> argv[] = {Nan::New("abort").ToLocalChecked(), listener};
+  Nan::Call(add.As<Function>(), signal, 2, argv);
+  SaveToPersistent("abort_signal", signal);
+  SaveToPersistent("abort_listener", listener);
+  listening = true;
+}
+
+NAN_METHOD(GDALAsyncWorkerBase::abortListener) {
+  GDALAsyncWorkerBase *worker = reinterpret_cast<GDALAsyncWorkerBase *>(info.Data().As<External>()->Value());
+  worker->abort();
+}
+
+// A queued job is dropped right away, a running job is interrupted by
+// the next call of the progress trampoline
+void GDALAsyncWorkerBase::abort() {
+  aborted = true;
+  if (queued) async_scheduler.cancel(this);
+}
+
+// Back on the main thread, the listener must be removed before the worker is deleted
+void GDALAsyncWorkerBase::WorkComplete() {
+  if (listening) {
+    Nan::HandleScope scope;
+    Local<Object> signal = GetFromPersistent("abort_signal").As<Object>();
+    Local<Value> remove = Nan::Get(signal, Nan::New("removeEventListener").ToLocalChecked()).ToLocalChecked();
+    if (remove->IsFunction()) {
+      Local<Value> argv[] = {Nan::New("abort").ToLocalChecked(), GetFromPersistent("abort_listener")};
+      Nan::Call(remove.As<Function>(), signal, 2, argv);
+    }
+    listening = false;
+  }
+  stats.complete(ErrorMessage() != nullptr);
+  GDALAsyncProgressWorker::WorkComplete();
+}
+
+thread_local AsyncScheduler async_scheduler;
+
+std::mutex AsyncScheduler::registry_lock;
+std::vector<AsyncScheduler *> AsyncScheduler::registry;
+
+AsyncScheduler::AsyncScheduler() : queues(), pending(0), handle(nullptr), sequence(0) {
+}
+
+// Must be called from the main thread of the isolate once its event loop exists
+void AsyncScheduler::initialize() {
+  handle = new uv_async_t;
+  handle->data = this;
+  uv_async_init(Nan::GetCurrentEventLoop(), handle, dispatchCallback);
+  // The handle must not keep the process alive when there is nothing to dispatch
+  uv_unref(reinterpret_cast<uv_handle_t *>(handle));
+  std::lock_guard<std::mutex> lock(registry_lock);
+  registry.push_back(this);
+}
+
+// Called when the environment of the isolate is destroyed, the handle
+// must be closed before its event loop
+void AsyncScheduler::shutdown() {
+  if (handle == nullptr) return;
+  {
+    std::lock_guard<std::mutex> lock(registry_lock);
+    registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+  }
+  uv_close(reinterpret_cast<uv_handle_t *>(handle), [](uv_handle_t *h) { delete reinterpret_cast<uv_async_t *>(h); });
+  handle = nullptr;
+}
+
+// Main thread only
+void AsyncScheduler::enqueue(GDALAsyncWorkerBase *job) {
+  // A job that has been aborted or has expired before starting will fail without running
+  if (job->aborted)
+    job->SetErrorMessage(abortedError);
+  else if (expired(job))
+    job->SetErrorMessage(deadlineError);
+  // A job that does not require any lock goes directly to libuv
+  if (job->lock_uids.empty() || job->ErrorMessage() != nullptr) {
+    start(job);
+    return;
+  }
+  job->seq = sequence++;
+  for (long uid : job->lock_uids) {
+    auto &q = queues[uid];
+    q.insert(std::upper_bound(q.begin(), q.end(), job, before), job);
+  }
+  // The job is counted as pending before trying to start it: a lock released
+  // by a worker thread after a failed attempt must send a wakeup
+  job->queued = true;
+  // Keep the event loop alive while there are jobs waiting for a Dataset
+  if (pending++ == 0) uv_ref(reinterpret_cast<uv_handle_t *>(handle));
+  // Nothing of higher priority is waiting on these Datasets -> try starting it right away
+  if (isRunnable(job) && tryStart(job)) {
+    for (long uid : job->lock_uids) queues[uid].pop_front();
+    job->queued = false;
+    if (--pending == 0) uv_unref(reinterpret_cast<uv_handle_t *>(handle));
+  }
+}
+
+// Main thread only, remove an aborted job from the queues, it never takes any lock
+void AsyncScheduler::cancel(GDALAsyncWorkerBase *job) {
+  for (long uid : job->lock_uids) {
+    auto &q = queues[uid];
+    q.erase(std::remove(q.begin(), q.end(), job), q.end());
+  }
+  job->queued = false;
+  if (--pending == 0) uv_unref(reinterpret_cast<uv_handle_t *>(handle));
+  job->SetErrorMessage(abortedError);
+  start(job);
+  // The job could have been blocking the others
+  wakeup();
+}
+
+// Any thread, called every time a Dataset lock is released
+void AsyncScheduler::wakeup() {
+  if (handle != nullptr && pending > 0) uv_async_send(handle);
+}
+
+// Any thread, the Datasets do not know to which isolate they belong
+void AsyncScheduler::wakeupAll() {
+  std::lock_guard<std::mutex> lock(registry_lock);
+  for (AsyncScheduler *scheduler : registry) scheduler->wakeup();
+}
+
+void AsyncScheduler::dispatchCallback(uv_async_t *handle) {
+  reinterpret_cast<AsyncScheduler *>(handle->data)->dispatch();
+}
+
+// The order of the queues
+bool AsyncScheduler::before(const GDALAsyncWorkerBase *a, const GDALAsyncWorkerBase *b) {
+  if (a->priority != b->priority) return a->priority > b->priority;
+  return a->seq < b->seq;
+}
+
+bool AsyncScheduler::expired(const GDALAsyncWorkerBase *job) {
+  if (job->deadline <= 0) return false;
+  double now = static_cast<double>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count());
+  return now >= job->deadline;
+}
+
+// A job can be started only if it is the first one in all of its queues
+bool AsyncScheduler::isRunnable(GDALAsyncWorkerBase *job) {
+  for (long uid : job->lock_uids)
+    if (queues[uid].front() != job) return false;
+  return true;
+}
+
+// Acquire all the locks without blocking, on success the job is handed to libuv
+// If a Dataset has been destroyed in the meantime or the deadline has expired,
+// the job is also handed to libuv, it will simply fail with an error
+bool AsyncScheduler::tryStart(GDALAsyncWorkerBase *job) {
+  if (expired(job)) {
+    job->SetErrorMessage(deadlineError);
+    start(job);
+    return true;
+  }
+  try {
+    if (job->pooled && job->lock_uids.size() == 1) {
+      AsyncLock lock = object_store.tryLockPooledDataset(job->lock_uids[0], job->pool_handle);
+      if (lock == nullptr) return false;
+      job->locks = {lock};
+    } else {
+      job->locks = object_store.tryLockDatasets(job->lock_uids);
+      if (job->locks.empty()) return false;
+    }
+  } catch (const char *err) { job->SetErrorMessage(err); }
+  start(job);
+  return true;
+}
+
+// Every job reaches libuv through here
+void AsyncScheduler::start(GDALAsyncWorkerBase *job) {
+  job->started_at = statsNow();
+  job->stats.record(&AsyncStats::queue, job->started_at - job->enqueued_at);
+  Nan::AsyncQueueWorker(job);
+}
+
+// Main thread only, walks the heads of all the queues
+// until no more jobs can be started
+void AsyncScheduler::dispatch() {
+  bool progress = true;
+  while (progress && pending > 0) {
+    progress = false;
+    for (auto q = queues.begin(); q != queues.end();) {
+      if (q->second.empty()) {
+        q = queues.erase(q);
+        continue;
+      }
+      GDALAsyncWorkerBase *job = q->second.front();
+      if (isRunnable(job) && tryStart(job)) {
+        for (long uid : job->lock_uids) queues[uid].pop_front();
+        job->queued = false;
+        if (--pending == 0) uv_unref(reinterpret_cast<uv_handle_t *>(handle));
+        progress = true;
+      }
+      q++;
+    }
+  }
+}
+
 } // namespace node_gdal
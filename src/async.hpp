@@ -4,20 +4,26 @@
 #include <thread>
 #include <functional>
 #include <chrono>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
 #include "nan-wrapper.h"
 #include "gdal_common.hpp"
+#include "utils/async_stats.hpp"
+#include "utils/inline_function.hpp"
 
 namespace node_gdal {
 
-// The id of the main V8 thread
-extern std::thread::id mainV8ThreadId;
-
 // This generates method definitions for 2 methods: sync and async version and a hidden common block
 #define GDAL_ASYNCABLE_DEFINE(method)                                                                                  \
   NAN_METHOD(method) {                                                                                                 \
+    CurrentMethodScope current(#method);                                                                               \
     method##_do(info, false);                                                                                          \
   }                                                                                                                    \
   NAN_METHOD(method##Async) {                                                                                          \
+    CurrentMethodScope current(#method);                                                                               \
     method##_do(info, true);                                                                                           \
   }                                                                                                                    \
   void method##_do(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async)
@@ -25,9 +31,11 @@ extern std::thread::id mainV8ThreadId;
 // This generates getter definitions for 2 getters: sync and async version and a hidden common block
 #define GDAL_ASYNCABLE_GETTER_DEFINE(method)                                                                           \
   NAN_GETTER(method) {                                                                                                 \
+    CurrentMethodScope current(#method);                                                                               \
     method##_do(property, info, false);                                                                                \
   }                                                                                                                    \
   NAN_GETTER(method##Async) {                                                                                          \
+    CurrentMethodScope current(#method);                                                                               \
     method##_do(property, info, true);                                                                                 \
   }                                                                                                                    \
   Nan::NAN_GETTER_RETURN_TYPE method##_do(v8::Local<v8::String> property, Nan::NAN_GETTER_ARGS_TYPE info, bool async)
@@ -52,9 +60,11 @@ extern std::thread::id mainV8ThreadId;
 
 #define GDAL_ASYNCABLE_TEMPLATE(method)                                                                                \
   static NAN_METHOD(method) {                                                                                          \
+    CurrentMethodScope current(#method);                                                                               \
     method##_do(info, false);                                                                                          \
   }                                                                                                                    \
   static NAN_METHOD(method##Async) {                                                                                   \
+    CurrentMethodScope current(#method);                                                                               \
     method##_do(info, true);                                                                                           \
   }                                                                                                                    \
   static void method##_do(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async)
@@ -146,9 +156,54 @@ class GDALSyncExecutionProgress {
   GDALSyncExecutionProgress(Nan::Callback *);
   ~GDALSyncExecutionProgress();
   void Send(GDALProgressInfo *) const;
+  inline bool hasCallback() const {
+    return progress_callback != nullptr;
+  }
 };
 
 typedef std::function<v8::Local<v8::Value>(const char *)> GetFromPersistentFunc;
+
+// The JS objects that must be protected from the GC for the duration of a job
+// The first ones are stored inline, only the named ones can be retrieved by rval()
+class GDALPersistentList {
+    public:
+  struct Entry {
+    std::string key;
+    v8::Local<v8::Object> obj;
+  };
+
+  inline GDALPersistentList() : count(0), overflow() {
+  }
+
+  inline void add(const std::string &key, const v8::Local<v8::Object> &obj) {
+    if (count < inlineSize) {
+      entries[count].key = key;
+      entries[count].obj = obj;
+    } else
+      overflow.push_back({key, obj});
+    count++;
+  }
+
+  inline unsigned size() const {
+    return count;
+  }
+
+  inline const Entry &operator[](unsigned i) const {
+    return i < inlineSize ? entries[i] : overflow[i - inlineSize];
+  }
+
+  inline v8::Local<v8::Value> get(const char *key) const {
+    for (unsigned i = 0; i < count; i++)
+      if ((*this)[i].key == key) return (*this)[i].obj;
+    return v8::Local<v8::Value>();
+  }
+
+    private:
+  static const unsigned inlineSize = 8;
+  unsigned count;
+  Entry entries[inlineSize];
+  std::vector<Entry> overflow;
+};
 typedef Nan::AsyncProgressWorkerBase<GDALProgressInfo> GDALAsyncProgressWorker;
 typedef GDALAsyncProgressWorker::ExecutionProgress GDALAsyncExecutionProgress;
 
@@ -158,14 +213,35 @@ class GDALExecutionProgress {
   // Only one of these is active at any given moment
   const GDALAsyncExecutionProgress *async;
   const GDALSyncExecutionProgress *sync;
+  // The pooled Dataset handle acquired for this job, nullptr for the main handle
+  GDALDataset *handle;
+  // There is a JS progress callback
+  bool reporting;
+  // Set from the main thread when the job is aborted, nullptr if the job cannot be aborted
+  const std::atomic<bool> *abort_flag;
 
   GDALExecutionProgress() = delete;
 
     public:
-  GDALExecutionProgress(const GDALAsyncExecutionProgress *);
+  GDALExecutionProgress(
+    const GDALAsyncExecutionProgress *,
+    GDALDataset *handle,
+    bool reporting,
+    const std::atomic<bool> *abort_flag);
   GDALExecutionProgress(const GDALSyncExecutionProgress *);
   ~GDALExecutionProgress();
   void Send(GDALProgressInfo *info) const;
+  GDALRasterBand *pooledBand(GDALRasterBand *band) const;
+  GDALDataset *pooledDataset(GDALDataset *ds) const;
+  inline bool isReporting() const {
+    return reporting;
+  }
+  inline bool isAborted() const {
+    return abort_flag != nullptr && *abort_flag;
+  }
+  // The GDAL progress function to pass along with this object, nullptr when there is
+  // neither a progress callback nor an AbortSignal
+  GDALProgressFunc trampoline() const;
 };
 
 // This is the progress callback trampoline
@@ -173,6 +249,131 @@ class GDALExecutionProgress {
 // It is essentially a gateway between the GDAL world and Node.js/V8 world
 int ProgressTrampoline(double dfComplete, const char *pszMessage, void *pProgressArg);
 
+// The error messages of the aborted and the expired jobs
+extern const char abortedError[];
+extern const char deadlineError[];
+
+// The optional last argument of all native async methods, it is read from the
+// position right after the callback (cb_arg + 1)
+// In the public JS API it is the last argument before the callback, the wrapper
+// in lib/gdal.js moves it after the callback when calling the native method
+// It can be either an AbortSignal or an object with these properties
+struct GDALAsyncOptions {
+  v8::Local<v8::Object> signal;
+  // Higher priority jobs are started first, the default is 0
+  int priority;
+  // Milliseconds since the epoch, 0 for no deadline
+  double deadline;
+  GDALAsyncOptions() : signal(), priority(0), deadline(0) {
+  }
+};
+
+// Returns false and throws a JS exception if the options are not valid
+bool parseAsyncOptions(v8::Local<v8::Value> arg, GDALAsyncOptions &options);
+
+// This is the non-templated base class of all async workers
+// It is the unit of work that the AsyncScheduler manipulates
+//
+// It carries the list of Datasets that must be locked before the job
+// can start and, once the scheduler has acquired them, the locks themselves
+//
+class GDALAsyncWorkerBase : public GDALAsyncProgressWorker {
+    public:
+  GDALAsyncWorkerBase(Nan::Callback *resultCallback, std::vector<long> &&ds_uids);
+  // Workers are created and destroyed on the main thread, their memory is recycled
+  static void *operator new(size_t size);
+  static void operator delete(void *p, size_t size);
+  // The job can run on any handle of a pooled Dataset
+  bool pooled;
+  void setOptions(const GDALAsyncOptions &options);
+  // Cancellation through an AbortSignal, main thread only
+  void attachSignal(v8::Local<v8::Object> signal);
+  void abort();
+  void WorkComplete();
+
+    protected:
+  std::atomic<bool> aborted;
+  bool abortable;
+  bool listening;
+  // Waiting in the queues of the AsyncScheduler
+  bool queued;
+  int priority;
+  double deadline;
+  // Order of arrival, breaks the ties between jobs of the same priority
+  uint64_t seq;
+  // Telemetry, the timestamps are in µs
+  StatsRecorder stats;
+  uint64_t enqueued_at;
+  uint64_t started_at;
+  static NAN_METHOD(abortListener);
+
+  // Sorted, deduplicated and without 0s
+  std::vector<long> lock_uids;
+  // Acquired by the scheduler on the main thread, released by Execute in the worker thread
+  std::vector<AsyncLock> locks;
+  // The acquired pooled handle, nullptr for the main handle
+  GDALDataset *pool_handle;
+  void releaseLocks();
+
+  friend class AsyncScheduler;
+};
+
+//
+// The async job scheduler (a singleton)
+//
+// Every async job goes through here before reaching the libuv thread pool
+// Each Dataset has its own queue of pending jobs and a job is handed
+// to libuv only once it is at the head of the queues of all of its Datasets
+// and all of its locks have been acquired without blocking
+//
+// The queues are ordered by priority and then by order of arrival, as this
+// order is the same for all the queues, there is always a job at the head
+// of all of its queues and the scheduling cannot deadlock
+//
+// A job whose deadline has expired is failed instead of being started
+//
+// This way a libuv thread never sleeps on a Dataset lock and a long queue
+// of jobs on one Dataset cannot starve the jobs on the other Datasets
+// (see ASYNCIO.md)
+//
+// The queues live on the main thread, the worker threads can only
+// request a new dispatching pass through wakeup()
+//
+// Every V8 isolate (the main one and those of the worker_threads) has its own
+// scheduler running on its own event loop, a released Dataset lock wakes up
+// all of them through wakeupAll()
+//
+class AsyncScheduler {
+    public:
+  AsyncScheduler();
+  void initialize();
+  void shutdown();
+  void enqueue(GDALAsyncWorkerBase *job);
+  void cancel(GDALAsyncWorkerBase *job);
+  void wakeup();
+  static void wakeupAll();
+
+    private:
+  std::map<long, std::deque<GDALAsyncWorkerBase *>> queues;
+  std::atomic<size_t> pending;
+  uv_async_t *handle;
+  uint64_t sequence;
+
+  static std::mutex registry_lock;
+  static std::vector<AsyncScheduler *> registry;
+
+  static void dispatchCallback(uv_async_t *handle);
+  void dispatch();
+  bool isRunnable(GDALAsyncWorkerBase *job);
+  static bool before(const GDALAsyncWorkerBase *a, const GDALAsyncWorkerBase *b);
+  static bool expired(const GDALAsyncWorkerBase *job);
+  bool tryStart(GDALAsyncWorkerBase *job);
+  void start(GDALAsyncWorkerBase *job);
+};
+
+// The scheduler of the current isolate
+extern thread_local AsyncScheduler async_scheduler;
+
 //
 // This is the common class for handling async operations
 // It has two subclasses: GDALCallbackWorker and GDALPromiseWorker
@@ -185,26 +386,25 @@ int ProgressTrampoline(double dfComplete, const char *pszMessage, void *pProgres
 // JS-visible object creation is possible only in the main thread while
 // ths JS world is not running
 //
-template <class GDALType> class GDALAsyncWorker : public GDALAsyncProgressWorker {
+template <class GDALType> class GDALAsyncWorker : public GDALAsyncWorkerBase {
     public:
-  typedef std::function<GDALType(const GDALExecutionProgress &)> GDALMainFunc;
-  typedef std::function<v8::Local<v8::Value>(const GDALType, const GetFromPersistentFunc &)> GDALRValFunc;
+  typedef InlineFunction<GDALType(const GDALExecutionProgress &)> GDALMainFunc;
+  typedef InlineFunction<v8::Local<v8::Value>(const GDALType, const GetFromPersistentFunc &)> GDALRValFunc;
 
     private:
   Nan::Callback *progressCallback;
   const GDALMainFunc doit;
   const GDALRValFunc rval;
-  const std::vector<long> ds_uids;
   GDALType raw;
 
     public:
   explicit GDALAsyncWorker(
     Nan::Callback *resultCallback,
     Nan::Callback *progressCallback,
-    const GDALMainFunc &doit,
-    const GDALRValFunc &rval,
-    const std::map<std::string, v8::Local<v8::Object>> &objects,
-    const std::vector<long> &ds_uids);
+    GDALMainFunc &&doit,
+    GDALRValFunc &&rval,
+    const GDALPersistentList &objects,
+    std::vector<long> &&ds_uids);
 
   ~GDALAsyncWorker();
 
@@ -217,36 +417,55 @@ template <class GDALType>
 GDALAsyncWorker<GDALType>::GDALAsyncWorker(
   Nan::Callback *resultCallback,
   Nan::Callback *progressCallback,
-  const GDALMainFunc &doit,
-  const GDALRValFunc &rval,
-  const std::map<std::string, v8::Local<v8::Object>> &objects,
-  const std::vector<long> &ds_uids)
-  : GDALAsyncProgressWorker(resultCallback, "node-gdal:GDALAsyncWorker"),
+  GDALMainFunc &&doit,
+  GDALRValFunc &&rval,
+  const GDALPersistentList &objects,
+  std::vector<long> &&ds_uids)
+  : GDALAsyncWorkerBase(resultCallback, std::move(ds_uids)),
     progressCallback(progressCallback),
-    // These members are not references! These functions must be copied
-    // as they will be executed in async context!
-    doit(doit),
-    rval(rval),
-    ds_uids(ds_uids) {
+    // These members are not references! These functions are moved
+    // from the job as they will be executed in async context!
+    doit(std::move(doit)),
+    rval(std::move(rval)) {
   // Main thread with the JS world is not running
-  // Get persistent handles
-  for (auto i = objects.begin(); i != objects.end(); i++) SaveToPersistent(i->first.c_str(), i->second);
-  for (auto i = ds_uids.begin(); i != ds_uids.end(); i++)
-    if (*i != 0) SaveToPersistent(("ds" + std::to_string(*i)).c_str(), object_store.get<GDALDataset *>(*i));
+  // Get persistent handles, the unnamed ones are stored by index
+  uint32_t index = 0;
+  for (unsigned i = 0; i < objects.size(); i++) {
+    if (objects[i].key.empty())
+      SaveToPersistent(index++, objects[i].obj);
+    else
+      SaveToPersistent(objects[i].key.c_str(), objects[i].obj);
+  }
+  for (long uid : this->lock_uids) SaveToPersistent(index++, object_store.get<GDALDataset *>(uid));
 }
 
 template <class GDALType> Local<Value> GDALAsyncWorker<GDALType>::ProduceRVal() {
-  return rval(raw, [this](const char *key) { return this->GetFromPersistent(key); });
+  uint64_t start = statsNow();
+  Local<Value> r = rval(raw, [this](const char *key) { return this->GetFromPersistent(key); });
+  this->stats.record(&AsyncStats::rval, statsNow() - start);
+  return r;
 }
 
 template <class GDALType> void GDALAsyncWorker<GDALType>::Execute(const ExecutionProgress &progress) {
   // Aux thread with the JS world running
   // V8 objects are not acessible here
-  try {
-    GDALExecutionProgress executionProgress(&progress);
-    AsyncGuard lock(ds_uids);
-    raw = doit(executionProgress);
-  } catch (const char *err) { this->SetErrorMessage(err); }
+  // The scheduler has already acquired all the locks or it has
+  // failed to do so because one of the Datasets has been destroyed
+  uint64_t executed_at = statsNow();
+  this->stats.record(&AsyncStats::pool, executed_at - this->started_at);
+  if (this->ErrorMessage() == nullptr) {
+    try {
+      GDALExecutionProgress executionProgress(
+        &progress, this->pool_handle, progressCallback != nullptr, this->abortable ? &this->aborted : nullptr);
+      raw = doit(executionProgress);
+    } catch (const char *err) { this->SetErrorMessage(err); }
+    this->stats.record(&AsyncStats::execute, statsNow() - executed_at);
+    // An operation interrupted by the abort fails with the abort error
+    // A completed one delivers its result, its side effects have already happened
+    // and rval() is the only place where the <GDALType> object can be freed
+    if (this->aborted && this->ErrorMessage() != nullptr) this->SetErrorMessage(abortedError);
+  }
+  this->releaseLocks();
 }
 
 template <class GDALType> GDALAsyncWorker<GDALType>::~GDALAsyncWorker() {
@@ -287,7 +506,15 @@ template <class GDALType> void GDALCallbackWorker<GDALType>::HandleOKCallback()
   // rval is the user function that will create the returned value
   // we give it a lambda that can access the persistent storage created for this operation
   // It uses our HandleScope so it can return a Local without escaping
-  v8::Local<v8::Value> argv[] = {Nan::Null(), this->ProduceRVal()};
+  v8::Local<v8::Value> r;
+  try {
+    r = this->ProduceRVal();
+  } catch (const char *err) {
+    v8::Local<v8::Value> argv[] = {Nan::Error(err)};
+    this->callback->Call(1, argv, this->async_resource);
+    return;
+  }
+  v8::Local<v8::Value> argv[] = {Nan::Null(), r};
   this->callback->Call(2, argv, this->async_resource);
 }
 
@@ -311,10 +538,10 @@ template <class GDALType> class GDALPromiseWorker : public GDALAsyncWorker<GDALT
     public:
   explicit GDALPromiseWorker(
     Nan::NAN_GETTER_ARGS_TYPE info,
-    const GDALMainFunc &doit,
-    const GDALRValFunc &rval,
-    const std::map<std::string, v8::Local<v8::Object>> &objects,
-    const std::vector<long> &ds_uids);
+    GDALMainFunc &&doit,
+    GDALRValFunc &&rval,
+    const GDALPersistentList &objects,
+    std::vector<long> &&ds_uids);
 
   ~GDALPromiseWorker();
 
@@ -328,11 +555,11 @@ template <class GDALType> class GDALPromiseWorker : public GDALAsyncWorker<GDALT
 template <class GDALType>
 GDALPromiseWorker<GDALType>::GDALPromiseWorker(
   Nan::NAN_GETTER_ARGS_TYPE info,
-  const GDALMainFunc &doit,
-  const GDALRValFunc &rval,
-  const std::map<std::string, v8::Local<v8::Object>> &objects,
-  const std::vector<long> &ds_uids)
-  : GDALAsyncWorker<GDALType>(nullptr, nullptr, doit, rval, objects, ds_uids) {
+  GDALMainFunc &&doit,
+  GDALRValFunc &&rval,
+  const GDALPersistentList &objects,
+  std::vector<long> &&ds_uids)
+  : GDALAsyncWorker<GDALType>(nullptr, nullptr, std::move(doit), std::move(rval), objects, std::move(ds_uids)) {
   auto context = info.GetIsolate()->GetCurrentContext();
   context_handle = new Nan::Persistent<v8::Context>(context);
   auto resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
@@ -343,7 +570,9 @@ template <class GDALType> void GDALPromiseWorker<GDALType>::HandleOKCallback() {
   Nan::HandleScope scope;
   v8::Local<v8::Context> context = Nan::New(*context_handle);
   v8::Local<v8::Promise::Resolver> resolver = Nan::New(*resolver_handle);
-  resolver->Resolve(context, this->ProduceRVal()).FromJust();
+  try {
+    resolver->Resolve(context, this->ProduceRVal()).FromJust();
+  } catch (const char *err) { resolver->Reject(context, Nan::Error(err)).FromJust(); }
 }
 
 template <class GDALType> void GDALPromiseWorker<GDALType>::HandleErrorCallback() {
@@ -377,6 +606,8 @@ template <class GDALType> GDALPromiseWorker<GDALType>::~GDALPromiseWorker() {
 // * protecting all JS-visible objects from the GC by calling persist() (V8 MM)
 // * locking all GDALDatasets (GDAL limitation)
 //
+// rval() can fail by throwing a const char *, it must then free the <GDALType> object
+//
 // If a GDALDataset is locked, but not persisted, the GC could still
 // try to free it - in this case it will stop the JS world and then it will wait
 // on the Dataset lock in PtrManager::dispose() blocking the event loop - the situation
@@ -384,24 +615,29 @@ template <class GDALType> GDALPromiseWorker<GDALType>::~GDALPromiseWorker() {
 
 template <class GDALType> class GDALAsyncableJob {
     public:
-  typedef std::function<GDALType(const GDALExecutionProgress &)> GDALMainFunc;
-  typedef std::function<v8::Local<v8::Value>(const GDALType, const GetFromPersistentFunc &)> GDALRValFunc;
+  typedef InlineFunction<GDALType(const GDALExecutionProgress &)> GDALMainFunc;
+  typedef InlineFunction<v8::Local<v8::Value>(const GDALType, const GetFromPersistentFunc &)> GDALRValFunc;
   // This is the lambda that produces the <GDALType> object
   GDALMainFunc main;
   // This is the lambda that produces the JS return object from the <GDALType> object
   GDALRValFunc rval;
   Nan::Callback *progress;
+  // This job only reads from a single Dataset and can run on any of its handles
+  // main() must then obtain its bands through GDALExecutionProgress::pooledBand
+  // or GDALExecutionProgress::pooledDataset
+  bool pooled;
 
-  GDALAsyncableJob(long ds_uid) : main(), rval(), progress(nullptr), persistent(), ds_uids({ds_uid}), autoIndex(0){};
+  GDALAsyncableJob(long ds_uid)
+    : main(), rval(), progress(nullptr), pooled(false), persistent(), ds_uids({ds_uid}){};
   GDALAsyncableJob(std::vector<long> ds_uids)
-    : main(), rval(), progress(nullptr), persistent(), ds_uids(ds_uids), autoIndex(0){};
+    : main(), rval(), progress(nullptr), pooled(false), persistent(), ds_uids(ds_uids){};
 
   inline void persist(const std::string &key, const v8::Local<v8::Object> &obj) {
-    persistent[key] = obj;
+    persistent.add(key, obj);
   }
 
   inline void persist(const v8::Local<v8::Object> &obj) {
-    persistent[std::to_string(autoIndex++)] = obj;
+    persistent.add(std::string(), obj);
   }
 
   inline void persist(const v8::Local<v8::Object> &obj1, const v8::Local<v8::Object> &obj2) {
@@ -416,44 +652,59 @@ template <class GDALType> class GDALAsyncableJob {
   void run(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async, int cb_arg) {
     if (!info.This().IsEmpty() && info.This()->IsObject()) persist("this", info.This());
     if (async) {
-      if (progress) persist("progress_cb", progress->GetFunction());
+      if (progress) persist(progress->GetFunction());
+      GDALAsyncOptions options;
+      if (!parseAsyncOptions(info[cb_arg + 1], options)) return;
       Nan::Callback *callback;
       NODE_ARG_CB(cb_arg, "callback", callback);
-      Nan::AsyncQueueWorker(new GDALCallbackWorker<GDALType>(callback, progress, main, rval, persistent, ds_uids));
+      auto worker = new GDALCallbackWorker<GDALType>(
+        callback, progress, std::move(main), std::move(rval), persistent, std::move(ds_uids));
+      worker->pooled = pooled;
+      worker->setOptions(options);
+      async_scheduler.enqueue(worker);
       return;
     }
-    try {
-      GDALExecutionProgress executionProgress(new GDALSyncExecutionProgress(progress));
-      AsyncGuard lock(ds_uids, eventLoopWarn);
-      GDALType obj = main(executionProgress);
-      // rval is the user function that will create the returned value
-      // we give it a lambda that can access the persistent storage created for this operation
-      info.GetReturnValue().Set(rval(obj, [this](const char *key) { return this->persistent[key]; }));
-    } catch (const char *err) { Nan::ThrowError(err); }
+    runSync(info.GetReturnValue());
   }
 
   void run(Nan::NAN_GETTER_ARGS_TYPE info, bool async) {
     if (!info.This().IsEmpty() && info.This()->IsObject()) persist("this", info.This());
     if (async) {
-      auto worker = new GDALPromiseWorker<GDALType>(info, main, rval, persistent, ds_uids);
+      auto worker =
+        new GDALPromiseWorker<GDALType>(info, std::move(main), std::move(rval), persistent, std::move(ds_uids));
+      worker->pooled = pooled;
       info.GetReturnValue().Set(worker->Promise());
-      Nan::AsyncQueueWorker(worker);
+      async_scheduler.enqueue(worker);
       return;
     }
+    runSync(info.GetReturnValue());
+  }
+
+    private:
+  GDALPersistentList persistent;
+  std::vector<long> ds_uids;
+
+  void runSync(Nan::ReturnValue<v8::Value> returnValue) {
+    StatsRecorder stats(ds_uids);
     try {
       GDALExecutionProgress executionProgress(new GDALSyncExecutionProgress(progress));
+      uint64_t start = statsNow();
       AsyncGuard lock(ds_uids, eventLoopWarn);
+      uint64_t locked = statsNow();
+      stats.record(&AsyncStats::lock, locked - start);
       GDALType obj = main(executionProgress);
+      uint64_t executed = statsNow();
+      stats.record(&AsyncStats::execute, executed - locked);
       // rval is the user function that will create the returned value
       // we give it a lambda that can access the persistent storage created for this operation
-      info.GetReturnValue().Set(rval(obj, [this](const char *key) { return this->persistent[key]; }));
-    } catch (const char *err) { Nan::ThrowError(err); }
+      returnValue.Set(rval(obj, [this](const char *key) { return this->persistent.get(key); }));
+      stats.record(&AsyncStats::rval, statsNow() - executed);
+      stats.complete(false);
+    } catch (const char *err) {
+      stats.complete(true);
+      Nan::ThrowError(err);
+    }
   }
-
-    private:
-  std::map<std::string, v8::Local<v8::Object>> persistent;
-  const std::vector<long> ds_uids;
-  unsigned autoIndex;
 };
 } // namespace node_gdal
 #endif
@@ -25,7 +25,7 @@ namespace node_gdal {
 class ArrayAttributes : public GroupCollection<ArrayAttributes, GDALAttribute, GDALMDArray, Attribute, MDArray> {
     public:
   static constexpr const char *_className = "ArrayAttributes";
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static std::shared_ptr<GDALAttribute> __get(std::shared_ptr<GDALMDArray> parent, std::string const &name);
   static std::shared_ptr<GDALAttribute> __get(std::shared_ptr<GDALMDArray> parent, size_t idx);
   static std::vector<std::string> __getNames(std::shared_ptr<GDALMDArray> parent);
@@ -25,7 +25,7 @@ namespace node_gdal {
 class ArrayDimensions : public GroupCollection<ArrayDimensions, GDALDimension, GDALMDArray, Dimension, MDArray> {
     public:
   static constexpr const char *_className = "ArrayDimensions";
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static int __getIdx(std::shared_ptr<GDALMDArray> parent, std::string const &name);
   static std::shared_ptr<GDALDimension> __get(std::shared_ptr<GDALMDArray> parent, std::string const &name);
   static std::shared_ptr<GDALDimension> __get(std::shared_ptr<GDALMDArray> parent, size_t idx);
@@ -7,7 +7,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> ColorTable::constructor;
+thread_local Nan::Persistent<FunctionTemplate> ColorTable::constructor;
 
 void ColorTable::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -91,6 +91,10 @@ NAN_METHOD(ColorTable::New) {
 
   f->Wrap(info.This());
   f->uid = object_store.add(f->get(), f->persistent(), f->parent_uid);
+  if (f->uid == 0) {
+    Nan::ThrowError("Parent Dataset object has already been destroyed");
+    return;
+  }
   info.GetReturnValue().Set(info.This());
   return;
 }
@@ -109,8 +113,10 @@ Local<Value> ColorTable::New(GDALColorTable *raw, Local<Value> parent) {
   ColorTable *wrapped = new ColorTable(raw, band->parent_uid);
 
   v8::Local<v8::Value> ext = Nan::New<External>(wrapped);
-  v8::Local<v8::Object> obj =
-    Nan::NewInstance(Nan::GetFunction(Nan::New(ColorTable::constructor)).ToLocalChecked(), 1, &ext).ToLocalChecked();
+  v8::Local<v8::Object> obj;
+  // The constructor throws if the parent Dataset has been destroyed
+  if (!Nan::NewInstance(Nan::GetFunction(Nan::New(ColorTable::constructor)).ToLocalChecked(), 1, &ext).ToLocal(&obj))
+    return scope.Escape(Nan::Undefined());
 
   Nan::SetPrivate(obj, Nan::New("parent_").ToLocalChecked(), parent);
 
@@ -7,7 +7,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> CompoundCurveCurves::constructor;
+thread_local Nan::Persistent<FunctionTemplate> CompoundCurveCurves::constructor;
 
 void CompoundCurveCurves::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
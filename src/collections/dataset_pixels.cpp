@@ -0,0 +1,547 @@
+#include "dataset_pixels.hpp"
+#include "rasterband_pixels.hpp"
+#include "../gdal_common.hpp"
+#include "../gdal_dataset.hpp"
+#include "../async.hpp"
+#include "../utils/typed_array.hpp"
+
+#include <climits>
+#include <memory>
+
+namespace node_gdal {
+
+thread_local Nan::Persistent<FunctionTemplate> DatasetPixels::constructor;
+
+void DatasetPixels::Initialize(Local<Object> target) {
+  Nan::HandleScope scope;
+
+  Local<FunctionTemplate> lcons = Nan::New<FunctionTemplate>(DatasetPixels::New);
+  lcons->InstanceTemplate()->SetInternalFieldCount(1);
+  lcons->SetClassName(Nan::New("DatasetPixels").ToLocalChecked());
+
+  Nan::SetPrototypeMethod(lcons, "toString", toString);
+  Nan__SetPrototypeAsyncableMethod(lcons, "read", read);
+  Nan__SetPrototypeAsyncableMethod(lcons, "write", write);
+
+  ATTR_DONT_ENUM(lcons, "ds", dsGetter, READ_ONLY_SETTER);
+
+  Nan::Set(target, Nan::New("DatasetPixels").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
+
+  constructor.Reset(lcons);
+}
+
+DatasetPixels::DatasetPixels() : Nan::ObjectWrap() {
+}
+
+DatasetPixels::~DatasetPixels() {
+}
+
+Dataset *DatasetPixels::parent(const Nan::FunctionCallbackInfo<v8::Value> &info) {
+  Local<Object> parent =
+    Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+  Dataset *ds = Nan::ObjectWrap::Unwrap<Dataset>(parent);
+  if (!ds->isAlive()) {
+    Nan::ThrowError("Dataset object has already been destroyed");
+    return nullptr;
+  }
+  return ds;
+}
+
+/**
+ * A representation of the pixels of several {@link RasterBand}s of a {@link Dataset}
+ * read or written in a single operation.
+ *
+ * Reading several bands at once is much faster than reading them one by one when
+ * the file is pixel-interleaved (RGB(A) GeoTIFFs, JPEG, PNG, WEBP...) as each block
+ * is decoded only once.
+ *
+ * @example
+ * // read an RGBA tile as a single pixel-interleaved array
+ * const rgba = await ds.pixels.readAsync(0, 0, 256, 256, undefined, { bands: [1, 2, 3, 4], interleave: 'pixel' });
+ *
+ * @class DatasetPixels
+ */
+NAN_METHOD(DatasetPixels::New) {
+
+  if (!info.IsConstructCall()) {
+    Nan::ThrowError("Cannot call constructor as function, you need to use 'new' keyword");
+    return;
+  }
+  if (info[0]->IsExternal()) {
+    Local<External> ext = info[0].As<External>();
+    void *ptr = ext->Value();
+    DatasetPixels *f = static_cast<DatasetPixels *>(ptr);
+    f->Wrap(info.This());
+    info.GetReturnValue().Set(info.This());
+    return;
+  } else {
+    Nan::ThrowError("Cannot create DatasetPixels directly");
+    return;
+  }
+}
+
+Local<Value> DatasetPixels::New(Local<Value> ds_obj) {
+  Nan::EscapableHandleScope scope;
+
+  DatasetPixels *wrapped = new DatasetPixels();
+
+  v8::Local<v8::Value> ext = Nan::New<External>(wrapped);
+  v8::Local<v8::Object> obj =
+    Nan::NewInstance(Nan::GetFunction(Nan::New(DatasetPixels::constructor)).ToLocalChecked(), 1, &ext)
+      .ToLocalChecked();
+  Nan::SetPrivate(obj, Nan::New("parent_").ToLocalChecked(), ds_obj);
+
+  return scope.Escape(obj);
+}
+
+NAN_METHOD(DatasetPixels::toString) {
+  info.GetReturnValue().Set(Nan::New("DatasetPixels").ToLocalChecked());
+}
+
+// The list of bands, all the bands of the Dataset by default
+static std::shared_ptr<std::vector<int>> parseBands(Local<Value> value, GDALDataset *raw) {
+  auto bands = std::make_shared<std::vector<int>>();
+  int count = raw->GetRasterCount();
+  if (value->IsUndefined() || value->IsNull()) {
+    for (int i = 1; i <= count; i++) bands->push_back(i);
+  } else {
+    if (!value->IsArray()) throw "bands must be an array";
+    Local<Array> list = value.As<Array>();
+    for (unsigned i = 0; i < list->Length(); i++) {
+      Local<Value> id = Nan::Get(list, i).ToLocalChecked();
+      if (!id->IsInt32()) throw "bands must be an array of band numbers";
+      bands->push_back(Nan::To<int32_t>(id).ToChecked());
+      if (bands->back() < 1 || bands->back() > count) throw "Invalid band number";
+    }
+  }
+  if (bands->empty()) throw "No raster bands";
+  return bands;
+}
+
+// Pixel interleaving (RGBRGB...) is the default as this is what the image encoders expect
+static bool parsePixelInterleave(Local<Value> value) {
+  if (value->IsUndefined() || value->IsNull()) return true;
+  if (!value->IsString()) throw "interleave must be a string";
+  std::string interleave = *Nan::Utf8String(value);
+  if (interleave == "pixel") return true;
+  if (interleave == "band") return false;
+  throw "interleave must be either \"pixel\" or \"band\"";
+}
+
+// The number of elements spanned by a multi-band buffer, offset is in elements and the spaces are in bytes
+static int findLength(
+  int w, int h, int bands, GSpacing pixel_space, GSpacing line_space, GSpacing band_space, int offset, int size) {
+  int64_t lowest = static_cast<int64_t>(offset) * size;
+  int64_t highest = lowest;
+  for (auto dim : {std::make_pair(w, pixel_space), std::make_pair(h, line_space), std::make_pair(bands, band_space)}) {
+    int64_t span = static_cast<int64_t>(dim.first - 1) * dim.second;
+    if (span < 0)
+      lowest += span;
+    else
+      highest += span;
+  }
+  if (lowest < 0) throw "has to access memory before the start of the TypedArray";
+  int64_t length = (highest + size + size - 1) / size;
+  if (length > INT_MAX) throw "Buffer is too large";
+  return static_cast<int>(length);
+}
+
+/**
+ * @typedef {object} DatasetReadOptions
+ * @memberof DatasetPixels
+ * @property {number[]} [bands]
+ * @property {string} [interleave]
+ * @property {number} [buffer_width]
+ * @property {number} [buffer_height]
+ * @property {string} [type]
+ * @property {number} [pixel_space]
+ * @property {number} [line_space]
+ * @property {number} [band_space]
+ * @property {string} [resampling]
+ * @property {ProgressCb} [progress_cb]
+ * @property {number} [offset]
+ * @property {BufferPool} [pool]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
+ */
+
+/**
+ * Reads a region of pixels of several bands into a single array.
+ *
+ * @method read
+ * @instance
+ * @memberof DatasetPixels
+ * @throws Error
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {TypedArray} [data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {DatasetReadOptions} [options]
+ * @param {number[]} [options.bands] The band numbers, all the bands by default
+ * @param {string} [options.interleave=pixel] `pixel` (RGBRGB...) or `band` (RRR...GGG...BBB...)
+ * @param {number} [options.buffer_width=x_size]
+ * @param {number} [options.buffer_height=y_size]
+ * @param {string} [options.type] See {@link GDT|GDT constants}, the type of the first band by default
+ * @param {number} [options.pixel_space] Overrides the value implied by `interleave`
+ * @param {number} [options.line_space] Overrides the value implied by `interleave`
+ * @param {number} [options.band_space] Overrides the value implied by `interleave`
+ * @param {string} [options.resampling] Resampling algorithm ({@link GRA|available options})
+ * @param {ProgressCb} [options.progress_cb]
+ * @param {BufferPool} [options.pool] Take the array from this pool when `data` is not given
+ * @return {TypedArray} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
+ */
+
+/**
+ * Asynchronously reads a region of pixels of several bands into a single array.
+ * @async
+ *
+ * @method readAsync
+ * @instance
+ * @memberof DatasetPixels
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {TypedArray} [data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {DatasetReadOptions} [options]
+ * @param {number[]} [options.bands] The band numbers, all the bands by default
+ * @param {string} [options.interleave=pixel] `pixel` (RGBRGB...) or `band` (RRR...GGG...BBB...)
+ * @param {number} [options.buffer_width=x_size]
+ * @param {number} [options.buffer_height=y_size]
+ * @param {string} [options.type] See {@link GDT|GDT constants}, the type of the first band by default
+ * @param {number} [options.pixel_space] Overrides the value implied by `interleave`
+ * @param {number} [options.line_space] Overrides the value implied by `interleave`
+ * @param {number} [options.band_space] Overrides the value implied by `interleave`
+ * @param {string} [options.resampling] Resampling algorithm ({@link GRA|available options})
+ * @param {ProgressCb} [options.progress_cb]
+ * @param {BufferPool} [options.pool] Take the array from this pool when `data` is not given
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
+ * @param {callback<TypedArray>} [callback=undefined]
+ * @return {Promise<TypedArray>} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
+ */
+GDAL_ASYNCABLE_DEFINE(DatasetPixels::read) {
+
+  Dataset *ds;
+  if ((ds = parent(info)) == nullptr) return;
+  GDALDataset *raw = ds->get();
+
+  int x, y, w, h;
+  int buffer_w, buffer_h;
+  int bytes_per_pixel;
+  GSpacing pixel_space, line_space, band_space;
+  int length, offset;
+  void *data;
+  Local<Object> obj;
+  Nan::Callback *cb = nullptr;
+  GDALDataType type;
+  std::shared_ptr<std::vector<int>> bands;
+  bool pixel_interleave;
+  GDALRIOResampleAlg resampling;
+
+  NODE_ARG_INT(0, "x_offset", x);
+  NODE_ARG_INT(1, "y_offset", y);
+  NODE_ARG_INT(2, "x_size", w);
+  NODE_ARG_INT(3, "y_size", h);
+
+  try {
+    bands = parseBands(info[5], raw);
+    pixel_interleave = parsePixelInterleave(info[6]);
+    resampling = parseResamplingAlg(info[13]);
+  } catch (const char *e) {
+    Nan::ThrowError(e);
+    return;
+  }
+
+  std::string type_name = "";
+  buffer_w = w;
+  buffer_h = h;
+  type = raw->GetRasterBand((*bands)[0])->GetRasterDataType();
+  NODE_ARG_INT_OPT(7, "buffer_width", buffer_w);
+  NODE_ARG_INT_OPT(8, "buffer_height", buffer_h);
+  NODE_ARG_OPT_STR(9, "type", type_name);
+  if (!type_name.empty()) { type = GDALGetDataTypeByName(type_name.c_str()); }
+
+  if (!info[4]->IsUndefined() && !info[4]->IsNull()) {
+    NODE_ARG_OBJECT(4, "data", obj);
+    type = TypedArray::Identify(obj);
+    if (type == GDT_Unknown) {
+      Nan::ThrowError("Invalid array");
+      return;
+    }
+  }
+
+  int nbands = static_cast<int>(bands->size());
+  bytes_per_pixel = GDALGetDataTypeSize(type) / 8;
+  if (pixel_interleave) {
+    pixel_space = bytes_per_pixel * nbands;
+    band_space = bytes_per_pixel;
+  } else {
+    pixel_space = bytes_per_pixel;
+    band_space = static_cast<GSpacing>(bytes_per_pixel) * buffer_w * buffer_h;
+  }
+  NODE_ARG_INT_OPT(10, "pixel_space", pixel_space);
+  line_space = pixel_space * buffer_w;
+  NODE_ARG_INT_OPT(11, "line_space", line_space);
+  NODE_ARG_INT_OPT(12, "band_space", band_space);
+  NODE_ARG_CB_OPT(14, "progress_cb", cb);
+  offset = 0;
+  NODE_ARG_INT_OPT(15, "offset", offset);
+
+  try {
+    length = findLength(buffer_w, buffer_h, nbands, pixel_space, line_space, band_space, offset, bytes_per_pixel);
+  } catch (const char *e) {
+    Nan::ThrowError(e);
+    return;
+  }
+
+  // create array if no array was passed
+  if (obj.IsEmpty()) {
+    Local<Value> array = TypedArray::New(type, length);
+    if (array.IsEmpty() || !array->IsObject()) {
+      return; // TypedArray::New threw an error
+    }
+    obj = array.As<Object>();
+  }
+
+  data = TypedArray::Validate(obj, type, length);
+  if (!data) {
+    return; // TypedArray::Validate threw an error
+  }
+
+  GDALAsyncableJob<CPLErr> job(ds->uid);
+  job.persist("array", obj);
+  job.progress = cb;
+  job.pooled = true;
+
+  data = (uint8_t *)data + offset * bytes_per_pixel;
+  job.main =
+    [raw, x, y, w, h, data, buffer_w, buffer_h, type, bands, pixel_space, line_space, band_space, resampling](
+      const GDALExecutionProgress &progress) {
+      GDALRasterIOExtraArg extra;
+      INIT_RASTERIO_EXTRA_ARG(extra);
+      extra.eResampleAlg = resampling;
+      extra.pfnProgress = progress.trampoline();
+      extra.pProgressData = (void *)&progress;
+
+      CPLErrorReset();
+      CPLErr err = progress.pooledDataset(raw)->RasterIO(
+        GF_Read,
+        x,
+        y,
+        w,
+        h,
+        data,
+        buffer_w,
+        buffer_h,
+        type,
+        static_cast<int>(bands->size()),
+        bands->data(),
+        pixel_space,
+        line_space,
+        band_space,
+        &extra);
+
+      if (err != CE_None) throw CPLGetLastErrorMsg();
+      return err;
+    };
+
+  job.rval = [](CPLErr, const GetFromPersistentFunc &getter) { return getter("array"); };
+  job.run(info, async, 16);
+}
+
+/**
+ * @typedef {object} DatasetWriteOptions
+ * @memberof DatasetPixels
+ * @property {number[]} [bands]
+ * @property {string} [interleave]
+ * @property {number} [buffer_width]
+ * @property {number} [buffer_height]
+ * @property {number} [pixel_space]
+ * @property {number} [line_space]
+ * @property {number} [band_space]
+ * @property {ProgressCb} [progress_cb]
+ * @property {number} [offset]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
+ */
+
+/**
+ * Writes a region of pixels of several bands from a single array.
+ *
+ * @method write
+ * @instance
+ * @memberof DatasetPixels
+ * @throws Error
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {TypedArray} data The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to write to the bands.
+ * @param {DatasetWriteOptions} [options]
+ * @param {number[]} [options.bands] The band numbers, all the bands by default
+ * @param {string} [options.interleave=pixel] `pixel` (RGBRGB...) or `band` (RRR...GGG...BBB...)
+ * @param {number} [options.buffer_width=x_size]
+ * @param {number} [options.buffer_height=y_size]
+ * @param {number} [options.pixel_space] Overrides the value implied by `interleave`
+ * @param {number} [options.line_space] Overrides the value implied by `interleave`
+ * @param {number} [options.band_space] Overrides the value implied by `interleave`
+ * @param {ProgressCb} [options.progress_cb]
+ */
+
+/**
+ * Asynchronously writes a region of pixels of several bands from a single array.
+ * @async
+ *
+ * @method writeAsync
+ * @instance
+ * @memberof DatasetPixels
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {TypedArray} data The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to write to the bands.
+ * @param {DatasetWriteOptions} [options]
+ * @param {number[]} [options.bands] The band numbers, all the bands by default
+ * @param {string} [options.interleave=pixel] `pixel` (RGBRGB...) or `band` (RRR...GGG...BBB...)
+ * @param {number} [options.buffer_width=x_size]
+ * @param {number} [options.buffer_height=y_size]
+ * @param {number} [options.pixel_space] Overrides the value implied by `interleave`
+ * @param {number} [options.line_space] Overrides the value implied by `interleave`
+ * @param {number} [options.band_space] Overrides the value implied by `interleave`
+ * @param {ProgressCb} [options.progress_cb]
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
+ * @param {callback<void>} [callback=undefined]
+ * @return {Promise<void>}
+ */
+GDAL_ASYNCABLE_DEFINE(DatasetPixels::write) {
+
+  Dataset *ds;
+  if ((ds = parent(info)) == nullptr) return;
+  GDALDataset *raw = ds->get();
+
+  int x, y, w, h;
+  int buffer_w, buffer_h;
+  int bytes_per_pixel;
+  GSpacing pixel_space, line_space, band_space;
+  int length, offset;
+  void *data;
+  Local<Object> passed_array;
+  GDALDataType type;
+  Nan::Callback *cb = nullptr;
+  std::shared_ptr<std::vector<int>> bands;
+  bool pixel_interleave;
+
+  NODE_ARG_INT(0, "x_offset", x);
+  NODE_ARG_INT(1, "y_offset", y);
+  NODE_ARG_INT(2, "x_size", w);
+  NODE_ARG_INT(3, "y_size", h);
+  NODE_ARG_OBJECT(4, "data", passed_array);
+
+  try {
+    bands = parseBands(info[5], raw);
+    pixel_interleave = parsePixelInterleave(info[6]);
+  } catch (const char *e) {
+    Nan::ThrowError(e);
+    return;
+  }
+
+  buffer_w = w;
+  buffer_h = h;
+  NODE_ARG_INT_OPT(7, "buffer_width", buffer_w);
+  NODE_ARG_INT_OPT(8, "buffer_height", buffer_h);
+
+  type = TypedArray::Identify(passed_array);
+  if (type == GDT_Unknown) {
+    Nan::ThrowError("Invalid array");
+    return;
+  }
+
+  int nbands = static_cast<int>(bands->size());
+  bytes_per_pixel = GDALGetDataTypeSize(type) / 8;
+  if (pixel_interleave) {
+    pixel_space = bytes_per_pixel * nbands;
+    band_space = bytes_per_pixel;
+  } else {
+    pixel_space = bytes_per_pixel;
+    band_space = static_cast<GSpacing>(bytes_per_pixel) * buffer_w * buffer_h;
+  }
+  NODE_ARG_INT_OPT(9, "pixel_space", pixel_space);
+  line_space = pixel_space * buffer_w;
+  NODE_ARG_INT_OPT(10, "line_space", line_space);
+  NODE_ARG_INT_OPT(11, "band_space", band_space);
+  NODE_ARG_CB_OPT(12, "progress_cb", cb);
+  offset = 0;
+  NODE_ARG_INT_OPT(13, "offset", offset);
+
+  try {
+    length = findLength(buffer_w, buffer_h, nbands, pixel_space, line_space, band_space, offset, bytes_per_pixel);
+  } catch (const char *e) {
+    Nan::ThrowError(e);
+    return;
+  }
+
+  data = TypedArray::Validate(passed_array, type, length);
+  if (!data) {
+    return; // TypedArray::Validate threw an error
+  }
+
+  GDALAsyncableJob<CPLErr> job(ds->uid);
+  job.persist("array", passed_array);
+  job.progress = cb;
+
+  data = (uint8_t *)data + offset * bytes_per_pixel;
+  job.main = [raw, x, y, w, h, data, buffer_w, buffer_h, type, bands, pixel_space, line_space, band_space](
+               const GDALExecutionProgress &progress) {
+    GDALRasterIOExtraArg extra;
+    INIT_RASTERIO_EXTRA_ARG(extra);
+    extra.pfnProgress = progress.trampoline();
+    extra.pProgressData = (void *)&progress;
+
+    CPLErrorReset();
+    CPLErr err = raw->RasterIO(
+      GF_Write,
+      x,
+      y,
+      w,
+      h,
+      data,
+      buffer_w,
+      buffer_h,
+      type,
+      static_cast<int>(bands->size()),
+      bands->data(),
+      pixel_space,
+      line_space,
+      band_space,
+      &extra);
+
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+    return err;
+  };
+
+  job.rval = [](CPLErr, const GetFromPersistentFunc &) { return Nan::Undefined().As<Value>(); };
+  job.run(info, async, 14);
+}
+
+/**
+ * Parent dataset
+ *
+ * @readonly
+ * @kind member
+ * @name ds
+ * @instance
+ * @memberof DatasetPixels
+ * @type {Dataset}
+ */
+NAN_GETTER(DatasetPixels::dsGetter) {
+  info.GetReturnValue().Set(Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked());
+}
+
+} // namespace node_gdal
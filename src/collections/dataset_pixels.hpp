@@ -0,0 +1,45 @@
+#ifndef __NODE_GDAL_DATASET_PIXELS_H__
+#define __NODE_GDAL_DATASET_PIXELS_H__
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// nan
+#include "../nan-wrapper.h"
+
+// gdal
+#include <gdal_priv.h>
+
+#include "../gdal_dataset.hpp"
+#include "../async.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+class DatasetPixels : public Nan::ObjectWrap {
+    public:
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
+
+  static void Initialize(Local<Object> target);
+  static NAN_METHOD(New);
+  static Local<Value> New(Local<Value> ds_obj);
+  static NAN_METHOD(toString);
+
+  GDAL_ASYNCABLE_DECLARE(read);
+  GDAL_ASYNCABLE_DECLARE(write);
+
+  static NAN_GETTER(dsGetter);
+
+  static Dataset *parent(const Nan::FunctionCallbackInfo<v8::Value> &info);
+
+  DatasetPixels();
+
+    private:
+  ~DatasetPixels();
+};
+
+} // namespace node_gdal
+#endif
@@ -24,7 +24,7 @@ namespace node_gdal {
 class GroupAttributes : public GroupCollection<GroupAttributes, GDALAttribute, GDALGroup, Attribute, Group> {
     public:
   static constexpr const char *_className = "GroupAttributes";
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static std::shared_ptr<GDALAttribute> __get(std::shared_ptr<GDALGroup> parent, std::string const &name);
   static std::shared_ptr<GDALAttribute> __get(std::shared_ptr<GDALGroup> parent, size_t idx);
   static std::vector<std::string> __getNames(std::shared_ptr<GDALGroup> parent);
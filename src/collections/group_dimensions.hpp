@@ -24,7 +24,7 @@ namespace node_gdal {
 class GroupDimensions : public GroupCollection<GroupDimensions, GDALDimension, GDALGroup, Dimension, Group> {
     public:
   static constexpr const char *_className = "GroupDimensions";
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static std::shared_ptr<GDALDimension> __get(std::shared_ptr<GDALGroup> parent, std::string const &name);
   static std::shared_ptr<GDALDimension> __get(std::shared_ptr<GDALGroup> parent, size_t idx);
   static std::vector<std::string> __getNames(std::shared_ptr<GDALGroup> parent);
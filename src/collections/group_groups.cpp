@@ -9,7 +9,7 @@ namespace node_gdal {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
 
-Nan::Persistent<FunctionTemplate> GroupGroups::constructor;
+thread_local Nan::Persistent<FunctionTemplate> GroupGroups::constructor;
 
 std::shared_ptr<GDALGroup> GroupGroups::__get(std::shared_ptr<GDALGroup> parent, std::string const &name) {
   return parent->OpenGroup(name);
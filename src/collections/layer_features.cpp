@@ -5,7 +5,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LayerFeatures::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LayerFeatures::constructor;
 
 void LayerFeatures::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
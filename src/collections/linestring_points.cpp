@@ -6,7 +6,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LineStringPoints::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LineStringPoints::constructor;
 
 void LineStringPoints::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
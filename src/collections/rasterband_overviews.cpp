@@ -4,7 +4,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> RasterBandOverviews::constructor;
+thread_local Nan::Persistent<FunctionTemplate> RasterBandOverviews::constructor;
 
 void RasterBandOverviews::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
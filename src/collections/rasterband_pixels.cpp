@@ -3,12 +3,20 @@
 #include "../gdal_rasterband.hpp"
 #include "../async.hpp"
 #include "../utils/typed_array.hpp"
+#include "../utils/pinned_block.hpp"
+#include "../utils/pixel_conversion.hpp"
 
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> RasterBandPixels::constructor;
+thread_local Nan::Persistent<FunctionTemplate> RasterBandPixels::constructor;
 
 void RasterBandPixels::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -21,10 +29,13 @@ void RasterBandPixels::Initialize(Local<Object> target) {
   Nan__SetPrototypeAsyncableMethod(lcons, "get", get);
   Nan__SetPrototypeAsyncableMethod(lcons, "set", set);
   Nan__SetPrototypeAsyncableMethod(lcons, "read", read);
+  Nan__SetPrototypeAsyncableMethod(lcons, "readWithMask", readWithMask);
   Nan__SetPrototypeAsyncableMethod(lcons, "write", write);
   Nan__SetPrototypeAsyncableMethod(lcons, "readBlock", readBlock);
   Nan__SetPrototypeAsyncableMethod(lcons, "writeBlock", writeBlock);
   Nan__SetPrototypeAsyncableMethod(lcons, "clampBlock", clampBlock);
+  Nan__SetPrototypeAsyncableMethod(lcons, "lockBlock", lockBlock);
+  Nan__SetPrototypeAsyncableMethod(lcons, "adviseRead", adviseRead);
 
   ATTR_DONT_ENUM(lcons, "band", bandGetter, READ_ONLY_SETTER);
 
@@ -139,11 +150,12 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::get) {
 
   GDALAsyncableJob<double> job(band->parent_uid);
   job.persist(band->handle());
+  job.pooled = band->isPoolable();
 
-  job.main = [raw, x, y](const GDALExecutionProgress &) {
+  job.main = [raw, x, y](const GDALExecutionProgress &progress) {
     double val;
     CPLErrorReset();
-    CPLErr err = raw->RasterIO(GF_Read, x, y, 1, 1, &val, 1, 1, GDT_Float64, 0, 0);
+    CPLErr err = progress.pooledBand(raw)->RasterIO(GF_Read, x, y, 1, 1, &val, 1, 1, GDT_Float64, 0, 0);
     if (err) { throw CPLGetLastErrorMsg(); }
     return val;
   };
@@ -203,7 +215,7 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::set) {
   job.run(info, async, 3);
 }
 
-inline GDALRIOResampleAlg parseResamplingAlg(Local<Value> value) {
+GDALRIOResampleAlg parseResamplingAlg(Local<Value> value) {
   if (value->IsUndefined() || value->IsNull()) { return GRIORA_NearestNeighbour; }
   if (!value->IsString()) { throw "resampling property must be a string"; }
   std::string name = *Nan::Utf8String(value);
@@ -255,6 +267,148 @@ static inline int findHighest(int w, int h, int px, int ln, int offset) {
   return offset + (x * px + y * ln);
 }
 
+// The state shared by the threads of a parallel read
+struct ParallelRead {
+  const GDALExecutionProgress &progress;
+  std::thread::id caller;
+  int height;
+  // The strips, each one with its completed fraction
+  std::vector<std::pair<int, int>> strips;
+  std::unique_ptr<std::atomic<double>[]> complete;
+  std::atomic<size_t> next;
+  std::atomic<bool> failed;
+  std::mutex error_lock;
+  std::string error;
+
+  ParallelRead(const GDALExecutionProgress &progress, int height)
+    : progress(progress), caller(std::this_thread::get_id()), height(height), next(0), failed(false) {
+  }
+};
+
+struct ParallelStrip {
+  ParallelRead *read;
+  size_t strip;
+};
+
+// Every strip reports its own progress, the aggregate is sent to JS
+// only from the calling thread as it is the only one allowed in sync mode
+static int ParallelProgress(double dfComplete, const char *pszMessage, void *pProgressArg) {
+  ParallelStrip *ctx = reinterpret_cast<ParallelStrip *>(pProgressArg);
+  ParallelRead *read = ctx->read;
+  read->complete[ctx->strip] = dfComplete;
+  if (read->progress.isAborted() || read->failed) return 0;
+  if (std::this_thread::get_id() != read->caller || read->progress.trampoline() == nullptr) return 1;
+  double total = 0;
+  for (size_t i = 0; i < read->strips.size(); i++)
+    total += read->complete[i] * (read->strips[i].second - read->strips[i].first);
+  return ProgressTrampoline(total / read->height, pszMessage, (void *)&read->progress);
+}
+
+// Reads the strips until there are none left, on any thread
+static void readStrips(
+  ParallelRead *read,
+  GDALRasterBand *band,
+  int x,
+  int w,
+  uint8_t *data,
+  GDALDataType type,
+  int pixel_space,
+  int line_space,
+  int y) {
+  size_t i;
+  while (!read->failed && (i = read->next++) < read->strips.size()) {
+    int top = read->strips[i].first;
+    int rows = read->strips[i].second - top;
+    ParallelStrip ctx = {read, i};
+    GDALRasterIOExtraArg extra;
+    INIT_RASTERIO_EXTRA_ARG(extra);
+    extra.pfnProgress = ParallelProgress;
+    extra.pProgressData = &ctx;
+
+    CPLErrorReset();
+    CPLErr err = band->RasterIO(
+      GF_Read,
+      x,
+      top,
+      w,
+      rows,
+      data + static_cast<GPtrDiff_t>(top - y) * line_space,
+      w,
+      rows,
+      type,
+      pixel_space,
+      line_space,
+      &extra);
+    if (err != CE_None) {
+      std::lock_guard<std::mutex> lock(read->error_lock);
+      if (!read->failed) read->error = CPLGetLastErrorMsg();
+      read->failed = true;
+    }
+  }
+}
+
+// Splits a read in block-aligned horizontal strips decoded concurrently,
+// each extra thread needs a free handle of a pooled Dataset (see gdal.openPool)
+// The extra handles are acquired without blocking, when there are none,
+// all the strips are read sequentially on the job's own handle
+static CPLErr parallelRasterIO(
+  const GDALExecutionProgress &progress,
+  long ds_uid,
+  GDALRasterBand *gdal_band,
+  int x,
+  int y,
+  int w,
+  int h,
+  void *data,
+  GDALDataType type,
+  int pixel_space,
+  int line_space,
+  int parallel) {
+  ParallelRead read(progress, h);
+  GDALRasterBand *own_band = progress.pooledBand(gdal_band);
+
+  int block_w, block_h;
+  own_band->GetBlockSize(&block_w, &block_h);
+  if (block_h < 1) block_h = 1;
+  int rows = (h + parallel - 1) / parallel;
+  for (int top = y; top < y + h;) {
+    // Cut on the next block boundary, counted from the top of the raster
+    int bottom = ((top + rows + block_h - 1) / block_h) * block_h;
+    if (bottom > y + h) bottom = y + h;
+    read.strips.push_back({top, bottom});
+    top = bottom;
+  }
+  read.complete.reset(new std::atomic<double>[read.strips.size()]);
+  for (size_t i = 0; i < read.strips.size(); i++) read.complete[i] = 0;
+
+  std::vector<AsyncLock> locks;
+  std::vector<std::thread> threads;
+  try {
+    while (threads.size() + 1 < read.strips.size()) {
+      GDALDataset *handle;
+      AsyncLock lock = object_store.tryLockPooledDataset(ds_uid, handle);
+      if (lock == nullptr) break;
+      locks.push_back(lock);
+      GDALRasterBand *band = handle == nullptr ? gdal_band : handle->GetRasterBand(gdal_band->GetBand());
+      threads.emplace_back(
+        readStrips, &read, band, x, w, static_cast<uint8_t *>(data), type, pixel_space, line_space, y);
+    }
+  } catch (const char *) {
+    // The Dataset is being destroyed, it will wait for us
+  }
+  readStrips(&read, own_band, x, w, static_cast<uint8_t *>(data), type, pixel_space, line_space, y);
+  for (auto &t : threads) t.join();
+  if (!locks.empty()) object_store.unlockDatasets(locks);
+
+  if (read.failed) {
+    // Move the error message to this thread
+    if (read.error.empty()) read.error = progress.isAborted() ? abortedError : "Parallel read failed";
+    CPLError(CE_Failure, CPLE_AppDefined, "%s", read.error.c_str());
+    return CE_Failure;
+  }
+  return CE_None;
+}
+
 /**
  * @typedef {Uint8Array | Int16Array | Uint16Array | Int32Array | Uint32Array | Float32Array | Float64Array} TypedArray
  * @memberof RasterBandPixels
@@ -271,6 +425,15 @@ static inline int findHighest(int w, int h, int px, int ln, int offset) {
  * @property {string} [resampling]
  * @property {ProgressCb} [progress_cb]
  * @property {number} [offset]
+ * @property {BufferPool} [pool]
+ * @property {number} [parallel]
+ * @property {boolean} [shared]
+ * @property {boolean} [convertNoData]
+ * @property {number} [noDataTo]
+ * @property {boolean} [unscale]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
  */
 
 /**
@@ -293,6 +456,12 @@ static inline int findHighest(int w, int h, int px, int ln, int offset) {
  * @param {number} [options.line_space]
  * @param {string} [options.resampling] Resampling algorithm ({@link GRA|available options})
  * @param {ProgressCb} [options.progress_cb]
+ * @param {BufferPool} [options.pool] Take the array from this pool when `data` is not given
+ * @param {boolean} [options.shared=false] Allocate the array in a SharedArrayBuffer that can be sent to other worker_threads without copying
+ * @param {number} [options.parallel=1] Split the window in up to this many block-aligned strips read concurrently on the free handles of a Dataset opened with {@link gdal.openPool}, ignored when the buffer size differs from the window size
+ * @param {boolean} [options.convertNoData=false] Replace the NoData value of the band with `noDataTo`, the conversion is done in the worker thread
+ * @param {number} [options.noDataTo=NaN] The value replacing NoData, `NaN` requires a floating point data type
+ * @param {boolean} [options.unscale=false] Apply the scale and the offset of the band to the values (`value * scale + offset`), requires a floating point data type
  * @return {TypedArray} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
  */
 
@@ -316,6 +485,15 @@ static inline int findHighest(int w, int h, int px, int ln, int offset) {
  * @param {number} [options.line_space]
  * @param {string} [options.resampling] Resampling algorithm ({@link GRA|available options}
  * @param {ProgressCb} [options.progress_cb]
+ * @param {BufferPool} [options.pool] Take the array from this pool when `data` is not given
+ * @param {boolean} [options.shared=false] Allocate the array in a SharedArrayBuffer that can be sent to other worker_threads without copying
+ * @param {number} [options.parallel=1] Split the window in up to this many block-aligned strips read concurrently on the free handles of a Dataset opened with {@link gdal.openPool}, ignored when the buffer size differs from the window size
+ * @param {boolean} [options.convertNoData=false] Replace the NoData value of the band with `noDataTo`, the conversion is done in the worker thread
+ * @param {number} [options.noDataTo=NaN] The value replacing NoData, `NaN` requires a floating point data type
+ * @param {boolean} [options.unscale=false] Apply the scale and the offset of the band to the values (`value * scale + offset`), requires a floating point data type
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
  * @param {callback<TypedArray>} [callback=undefined]
  * @return {Promise<TypedArray>} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
  */
@@ -329,6 +507,9 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
   int bytes_per_pixel;
   int pixel_space, line_space;
   int size, length, offset;
+  int parallel;
+  bool shared = false;
+  PixelConversion conv;
   void *data;
   Local<Value> array;
   Local<Object> obj;
@@ -374,18 +555,24 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
   }
   offset = 0;
   NODE_ARG_INT_OPT(12, "offset", offset);
-
-  if (findLowest(buffer_w, buffer_h, pixel_space, line_space, offset) < 0) {
+  parallel = 1;
+  NODE_ARG_INT_OPT(13, "parallel", parallel);
+  NODE_ARG_BOOL_OPT(14, "shared", shared);
+  NODE_ARG_BOOL_OPT(15, "convert_nodata", conv.noData);
+  NODE_ARG_DOUBLE_OPT(16, "nodata_to", conv.marker);
+  NODE_ARG_BOOL_OPT(17, "unscale", conv.scaled);
+
+  if (findLowest(buffer_w, buffer_h, pixel_space, line_space, offset * bytes_per_pixel) < 0) {
     Nan::ThrowError("has to write before the start of the TypedArray");
     return;
   }
-  size = findHighest(buffer_w, buffer_h, pixel_space, line_space, offset) + 1;
+  size = findHighest(buffer_w, buffer_h, pixel_space, line_space, offset * bytes_per_pixel) + 1;
   // length (elements) = size / bytes_per_pixel + 1 more if it is not a perfect fit
   length = size / bytes_per_pixel + ((size % bytes_per_pixel) ? 1 : 0);
 
   // create array if no array was passed
   if (obj.IsEmpty()) {
-    array = TypedArray::New(type, length);
+    array = TypedArray::New(type, length, shared);
     if (array.IsEmpty() || !array->IsObject()) {
       return; // TypedArray::New threw an error
     }
@@ -402,28 +589,263 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
   job.persist("array", obj);
   job.persist(band->handle());
   job.progress = cb;
+  job.pooled = band->isPoolable();
+  // Splitting the window works only without resampling and needs the other handles of a pool
+  if (buffer_w != w || buffer_h != h || !band->isPoolable()) parallel = 1;
 
   data = (uint8_t *)data + offset * bytes_per_pixel;
-  job.main = [gdal_band, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, resampling, cb](
-               const GDALExecutionProgress &progress) {
+  long ds_uid = band->parent_uid;
+  job.main = [
+               gdal_band,
+               ds_uid,
+               parallel,
+               x,
+               y,
+               w,
+               h,
+               data,
+               buffer_w,
+               buffer_h,
+               type,
+               pixel_space,
+               line_space,
+               resampling,
+               conv](const GDALExecutionProgress &progress) {
+    if (parallel > 1) {
+      CPLErr err =
+        parallelRasterIO(progress, ds_uid, gdal_band, x, y, w, h, data, type, pixel_space, line_space, parallel);
+      if (err != CE_None) throw CPLGetLastErrorMsg();
+      // The NoData, scale and offset of the handle held by this job
+      GDALRasterBand *raw = progress.pooledBand(gdal_band);
+      if (conv.active()) unpackPixels(conv.forBand(raw), data, type, buffer_w, buffer_h, pixel_space, line_space);
+      return err;
+    }
+
     std::shared_ptr<GDALRasterIOExtraArg> extra(new GDALRasterIOExtraArg);
     INIT_RASTERIO_EXTRA_ARG(*extra);
     extra->eResampleAlg = resampling;
-    if (cb) {
-      extra->pfnProgress = ProgressTrampoline;
-      extra->pProgressData = (void *)&progress;
-    }
+    extra->pfnProgress = progress.trampoline();
+    extra->pProgressData = (void *)&progress;
 
     CPLErrorReset();
-    CPLErr err =
-      gdal_band->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, extra.get());
+    GDALRasterBand *raw = progress.pooledBand(gdal_band);
+    CPLErr err = raw->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, extra.get());
 
     if (err != CE_None) throw CPLGetLastErrorMsg();
+    if (conv.active()) unpackPixels(conv.forBand(raw), data, type, buffer_w, buffer_h, pixel_space, line_space);
     return err;
   };
 
   job.rval = [](CPLErr err, const GetFromPersistentFunc &getter) { return getter("array"); };
-  job.run(info, async, 13);
+  job.run(info, async, 18);
+}
+
+/**
+ * @typedef {object} ReadWithMaskOptions
+ * @memberof RasterBandPixels
+ * @property {number} [buffer_width]
+ * @property {number} [buffer_height]
+ * @property {string} [type]
+ * @property {string} [resampling]
+ * @property {Uint8Array} [mask]
+ * @property {boolean} [premultiply]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
+ */
+
+/**
+ * @typedef {object} MaskedData
+ * @memberof RasterBandPixels
+ * @property {TypedArray} data
+ * @property {Uint8Array} mask
+ */
+
+/**
+ * Reads a region of pixels along with the matching region of the mask band.
+ *
+ * The mask band is not read when all the pixels are valid (the mask is then
+ * filled with `255`) or, when reading at full resolution in the band data type,
+ * when the mask is derived from the NoData value.
+ *
+ * @method readWithMask
+ * @instance
+ * @memberof RasterBandPixels
+ * @throws Error
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {TypedArray} [data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {ReadWithMaskOptions} [options]
+ * @param {number} [options.buffer_width=x_size]
+ * @param {number} [options.buffer_height=y_size]
+ * @param {string} [options.data_type] See {@link GDT|GDT constants}
+ * @param {string} [options.resampling] Resampling algorithm ({@link GRA|available options})
+ * @param {Uint8Array} [options.mask] The Uint8Array to put the mask in. A new array is created if not given.
+ * @param {boolean} [options.premultiply=false] Multiply the data by `mask / 255`
+ * @return {MaskedData}
+ */
+
+/**
+ * Asynchronously reads a region of pixels along with the matching region of the mask band.
+ *
+ * The mask band is not read when all the pixels are valid (the mask is then
+ * filled with `255`) or, when reading at full resolution in the band data type,
+ * when the mask is derived from the NoData value.
+ * @async
+ *
+ * @method readWithMaskAsync
+ * @instance
+ * @memberof RasterBandPixels
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {TypedArray} [data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {ReadWithMaskOptions} [options]
+ * @param {number} [options.buffer_width=x_size]
+ * @param {number} [options.buffer_height=y_size]
+ * @param {string} [options.data_type] See {@link GDT|GDT constants}
+ * @param {string} [options.resampling] Resampling algorithm ({@link GRA|available options})
+ * @param {Uint8Array} [options.mask] The Uint8Array to put the mask in. A new array is created if not given.
+ * @param {boolean} [options.premultiply=false] Multiply the data by `mask / 255`
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
+ * @param {callback<MaskedData>} [callback=undefined]
+ * @return {Promise<MaskedData>}
+ */
+GDAL_ASYNCABLE_DEFINE(RasterBandPixels::readWithMask) {
+
+  RasterBand *band;
+  if ((band = parent(info)) == nullptr) return;
+
+  int x, y, w, h;
+  int buffer_w, buffer_h;
+  bool premultiply = false;
+  Local<Object> obj, mask_obj;
+  GDALDataType type;
+
+  NODE_ARG_INT(0, "x_offset", x);
+  NODE_ARG_INT(1, "y_offset", y);
+  NODE_ARG_INT(2, "x_size", w);
+  NODE_ARG_INT(3, "y_size", h);
+
+  std::string type_name = "";
+
+  buffer_w = w;
+  buffer_h = h;
+  type = band->get()->GetRasterDataType();
+  NODE_ARG_INT_OPT(5, "buffer_width", buffer_w);
+  NODE_ARG_INT_OPT(6, "buffer_height", buffer_h);
+  NODE_ARG_OPT_STR(7, "data_type", type_name);
+  if (!type_name.empty()) { type = GDALGetDataTypeByName(type_name.c_str()); }
+
+  if (!info[4]->IsUndefined() && !info[4]->IsNull()) {
+    NODE_ARG_OBJECT(4, "data", obj);
+    type = TypedArray::Identify(obj);
+    if (type == GDT_Unknown) {
+      Nan::ThrowError("Invalid array");
+      return;
+    }
+  }
+
+  GDALRIOResampleAlg resampling;
+  try {
+    resampling = parseResamplingAlg(info[8]);
+  } catch (const char *e) {
+    Nan::ThrowError(e);
+    return;
+  }
+
+  if (!info[9]->IsUndefined() && !info[9]->IsNull()) {
+    NODE_ARG_OBJECT(9, "mask", mask_obj);
+    if (TypedArray::Identify(mask_obj) != GDT_Byte) {
+      Nan::ThrowError("mask must be an Uint8Array");
+      return;
+    }
+  }
+  NODE_ARG_BOOL_OPT(10, "premultiply", premultiply);
+
+  if (buffer_w <= 0 || buffer_h <= 0) {
+    Nan::ThrowRangeError("Invalid buffer size");
+    return;
+  }
+  int length = buffer_w * buffer_h;
+
+  if (obj.IsEmpty()) {
+    Local<Value> array = TypedArray::New(type, length);
+    if (array.IsEmpty() || !array->IsObject()) {
+      return; // TypedArray::New threw an error
+    }
+    obj = array.As<Object>();
+  }
+  if (mask_obj.IsEmpty()) {
+    Local<Value> array = TypedArray::New(GDT_Byte, length);
+    if (array.IsEmpty() || !array->IsObject()) {
+      return; // TypedArray::New threw an error
+    }
+    mask_obj = array.As<Object>();
+  }
+
+  void *data = TypedArray::Validate(obj, type, length);
+  if (!data) {
+    return; // TypedArray::Validate threw an error
+  }
+  uint8_t *mask = static_cast<uint8_t *>(TypedArray::Validate(mask_obj, GDT_Byte, length));
+  if (!mask) {
+    return; // TypedArray::Validate threw an error
+  }
+
+  GDALRasterBand *gdal_band = band->get();
+  GDALAsyncableJob<int> job(band->parent_uid);
+  job.persist("data", obj);
+  job.persist("mask", mask_obj);
+  job.persist(band->handle());
+  job.pooled = band->isPoolable();
+
+  job.main = [gdal_band, x, y, w, h, data, mask, buffer_w, buffer_h, type, resampling, premultiply](
+               const GDALExecutionProgress &progress) {
+    GDALRasterIOExtraArg extra;
+    INIT_RASTERIO_EXTRA_ARG(extra);
+    extra.eResampleAlg = resampling;
+
+    GDALRasterBand *raw = progress.pooledBand(gdal_band);
+    size_t length = static_cast<size_t>(buffer_w) * buffer_h;
+
+    CPLErrorReset();
+    CPLErr err = raw->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, 0, 0, &extra);
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+
+    int flags = raw->GetMaskFlags();
+    if (flags & GMF_ALL_VALID) {
+      memset(mask, 255, length);
+    } else if ((flags & GMF_NODATA) && type == raw->GetRasterDataType() && buffer_w == w && buffer_h == h) {
+      // The data has just been read, there is no need to decode it a second time
+      int success = 0;
+      double nodata = raw->GetNoDataValue(&success);
+      if (success)
+        noDataMask(data, type, length, nodata, mask);
+      else
+        memset(mask, 255, length);
+    } else {
+      err = raw->GetMaskBand()->RasterIO(GF_Read, x, y, w, h, mask, buffer_w, buffer_h, GDT_Byte, 0, 0, &extra);
+      if (err != CE_None) throw CPLGetLastErrorMsg();
+    }
+
+    if (premultiply) premultiplyPixels(data, type, length, mask);
+    return flags;
+  };
+
+  job.rval = [](int, const GetFromPersistentFunc &getter) {
+    Nan::EscapableHandleScope scope;
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("data").ToLocalChecked(), getter("data"));
+    Nan::Set(result, Nan::New("mask").ToLocalChecked(), getter("mask"));
+    return scope.Escape(result);
+  };
+  job.run(info, async, 11);
 }
 
 /**
@@ -435,6 +857,12 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
  * @property {number} [line_space]
  * @property {ProgressCb} [progress_cb]
  * @property {number} [offset]
+ * @property {boolean} [convertNoData]
+ * @property {number} [noDataFrom]
+ * @property {boolean} [unscale]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
  */
 
 /**
@@ -455,6 +883,9 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
  * @param {number} [options.pixel_space]
  * @param {number} [options.line_space]
  * @param {ProgressCb} [options.progress_cb]
+ * @param {boolean} [options.convertNoData=false] Replace `noDataFrom` with the NoData value of the band, the conversion is done in the worker thread on a copy of the data
+ * @param {number} [options.noDataFrom=NaN] The value representing NoData in `data`
+ * @param {boolean} [options.unscale=false] The values are unscaled, apply the inverse of the scale and the offset of the band (`(value - offset) / scale`), requires a floating point data type
  */
 
 /**
@@ -475,6 +906,12 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
  * @param {number} [options.pixel_space]
  * @param {number} [options.line_space]
  * @param {ProgressCb} [options.progress_cb]
+ * @param {boolean} [options.convertNoData=false] Replace `noDataFrom` with the NoData value of the band, the conversion is done in the worker thread on a copy of the data
+ * @param {number} [options.noDataFrom=NaN] The value representing NoData in `data`
+ * @param {boolean} [options.unscale=false] The values are unscaled, apply the inverse of the scale and the offset of the band (`(value - offset) / scale`), requires a floating point data type
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
  * @param {callback<void>} [callback=undefined]
  * @return {Promise<void>}
  */
@@ -487,11 +924,12 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::write) {
   int buffer_w, buffer_h;
   int bytes_per_pixel;
   int pixel_space, line_space;
-  int size, length, offset;
+  int size, length, offset, lowest;
   void *data;
   Local<Object> passed_array;
   GDALDataType type;
   Nan::Callback *cb = nullptr;
+  PixelConversion conv;
 
   NODE_ARG_INT(0, "x_offset", x);
   NODE_ARG_INT(1, "y_offset", y);
@@ -518,12 +956,16 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::write) {
   NODE_ARG_CB_OPT(9, "progress_cb", cb);
   offset = 0;
   NODE_ARG_INT_OPT(10, "offset", offset);
+  NODE_ARG_BOOL_OPT(11, "convert_nodata", conv.noData);
+  NODE_ARG_DOUBLE_OPT(12, "nodata_from", conv.marker);
+  NODE_ARG_BOOL_OPT(13, "unscale", conv.scaled);
 
-  if (findLowest(buffer_w, buffer_h, pixel_space, line_space, offset) < 0) {
+  lowest = findLowest(buffer_w, buffer_h, pixel_space, line_space, offset * bytes_per_pixel);
+  if (lowest < 0) {
     Nan::ThrowError("has to read before the start of the TypedArray");
     return;
   }
-  size = findHighest(buffer_w, buffer_h, pixel_space, line_space, offset) + 1;
+  size = findHighest(buffer_w, buffer_h, pixel_space, line_space, offset * bytes_per_pixel) + 1;
   // length (elements) = size / bytes_per_pixel + 1 more if it is not a perfect fit
   length = size / bytes_per_pixel + ((size % bytes_per_pixel) ? 1 : 0);
 
@@ -541,25 +983,46 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::write) {
     job.progress = cb;
   }
 
+  uint8_t *region = (uint8_t *)data + lowest;
+  int region_size = size - lowest;
   data = (uint8_t *)data + offset * bytes_per_pixel;
-  job.main = [gdal_band, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, cb](
-               const GDALExecutionProgress &progress) {
+  job.main = [gdal_band,
+              x,
+              y,
+              w,
+              h,
+              data,
+              buffer_w,
+              buffer_h,
+              type,
+              pixel_space,
+              line_space,
+              conv,
+              region,
+              region_size](const GDALExecutionProgress &progress) {
+    // The conversion is applied to a copy, the array of the caller is left untouched
+    std::vector<uint8_t> copy;
+    void *src = data;
+    if (conv.active()) {
+      copy.assign(region, region + region_size);
+      src = copy.data() + ((uint8_t *)data - region);
+      packPixels(conv.forBand(gdal_band), src, type, buffer_w, buffer_h, pixel_space, line_space);
+    }
+
     std::shared_ptr<GDALRasterIOExtraArg> extra(new GDALRasterIOExtraArg);
     INIT_RASTERIO_EXTRA_ARG(*extra);
-    if (cb) {
-      extra->pfnProgress = ProgressTrampoline;
-      extra->pProgressData = (void *)&progress;
-    }
+    extra->pfnProgress = progress.trampoline();
+    extra->pProgressData = (void *)&progress;
 
     CPLErrorReset();
     CPLErr err =
-      gdal_band->RasterIO(GF_Write, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, extra.get());
+      gdal_band->RasterIO(GF_Write, x, y, w, h, src, buffer_w, buffer_h, type, pixel_space, line_space, extra.get());
     if (err != CE_None) throw CPLGetLastErrorMsg();
     return err;
   };
   job.rval = [](CPLErr, const GetFromPersistentFunc &getter) { return getter("array"); };
 
-  job.run(info, async, 11);
+  job.run(info, async, 14);
 }
 
 /**
@@ -571,7 +1034,7 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::write) {
  * @throws Error
  * @param {number} x
  * @param {number} y
- * @param {TypedArray} [data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {TypedArray|BufferPool} [data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in or a BufferPool to take it from. A new array is created if not given.
  * @return {TypedArray} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
  */
 
@@ -585,7 +1048,7 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::write) {
  * @throws Error
  * @param {number} x
  * @param {number} y
- * @param {TypedArray} [data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {TypedArray|BufferPool} [data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in or a BufferPool to take it from. A new array is created if not given.
  * @param {callback<TypedArray>} [callback=undefined]
  * @return {Promise<TypedArray>} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
  */
@@ -627,9 +1090,10 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::readBlock) {
   GDALAsyncableJob<CPLErr> job(band->parent_uid);
   job.persist("array", obj);
   job.persist(band->handle());
-  job.main = [gdal_band, x, y, data](const GDALExecutionProgress &) {
+  job.pooled = band->isPoolable();
+  job.main = [gdal_band, x, y, data](const GDALExecutionProgress &progress) {
     CPLErrorReset();
-    CPLErr err = gdal_band->ReadBlock(x, y, data);
+    CPLErr err = progress.pooledBand(gdal_band)->ReadBlock(x, y, data);
     if (err) { throw CPLGetLastErrorMsg(); }
     return err;
   };
@@ -758,6 +1222,184 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::clampBlock) {
   job.run(info, async, 2);
 }
 
+/**
+ * @typedef {object} AdviseReadOptions
+ * @memberof RasterBandPixels
+ * @property {number} [buffer_width]
+ * @property {number} [buffer_height]
+ * @property {string} [type]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
+ */
+
+/**
+ * Advises the driver that a region of pixels will be read soon.
+ *
+ * Drivers reading from the network, such as the GTiff driver on `/vsicurl/`,
+ * can fetch all the data in advance, the other drivers ignore the hint.
+ *
+ * @method adviseRead
+ * @instance
+ * @memberof RasterBandPixels
+ * @throws Error
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {AdviseReadOptions} [options]
+ * @param {number} [options.buffer_width=x_size]
+ * @param {number} [options.buffer_height=y_size]
+ * @param {string} [options.data_type] See {@link GDT|GDT constants}
+ * @return {void}
+ */
+
+/**
+ * Advises the driver that a region of pixels will be read soon.
+ *
+ * Drivers reading from the network, such as the GTiff driver on `/vsicurl/`,
+ * can fetch all the data in advance, the other drivers ignore the hint.
+ * @async
+ *
+ * @method adviseReadAsync
+ * @instance
+ * @memberof RasterBandPixels
+ * @throws Error
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {AdviseReadOptions} [options]
+ * @param {number} [options.buffer_width=x_size]
+ * @param {number} [options.buffer_height=y_size]
+ * @param {string} [options.data_type] See {@link GDT|GDT constants}
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
+ * @param {callback<void>} [callback=undefined]
+ * @return {Promise<void>}
+ */
+GDAL_ASYNCABLE_DEFINE(RasterBandPixels::adviseRead) {
+
+  RasterBand *band;
+  if ((band = parent(info)) == nullptr) return;
+
+  int x, y, w, h;
+  int buffer_w, buffer_h;
+  GDALDataType type;
+
+  NODE_ARG_INT(0, "x_offset", x);
+  NODE_ARG_INT(1, "y_offset", y);
+  NODE_ARG_INT(2, "x_size", w);
+  NODE_ARG_INT(3, "y_size", h);
+
+  std::string type_name = "";
+
+  buffer_w = w;
+  buffer_h = h;
+  type = band->get()->GetRasterDataType();
+  NODE_ARG_INT_OPT(4, "buffer_width", buffer_w);
+  NODE_ARG_INT_OPT(5, "buffer_height", buffer_h);
+  NODE_ARG_OPT_STR(6, "data_type", type_name);
+  if (!type_name.empty()) { type = GDALGetDataTypeByName(type_name.c_str()); }
+
+  GDALRasterBand *gdal_band = band->get();
+  GDALAsyncableJob<CPLErr> job(band->parent_uid);
+  job.persist(band->handle());
+  job.main = [gdal_band, x, y, w, h, buffer_w, buffer_h, type](const GDALExecutionProgress &) {
+    CPLErrorReset();
+    CPLErr err = gdal_band->AdviseRead(x, y, w, h, buffer_w, buffer_h, type, nullptr);
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+    return err;
+  };
+  job.rval = [](CPLErr, const GetFromPersistentFunc &) { return Nan::Undefined().As<Value>(); };
+  job.run(info, async, 7);
+}
+
+/**
+ * @typedef {TypedArray & { release: () => void }} LockedBlock
+ * @memberof RasterBandPixels
+ */
+
+/**
+ * Locks a block in the GDAL block cache and returns a TypedArray that
+ * points directly to its memory, without copying it.
+ *
+ * The block cannot be evicted from the cache while it is locked. The lock is
+ * released by calling the `release()` method of the returned array, when the
+ * array is garbage-collected or when the dataset is closed. An explicitly
+ * released array becomes empty.
+ *
+ * The array aliases the block in the shared GDAL block cache: every write to it is
+ * seen by all the subsequent reads of this block and it will be written to the dataset
+ * if the block is flushed after being modified through another GDAL write. Treat it as
+ * read-only unless this is intended and copy it (`array.slice()`) if you need
+ * a private buffer.
+ *
+ * @method lockBlock
+ * @instance
+ * @memberof RasterBandPixels
+ * @throws Error
+ * @param {number} x
+ * @param {number} y
+ * @return {LockedBlock} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values with a `release()` method.
+ */
+
+/**
+ * Locks a block in the GDAL block cache and returns a TypedArray that
+ * points directly to its memory, without copying it.
+ *
+ * The block cannot be evicted from the cache while it is locked. The lock is
+ * released by calling the `release()` method of the returned array, when the
+ * array is garbage-collected or when the dataset is closed. An explicitly
+ * released array becomes empty.
+ *
+ * The array aliases the block in the shared GDAL block cache: every write to it is
+ * seen by all the subsequent reads of this block and it will be written to the dataset
+ * if the block is flushed after being modified through another GDAL write. Treat it as
+ * read-only unless this is intended and copy it (`array.slice()`) if you need
+ * a private buffer.
+ * @async
+ *
+ * @method lockBlockAsync
+ * @instance
+ * @memberof RasterBandPixels
+ * @throws Error
+ * @param {number} x
+ * @param {number} y
+ * @param {callback<LockedBlock>} [callback=undefined]
+ * @return {Promise<LockedBlock>} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values with a `release()` method.
+ */
+GDAL_ASYNCABLE_DEFINE(RasterBandPixels::lockBlock) {
+
+  RasterBand *band;
+  if ((band = parent(info)) == nullptr) return;
+
+  int x, y;
+  NODE_ARG_INT(0, "block_x_offset", x);
+  NODE_ARG_INT(1, "block_y_offset", y);
+
+  GDALRasterBand *gdal_band = band->get();
+  long ds_uid = band->parent_uid;
+
+  GDALAsyncableJob<GDALRasterBlock *> job(ds_uid);
+  job.persist("band", band->handle());
+  job.pooled = band->isPoolable();
+  job.main = [gdal_band, x, y, ds_uid](const GDALExecutionProgress &progress) {
+    CPLErrorReset();
+    GDALRasterBlock *block = progress.pooledBand(gdal_band)->GetLockedBlockRef(x, y);
+    if (block == nullptr) { throw CPLGetLastErrorMsg(); }
+    // Registered while the Dataset lock is still held, closing the Dataset
+    // before rval() runs will drop it
+    PinnedBlock::pin(block, ds_uid);
+    return block;
+  };
+  job.rval = [ds_uid](GDALRasterBlock *block, const GetFromPersistentFunc &getter) {
+    return PinnedBlock::New(block, getter("band").As<Object>(), ds_uid);
+  };
+  job.run(info, async, 2);
+}
+
 /**
  * Parent raster band
  *
@@ -19,9 +19,12 @@ using namespace node;
 
 namespace node_gdal {
 
+// Shared with DatasetPixels
+GDALRIOResampleAlg parseResamplingAlg(Local<Value> value);
+
 class RasterBandPixels : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
@@ -31,10 +34,13 @@ class RasterBandPixels : public Nan::ObjectWrap {
   GDAL_ASYNCABLE_DECLARE(get);
   GDAL_ASYNCABLE_DECLARE(set);
   GDAL_ASYNCABLE_DECLARE(read);
+  GDAL_ASYNCABLE_DECLARE(readWithMask);
   GDAL_ASYNCABLE_DECLARE(write);
   GDAL_ASYNCABLE_DECLARE(readBlock);
   GDAL_ASYNCABLE_DECLARE(writeBlock);
   GDAL_ASYNCABLE_DECLARE(clampBlock);
+  GDAL_ASYNCABLE_DECLARE(lockBlock);
+  GDAL_ASYNCABLE_DECLARE(adviseRead);
 
   static NAN_GETTER(bandGetter);
 
@@ -4,10 +4,23 @@
 #include "gdal_layer.hpp"
 #include "gdal_rasterband.hpp"
 #include "utils/number_list.hpp"
+#include "utils/raster_expression.hpp"
 #include "utils/typed_array.hpp"
-
+#include "utils/zonal_stats.hpp"
 #include "node_gdal.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace node_gdal {
 
 void Algorithms::Initialize(Local<Object> target) {
@@ -16,9 +29,11 @@ void Algorithms::Initialize(Local<Object> target) {
   Nan__SetAsyncableMethod(target, "sieveFilter", sieveFilter);
   Nan__SetAsyncableMethod(target, "checksumImage", checksumImage);
   Nan__SetAsyncableMethod(target, "polygonize", polygonize);
+  Nan__SetAsyncableMethod(target, "zonalStatistics", zonalStatistics);
   Nan::SetMethod(target, "addPixelFunc", addPixelFunc);
   Nan::SetMethod(target, "toPixelFunc", toPixelFunc);
   Nan__SetAsyncableMethod(target, "_acquireLocks", _acquireLocks);
+  Nan__SetAsyncableMethod(target, "_calcExpression", _calcExpression);
 }
 
 /**
@@ -210,8 +225,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::contourGenerate) {
               nodata,
               gdal_dst,
               id_field,
-              elev_field,
-              progress_cb](const GDALExecutionProgress &progress) {
+              elev_field](const GDALExecutionProgress &progress) {
     CPLErrorReset();
     CPLErr err = GDALContourGenerate(
       gdal_src,
@@ -224,8 +238,8 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::contourGenerate) {
       gdal_dst,
       id_field,
       elev_field,
-      progress_cb ? ProgressTrampoline : nullptr,
-      progress_cb ? (void *)&progress : nullptr);
+      progress.trampoline(),
+      (void *)&progress);
     if (err) { throw CPLGetLastErrorMsg(); }
     return err;
   };
@@ -308,7 +322,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::sieveFilter) {
   GDALAsyncableJob<CPLErr> job(ds_uids);
   job.progress = progress_cb;
   job.main =
-    [gdal_src, gdal_dst, gdal_mask, threshold, connectedness, progress_cb](const GDALExecutionProgress &progress) {
+    [gdal_src, gdal_dst, gdal_mask, threshold, connectedness](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       CPLErr err = GDALSieveFilter(
         gdal_src,
@@ -317,8 +331,8 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::sieveFilter) {
         threshold,
         connectedness,
         NULL,
-        progress_cb ? ProgressTrampoline : nullptr,
-        progress_cb ? (void *)&progress : nullptr);
+        progress.trampoline(),
+        (void *)&progress);
       if (err) { throw CPLGetLastErrorMsg(); }
       return err;
     };
@@ -489,7 +503,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::polygonize) {
     Nan::HasOwnProperty(obj, Nan::New("useFloats").ToLocalChecked()).FromMaybe(false) &&
     Nan::To<bool>(Nan::Get(obj, Nan::New("useFloats").ToLocalChecked()).ToLocalChecked()).ToChecked()) {
     job.main =
-      [gdal_src, gdal_mask, gdal_dst, pix_val_field, papszOptions, progress_cb](const GDALExecutionProgress &progress) {
+      [gdal_src, gdal_mask, gdal_dst, pix_val_field, papszOptions](const GDALExecutionProgress &progress) {
         CPLErrorReset();
         CPLErr err = GDALFPolygonize(
           gdal_src,
@@ -497,15 +511,15 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::polygonize) {
           reinterpret_cast<OGRLayerH>(gdal_dst),
           pix_val_field,
           papszOptions,
-          progress_cb ? ProgressTrampoline : nullptr,
-          progress_cb ? (void *)&progress : nullptr);
+          progress.trampoline(),
+          (void *)&progress);
         if (papszOptions) CSLDestroy(papszOptions);
         if (err) throw CPLGetLastErrorMsg();
         return err;
       };
   } else {
     job.main =
-      [gdal_src, gdal_mask, gdal_dst, pix_val_field, papszOptions, progress_cb](const GDALExecutionProgress &progress) {
+      [gdal_src, gdal_mask, gdal_dst, pix_val_field, papszOptions](const GDALExecutionProgress &progress) {
         CPLErrorReset();
         CPLErr err = GDALPolygonize(
           gdal_src,
@@ -513,8 +527,8 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::polygonize) {
           reinterpret_cast<OGRLayerH>(gdal_dst),
           pix_val_field,
           papszOptions,
-          progress_cb ? ProgressTrampoline : nullptr,
-          progress_cb ? (void *)&progress : nullptr);
+          progress.trampoline(),
+          (void *)&progress);
         if (papszOptions) CSLDestroy(papszOptions);
         if (err) throw CPLGetLastErrorMsg();
         return err;
@@ -524,6 +538,231 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::polygonize) {
   job.run(info, async, 1);
 }
 
+static const char *zonalStatNames[] = {"count", "sum", "mean", "min", "max", "std"};
+
+// A Float64Array column of the result, nullptr if it could not be created
+static double *newColumn(Local<Object> result, const std::string &name, size_t length) {
+  Local<Value> array = TypedArray::New(GDT_Float64, static_cast<unsigned int>(length));
+  if (array.IsEmpty() || !array->IsObject()) return nullptr;
+  Nan::Set(result, Nan::New(name).ToLocalChecked(), array);
+  return static_cast<double *>(TypedArray::Validate(array.As<Object>(), GDT_Float64, static_cast<int>(length)));
+}
+
+/**
+ * @typedef {object} ZonalStatisticsOptions
+ * @property {string[]} [stats]
+ * @property {boolean} [allTouched]
+ * @property {number} [parallel]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
+ */
+
+/**
+ * @typedef {object} ZonalStatisticsResult
+ * @property {Float64Array} fid
+ * @property {Float64Array} [count]
+ * @property {Float64Array} [sum]
+ * @property {Float64Array} [mean]
+ * @property {Float64Array} [min]
+ * @property {Float64Array} [max]
+ * @property {Float64Array} [std]
+ */
+
+/**
+ * Computes the statistics of the pixels of a raster band covered by each
+ * feature of a layer.
+ *
+ * The statistics are returned as columns, the n-th element of each column
+ * belongs to the feature `result.fid[n]`. The pixels that are NoData, NaN or
+ * invalid according to the mask band are ignored. `min`, `max`, `mean` and
+ * `std` are `NaN` for the features that do not cover any valid pixel.
+ *
+ * Every geometry is rasterized only in the blocks of the band that intersect
+ * its envelope, the features can overlap. The geometries are reprojected when
+ * the layer and the raster have different spatial references.
+ *
+ * @throws Error
+ * @method zonalStatistics
+ * @static
+ * @param {RasterBand} band
+ * @param {Layer} layer
+ * @param {ZonalStatisticsOptions} [options]
+ * @param {string[]} [options.stats=['count','sum','mean','min','max','std']] The statistics to compute
+ * @param {boolean} [options.allTouched=false] Include all the pixels touched by the geometries, not only those whose center is inside
+ * @param {number} [options.parallel=1] Process the blocks concurrently on up to this many handles of a Dataset opened with {@link gdal.openPool}
+ * @return {ZonalStatisticsResult}
+ */
+
+/**
+ * Computes the statistics of the pixels of a raster band covered by each
+ * feature of a layer.
+ * @async
+ *
+ * The statistics are returned as columns, the n-th element of each column
+ * belongs to the feature `result.fid[n]`. The pixels that are NoData, NaN or
+ * invalid according to the mask band are ignored. `min`, `max`, `mean` and
+ * `std` are `NaN` for the features that do not cover any valid pixel.
+ *
+ * Every geometry is rasterized only in the blocks of the band that intersect
+ * its envelope, the features can overlap. The geometries are reprojected when
+ * the layer and the raster have different spatial references.
+ *
+ * @example
+ * const { fid, mean } = await gdal.zonalStatisticsAsync(band, parcels, { stats: [ 'mean' ], parallel: 4 });
+ *
+ * @throws Error
+ * @method zonalStatisticsAsync
+ * @static
+ * @param {RasterBand} band
+ * @param {Layer} layer
+ * @param {ZonalStatisticsOptions} [options]
+ * @param {string[]} [options.stats=['count','sum','mean','min','max','std']] The statistics to compute
+ * @param {boolean} [options.allTouched=false] Include all the pixels touched by the geometries, not only those whose center is inside
+ * @param {number} [options.parallel=1] Process the blocks concurrently on up to this many handles of a Dataset opened with {@link gdal.openPool}
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
+ * @param {callback<ZonalStatisticsResult>} [callback=undefined]
+ * @return {Promise<ZonalStatisticsResult>}
+ */
+
+GDAL_ASYNCABLE_DEFINE(Algorithms::zonalStatistics) {
+  RasterBand *src;
+  Layer *zones;
+  Local<Object> options = Nan::New<Object>();
+  Local<Array> stats_list;
+  std::vector<std::string> stats(std::begin(zonalStatNames), std::end(zonalStatNames));
+  bool all_touched = false;
+  int parallel = 1;
+
+  NODE_ARG_WRAPPED(0, "band", RasterBand, src);
+  NODE_ARG_WRAPPED(1, "layer", Layer, zones);
+  NODE_ARG_OBJECT_OPT(2, "options", options);
+  NODE_ARRAY_FROM_OBJ_OPT(options, "stats", stats_list);
+  NODE_BOOL_FROM_OBJ_OPT(options, "allTouched", all_touched);
+  NODE_INT_FROM_OBJ_OPT(options, "parallel", parallel);
+
+  if (!stats_list.IsEmpty()) {
+    stats.clear();
+    for (unsigned i = 0; i < stats_list->Length(); i++) {
+      Local<Value> name = Nan::Get(stats_list, i).ToLocalChecked();
+      std::string stat = name->IsString() ? *Nan::Utf8String(name) : "";
+      if (std::find(std::begin(zonalStatNames), std::end(zonalStatNames), stat) == std::end(zonalStatNames)) {
+        Nan::ThrowError("stats must be an array of \"count\", \"sum\", \"mean\", \"min\", \"max\" or \"std\"");
+        return;
+      }
+      stats.push_back(stat);
+    }
+  }
+
+  GDALRasterBand *gdal_src = src->get();
+  OGRLayer *gdal_zones = zones->get();
+  long src_uid = src->parent_uid;
+
+  std::vector<long> ds_uids = {src->parent_uid};
+  if (zones->parent_uid != src->parent_uid) ds_uids.push_back(zones->parent_uid);
+
+  GDALAsyncableJob<ZonalStatistics> job(ds_uids);
+  job.persist(src->handle(), zones->handle());
+  job.main = [gdal_src, gdal_zones, src_uid, all_touched, parallel](const GDALExecutionProgress &progress) {
+    return computeZonalStatistics(progress, src_uid, gdal_src, gdal_zones, all_touched, parallel);
+  };
+  job.rval = [stats](const ZonalStatistics &r, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    Local<Object> result = Nan::New<Object>();
+    size_t length = r.fids.size();
+
+    double *fid = newColumn(result, "fid", length);
+    for (size_t i = 0; fid != nullptr && i < length; i++) fid[i] = static_cast<double>(r.fids[i]);
+    for (const std::string &stat : stats) {
+      double *column = newColumn(result, stat, length);
+      for (size_t i = 0; column != nullptr && i < length; i++) {
+        const PartialStats &zone = r.zones[i];
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        if (stat == "count")
+          column[i] = static_cast<double>(zone.count);
+        else if (stat == "sum")
+          column[i] = zone.mean * zone.count;
+        else if (stat == "mean")
+          column[i] = zone.count > 0 ? zone.mean : nan;
+        else if (stat == "min")
+          column[i] = zone.count > 0 ? zone.min : nan;
+        else if (stat == "max")
+          column[i] = zone.count > 0 ? zone.max : nan;
+        else
+          column[i] = zone.count > 0 ? zone.std_dev() : nan;
+      }
+    }
+    return scope.Escape(result).As<Value>();
+  };
+  job.run(info, async, 3);
+}
+
+// This is the native engine of calcAsync() with a string expression (lib/calc.js)
+// The expression is parsed here, in the main thread, so that the syntax
+// errors are reported immediately
+GDAL_ASYNCABLE_DEFINE(Algorithms::_calcExpression) {
+  Local<Object> inputs_obj;
+  RasterBand *output;
+  std::string text;
+  Local<Object> options = Nan::New<Object>();
+  bool convert_nodata = false;
+  bool convert_input = false;
+  Nan::Callback *progress_cb = nullptr;
+
+  NODE_ARG_OBJECT(0, "inputs", inputs_obj);
+  NODE_ARG_WRAPPED(1, "output", RasterBand, output);
+  NODE_ARG_STR(2, "expression", text);
+  NODE_ARG_OBJECT_OPT(3, "options", options);
+  NODE_BOOL_FROM_OBJ_OPT(options, "convertNoData", convert_nodata);
+  NODE_BOOL_FROM_OBJ_OPT(options, "convertInput", convert_input);
+  NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
+
+  std::vector<std::string> names;
+  std::vector<GDALRasterBand *> inputs;
+  std::vector<Local<Object>> handles = {output->handle()};
+  std::vector<long> ds_uids = {output->parent_uid};
+  Local<Array> keys = Nan::GetOwnPropertyNames(inputs_obj).ToLocalChecked();
+  for (unsigned i = 0; i < keys->Length(); i++) {
+    Local<Value> key = Nan::Get(keys, i).ToLocalChecked();
+    Local<Value> value = Nan::Get(inputs_obj, key).ToLocalChecked();
+    if (!value->IsObject() || !Nan::New(RasterBand::constructor)->HasInstance(value)) {
+      Nan::ThrowTypeError("All inputs must be instances of gdal.RasterBand");
+      return;
+    }
+    RasterBand *input = Nan::ObjectWrap::Unwrap<RasterBand>(value.As<Object>());
+    if (!input->isAlive()) {
+      Nan::ThrowError("RasterBand object has already been destroyed");
+      return;
+    }
+    names.push_back(*Nan::Utf8String(key));
+    inputs.push_back(input->get());
+    handles.push_back(input->handle());
+    if (std::find(ds_uids.begin(), ds_uids.end(), input->parent_uid) == ds_uids.end())
+      ds_uids.push_back(input->parent_uid);
+  }
+
+  std::shared_ptr<RasterExpression> expression;
+  try {
+    expression = std::make_shared<RasterExpression>(text, names);
+  } catch (const char *e) {
+    Nan::ThrowError(e);
+    return;
+  }
+
+  GDALRasterBand *gdal_output = output->get();
+  GDALAsyncableJob<int> job(ds_uids);
+  job.persist(handles);
+  job.progress = progress_cb;
+  job.main = [inputs, gdal_output, expression, convert_nodata, convert_input](const GDALExecutionProgress &progress) {
+    calcExpression(progress, inputs, gdal_output, *expression, convert_nodata, convert_input);
+    return 0;
+  };
+  job.rval = [](int, const GetFromPersistentFunc &) { return Nan::Undefined().As<Value>(); };
+  job.run(info, async, 4);
+}
+
 // This is used for stress-testing the locking mechanism
 // it doesn't do anything but sollicit locks
 GDAL_ASYNCABLE_DEFINE(Algorithms::_acquireLocks) {
@@ -590,6 +829,7 @@ NAN_METHOD(Algorithms::addPixelFunc) {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 5)
 // This is the arguments of one call of the pixel function
+// It lives on the stack of the worker thread that waits for its completion
 struct pixelFnCall {
   void **sources;
   size_t num;
@@ -598,21 +838,55 @@ struct pixelFnCall {
   GDALDataType inType;
   GDALDataType outType;
   std::map<std::string, std::string> args;
-  Nan::Utf8String *err;
+  // The raw arguments, the key of the cache of the parsed arguments
+  std::string argsKey;
+  std::string err;
+  bool failed;
+  bool done;
+};
+
+// A TypedArray pointing to a GDAL buffer, VRT reuses its buffers
+struct pixelFnView {
+  void *data;
+  GDALDataType type;
+  size_t length;
+  // A Global, unlike a Persistent, releases the object when it is destroyed
+  Nan::Global<Object> array;
 };
 
 // This is the pixel function descriptor
 // The queue can be modified both by the main thread and the worker threads
+// The JS function is called on the event loop of the isolate that created it
+// All the pending calls are drained by a single wakeup of the event loop,
+// uv_async_send() coalesces the notifications of concurrent worker threads
 struct pixelFn {
   Nan::Callback *fn;
-  pixelFnCall call;
-  uv_mutex_t callJS;
-  uv_sem_t returnJS;
+  uv_loop_t *loop;
+  std::thread::id thread;
+  uv_async_t *async;
+  std::mutex queueLock;
+  std::condition_variable returned;
+  std::vector<pixelFnCall *> queue;
+  // The isolate has been destroyed
+  bool closed;
+  // These are used only on the main thread
+  std::list<pixelFnView> views;
+  std::map<std::string, Nan::Global<Object>> argsCache;
+
+  pixelFn(Nan::Callback *fn)
+    : fn(fn), loop(Nan::GetCurrentEventLoop()), thread(std::this_thread::get_id()), async(nullptr), closed(false) {
+  }
 };
 
-// Only the main thread can modify this and only by adding new elements
-// No need to lock
-std::vector<pixelFn> pixelFuncs;
+// The main threads of all the isolates can add new elements
+// and the worker threads look them up, the descriptors are never freed
+// as GDAL cannot unregister a pixel function
+static std::mutex pixelFuncsLock;
+static std::vector<std::unique_ptr<pixelFn>> pixelFuncs;
+
+// The caches are small, a VRT has a few buffers per band and a few argument lists
+static const size_t pixelFnViewsCache = 64;
+static const size_t pixelFnArgsCache = 16;
 
 #define PFN_ID_FIELD "node_gdal_pfn_id"
 const char metadataTemplate[] =
@@ -621,50 +895,104 @@ const char metadataTemplate[] =
   "' type='constant' value='%x' />\n"
   "</PixelFunctionArgumentsList>";
 
+// A cached view of a buffer, the most recently used are at the front
+static Local<Value> pixelFnGetView(pixelFn *fn, void *data, GDALDataType type, size_t length) {
+  for (auto it = fn->views.begin(); it != fn->views.end(); it++) {
+    if (it->data == data && it->type == type && it->length == length) {
+      if (it != fn->views.begin()) fn->views.splice(fn->views.begin(), fn->views, it);
+      return Nan::New(fn->views.front().array);
+    }
+  }
+  Local<Value> array = TypedArray::New(type, data, length);
+  if (fn->views.size() >= pixelFnViewsCache) fn->views.pop_back();
+  fn->views.emplace_front();
+  pixelFnView &view = fn->views.front();
+  view.data = data;
+  view.type = type;
+  view.length = length;
+  view.array.Reset(array.As<Object>());
+  return array;
+}
+
+// The arguments object is shared by all the calls with the same arguments
+static Local<Object> pixelFnGetArgs(pixelFn *fn, const pixelFnCall &call) {
+  auto cached = fn->argsCache.find(call.argsKey);
+  if (cached != fn->argsCache.end()) return Nan::New(cached->second);
+
+  Local<Object> pfArgs = Nan::New<Object>();
+  for (auto const &el : call.args) {
+    char *end;
+    double dval = std::strtod(el.second.c_str(), &end);
+    if (*end == 0)
+      Nan::Set(pfArgs, Nan::New(el.first).ToLocalChecked(), Nan::New(dval));
+    else
+      Nan::Set(pfArgs, Nan::New(el.first).ToLocalChecked(), Nan::New(el.second).ToLocalChecked());
+  }
+  if (fn->argsCache.size() >= pixelFnArgsCache) fn->argsCache.clear();
+  fn->argsCache[call.argsKey].Reset(pfArgs);
+  return pfArgs;
+}
+
 // This is the final step before calling the JS function
-// This function is called by libuv on the main thread
-// The async_send in the function below is what triggers this call
-static void callJSpfn(uv_async_t *async) {
+// This function is called on the main thread of the isolate that created the function
+static void callJSpfn(pixelFn *fn, pixelFnCall &call) {
   // Here V8 is accessible
   Nan::HandleScope scope;
 
-  pixelFn *fn = reinterpret_cast<pixelFn *>(async->data);
-  Local<Array> sources = Nan::New<Array>(fn->call.num);
-  size_t len = fn->call.width * fn->call.height;
-  for (size_t i = 0; i < fn->call.num; i++) {
-    Nan::Set(sources, i, TypedArray::New(fn->call.inType, fn->call.sources[i], len));
-  }
-  Local<Value> destination = TypedArray::New(fn->call.outType, fn->call.destination, len);
-  Local<Number> width = Nan::New<Number>(fn->call.width);
-  Local<Number> height = Nan::New<Number>(fn->call.height);
-
-  Local<Object> pfArgs = Nan::New<Object>();
-  if (fn->call.args.size() > 0) {
-    for (auto const &el : fn->call.args) {
-      char *end;
-      double dval = std::strtod(el.second.c_str(), &end);
-      if (*end == 0)
-        Nan::Set(pfArgs, Nan::New(el.first).ToLocalChecked(), Nan::New(dval));
-      else
-        Nan::Set(pfArgs, Nan::New(el.first).ToLocalChecked(), Nan::New(el.second).ToLocalChecked());
+  Nan::TryCatch try_catch;
+  size_t len = call.width * call.height;
+  Local<Array> sources = Nan::New<Array>(call.num);
+  Local<Value> destination;
+  try {
+    for (size_t i = 0; i < call.num; i++) {
+      Nan::Set(sources, i, pixelFnGetView(fn, call.sources[i], call.inType, len));
     }
+    destination = pixelFnGetView(fn, call.destination, call.outType, len);
+  } catch (const char *e) {
+    call.err = e;
+    call.failed = true;
+    return;
   }
+  Local<Number> width = Nan::New<Number>(call.width);
+  Local<Number> height = Nan::New<Number>(call.height);
 
-  Local<Value> args[] = {sources, destination, pfArgs, width, height};
+  Local<Value> args[] = {sources, destination, pixelFnGetArgs(fn, call), width, height};
 
-  fn->call.err = nullptr;
-  Nan::TryCatch try_catch;
   // async_hooks do not make any sense for pixel functions
   Nan::Call(*fn->fn, 5, args);
-  if (try_catch.HasCaught()) fn->call.err = new Nan::Utf8String(try_catch.Message()->Get());
+  if (try_catch.HasCaught()) {
+    call.err = *Nan::Utf8String(try_catch.Message()->Get());
+    call.failed = true;
+  }
+}
 
-  // unlock the worker thread (the function below)
-  uv_sem_post(&fn->returnJS);
+// Drains the queue of the pending calls, the worker threads are
+// released one by one as soon as their call has returned
+// The uv_async_send in the function below is what triggers this call
+static void drainJSpfn(uv_async_t *async) {
+  pixelFn *fn = reinterpret_cast<pixelFn *>(async->data);
+  std::vector<pixelFnCall *> calls;
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> lock(fn->queueLock);
+      calls.swap(fn->queue);
+    }
+    if (calls.empty()) break;
+    for (pixelFnCall *call : calls) {
+      callJSpfn(fn, *call);
+      {
+        std::lock_guard<std::mutex> lock(fn->queueLock);
+        call->done = true;
+      }
+      fn->returned.notify_all();
+    }
+    calls.clear();
+  }
 }
 
 // This is the GDAL pixel function trampoline that calls the JS callback
-// It is called on one of the libuv async worker threads
-// It throws when called on the main thread to avoid deadlocking
+// It is called either on one of the libuv async worker threads, in which case
+// the call is queued for the main thread, or on the main thread in sync mode
 static CPLErr pixelFunc(
   void **papoSources,
   int nSources,
@@ -688,7 +1016,12 @@ static CPLErr pixelFunc(
   }
   char *end;
   size_t id = std::strtoul(uid->second.c_str(), &end, 16);
-  if (end == uid->second.c_str() || id >= pixelFuncs.size()) {
+  pixelFn *fn = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(pixelFuncsLock);
+    if (end != uid->second.c_str() && id < pixelFuncs.size()) fn = pixelFuncs[id].get();
+  }
+  if (fn == nullptr) {
     CPLError(CE_Failure, CPLE_AppDefined, "gdal-async Internal error, pixelFuncs inconsistency");
     return CE_Failure;
   }
@@ -702,11 +1035,12 @@ static CPLErr pixelFunc(
     return CE_Failure;
   }
 
-  uv_async_t *async = new uv_async_t;
-  async->data = &pixelFuncs[id];
-
-  uv_mutex_lock(&pixelFuncs[id].callJS);
-  pixelFuncs[id].call = {
+  std::string argsKey;
+  for (CSLConstList arg = papszFunctionArgs; arg != nullptr && *arg != nullptr; arg++) {
+    argsKey += *arg;
+    argsKey += '\n';
+  }
+  pixelFnCall call = {
     papoSources,
     static_cast<size_t>(nSources),
     pData,
@@ -715,43 +1049,78 @@ static CPLErr pixelFunc(
     eSrcType,
     eBufType,
     std::move(pfArgsMap),
-    nullptr};
-  if (std::this_thread::get_id() == mainV8ThreadId) {
-    // Main thread = sync mode
-    // Here we are abusing an uninitialized uv_async_t as a data holder
-    callJSpfn(async);
-    delete async;
+    std::move(argsKey),
+    std::string(),
+    false,
+    false};
+
+  if (std::this_thread::get_id() == fn->thread) {
+    // Main thread of the isolate = sync mode
+    if (fn->closed) {
+      CPLError(CE_Failure, CPLE_AppDefined, "The pixel function belongs to an environment that has been destroyed");
+      return CE_Failure;
+    }
+    callJSpfn(fn, call);
   } else {
     // Worker thread = async mode
-    uv_async_init(uv_default_loop(), async, callJSpfn);
-
-    uv_async_send(async);
-    uv_sem_wait(&pixelFuncs[id].returnJS);
-
-    uv_close(reinterpret_cast<uv_handle_t *>(async), [](uv_handle_t *handle) {
-      uv_async_t *async = reinterpret_cast<uv_async_t *>(handle);
-      delete async;
-    });
+    std::unique_lock<std::mutex> lock(fn->queueLock);
+    if (fn->closed) {
+      CPLError(CE_Failure, CPLE_AppDefined, "The pixel function belongs to an environment that has been destroyed");
+      return CE_Failure;
+    }
+    fn->queue.push_back(&call);
+    uv_async_send(fn->async);
+    fn->returned.wait(lock, [&call] { return call.done; });
   }
-  uv_mutex_unlock(&pixelFuncs[id].callJS);
 
-  if (pixelFuncs[id].call.err != nullptr) {
-    CPLError(CE_Failure, CPLE_AppDefined, "Pixel function error: %s", **pixelFuncs[id].call.err);
-    delete pixelFuncs[id].call.err;
-    pixelFuncs[id].call.err = nullptr;
+  if (call.failed) {
+    CPLError(CE_Failure, CPLE_AppDefined, "Pixel function error: %s", call.err.c_str());
     return CE_Failure;
   }
 
   return CE_None;
 }
+
+// Called when the environment of the isolate is destroyed, the handles
+// must be closed before its event loop and the pending calls fail
+void Algorithms::shutdown() {
+  std::lock_guard<std::mutex> lock(pixelFuncsLock);
+  for (auto &fn : pixelFuncs) {
+    if (fn->thread != std::this_thread::get_id() || fn->closed) continue;
+    std::lock_guard<std::mutex> queueLock(fn->queueLock);
+    fn->closed = true;
+    for (pixelFnCall *call : fn->queue) {
+      call->err = "The environment has been destroyed";
+      call->failed = true;
+      call->done = true;
+    }
+    fn->queue.clear();
+    fn->returned.notify_all();
+    uv_close(reinterpret_cast<uv_handle_t *>(fn->async), [](uv_handle_t *h) { delete reinterpret_cast<uv_async_t *>(h); });
+    fn->async = nullptr;
+    // The persistent handles cannot outlive the isolate
+    fn->views.clear();
+    fn->argsCache.clear();
+  }
+}
+#else
+void Algorithms::shutdown() {
+}
 #endif
 
 /**
  * Create a GDAL pixel function from a JS function.
  *
  * As V8, and JS in general, can only have a single active JS context per isolate,
- * even when using async I/O, the pixel function will be called on the main thread.
+ * even when using async I/O, the pixel function will be called on the main thread
+ * (or on the thread of the `worker_threads` Worker that created it).
  * This can lead to increased latency when serving network requests.
+ * The calls coming from concurrent async operations are queued and are all
+ * executed in a single iteration of the event loop.
+ *
+ * The TypedArrays passed to the function point directly to the GDAL buffers
+ * and must not be used once it has returned, the `args` object is shared by
+ * all the calls with the same arguments and must not be modified.
  *
  * You can check the `gdal-exprtk` plugin for an alternative
  * which uses ExprTk expressions and does not suffer from this problem.
@@ -784,10 +1153,18 @@ NAN_METHOD(Algorithms::toPixelFunc) {
   Nan::Callback *pfn;
   NODE_ARG_CB(0, "pixelFn", pfn);
 
-  size_t uid = pixelFuncs.size();
-  pixelFuncs.push_back({pfn, {}, {}, {}});
-  uv_mutex_init(&pixelFuncs[uid].callJS);
-  uv_sem_init(&pixelFuncs[uid].returnJS, 0);
+  pixelFn *fn = new pixelFn(pfn);
+  fn->async = new uv_async_t;
+  fn->async->data = fn;
+  uv_async_init(fn->loop, fn->async, drainJSpfn);
+  // The handle must not keep the process alive
+  uv_unref(reinterpret_cast<uv_handle_t *>(fn->async));
+  size_t uid;
+  {
+    std::lock_guard<std::mutex> lock(pixelFuncsLock);
+    uid = pixelFuncs.size();
+    pixelFuncs.emplace_back(fn);
+  }
 
   std::string metadata;
   metadata.reserve(strlen(metadataTemplate) + 32);
@@ -27,15 +27,18 @@ namespace node_gdal {
 namespace Algorithms {
 
 void Initialize(Local<Object> target);
+void shutdown();
 
 GDAL_ASYNCABLE_GLOBAL(fillNodata);
 GDAL_ASYNCABLE_GLOBAL(contourGenerate);
 GDAL_ASYNCABLE_GLOBAL(sieveFilter);
 GDAL_ASYNCABLE_GLOBAL(checksumImage);
 GDAL_ASYNCABLE_GLOBAL(polygonize);
+GDAL_ASYNCABLE_GLOBAL(zonalStatistics);
 NAN_METHOD(addPixelFunc);
 NAN_METHOD(toPixelFunc);
 GDAL_ASYNCABLE_GLOBAL(_acquireLocks);
+GDAL_ASYNCABLE_GLOBAL(_calcExpression);
 } // namespace Algorithms
 } // namespace node_gdal
 
@@ -14,7 +14,7 @@ namespace node_gdal {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
 
-Nan::Persistent<FunctionTemplate> Attribute::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Attribute::constructor;
 
 void Attribute::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -109,6 +109,10 @@ Local<Value> Attribute::New(std::shared_ptr<GDALAttribute> raw, GDALDataset *par
   long parent_uid = unwrapped_ds->uid;
 
   wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid);
+  if (wrapped->uid == 0) {
+    Nan::ThrowError("Parent Dataset object has already been destroyed");
+    return scope.Escape(Nan::Undefined());
+  }
   wrapped->parent_ds = parent_ds;
   wrapped->parent_uid = parent_uid;
 
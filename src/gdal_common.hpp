@@ -306,6 +306,19 @@ NAN_SETTER(READ_ONLY_SETTER);
     }                                                                                                                  \
   }
 
+#define NODE_BOOL_FROM_OBJ_OPT(obj, key, var)                                                                          \
+  {                                                                                                                    \
+    Local<String> sym = Nan::New(key).ToLocalChecked();                                                                \
+    if (Nan::HasOwnProperty(obj, sym).FromMaybe(false)) {                                                              \
+      Local<Value> val = Nan::Get(obj, sym).ToLocalChecked();                                                          \
+      if (!val->IsBoolean() && !val->IsUndefined()) {                                                                  \
+        Nan::ThrowTypeError("Property \"" key "\" must be a boolean");                                                 \
+        return;                                                                                                        \
+      }                                                                                                                \
+      if (val->IsBoolean()) var = Nan::To<bool>(val).ToChecked();                                                      \
+    }                                                                                                                  \
+  }
+
 #define NODE_STR_FROM_OBJ_OPT(obj, key, var)                                                                           \
   {                                                                                                                    \
     Local<String> sym = Nan::New(key).ToLocalChecked();                                                                \
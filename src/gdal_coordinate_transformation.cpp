@@ -6,7 +6,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> CoordinateTransformation::constructor;
+thread_local Nan::Persistent<FunctionTemplate> CoordinateTransformation::constructor;
 
 void CoordinateTransformation::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
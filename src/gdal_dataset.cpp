@@ -1,6 +1,7 @@
 #include "gdal_dataset.hpp"
 #include "gdal_group.hpp"
 #include "collections/dataset_bands.hpp"
+#include "collections/dataset_pixels.hpp"
 #include "collections/dataset_layers.hpp"
 #include "gdal_common.hpp"
 #include "gdal_driver.hpp"
@@ -10,10 +11,13 @@
 #include "gdal_rasterband.hpp"
 #include "gdal_spatial_reference.hpp"
 #include "utils/string_list.hpp"
+#include "utils/tile_renderer.hpp"
+#include "utils/typed_array.hpp"
+#include "utils/warp_options.hpp"
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Dataset::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Dataset::constructor;
 
 void Dataset::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -34,10 +38,13 @@ void Dataset::Initialize(Local<Object> target) {
   Nan::SetPrototypeMethod(lcons, "testCapability", testCapability);
   Nan__SetPrototypeAsyncableMethod(lcons, "executeSQL", executeSQL);
   Nan__SetPrototypeAsyncableMethod(lcons, "buildOverviews", buildOverviews);
+  Nan__SetPrototypeAsyncableMethod(lcons, "batch", batch);
+  Nan__SetPrototypeAsyncableMethod(lcons, "renderTile", renderTile);
 
   ATTR_DONT_ENUM(lcons, "_uid", uidGetter, READ_ONLY_SETTER);
   ATTR(lcons, "description", descriptionGetter, READ_ONLY_SETTER);
   ATTR(lcons, "bands", bandsGetter, READ_ONLY_SETTER);
+  ATTR(lcons, "pixels", pixelsGetter, READ_ONLY_SETTER);
   ATTR(lcons, "layers", layersGetter, READ_ONLY_SETTER);
   ATTR_ASYNCABLE(lcons, "rasterSize", rasterSizeGetter, READ_ONLY_SETTER);
   ATTR(lcons, "driver", driverGetter, READ_ONLY_SETTER);
@@ -100,19 +107,22 @@ NAN_METHOD(Dataset::New) {
     Local<Value> layers = DatasetLayers::New(info.This());
     Nan::SetPrivate(info.This(), Nan::New("layers_").ToLocalChecked(), layers);
 
-    Local<Value> rootObj, bandsObj;
+    Local<Value> rootObj, bandsObj, pixelsObj;
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
     GDALDataset *gdal_ds = f->get();
     std::shared_ptr<GDALGroup> root = gdal_ds->GetRootGroup();
     if (root == nullptr) {
 #endif
       bandsObj = DatasetBands::New(info.This());
+      pixelsObj = DatasetPixels::New(info.This());
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
     } else {
       bandsObj = Nan::Null();
+      pixelsObj = Nan::Null();
     }
 #endif
     Nan::SetPrivate(info.This(), Nan::New("bands_").ToLocalChecked(), bandsObj);
+    Nan::SetPrivate(info.This(), Nan::New("pixels_").ToLocalChecked(), pixelsObj);
     if (f->parent_ds)
       // For dependent Datasets, keep a reference on the parent to protect it from the GC
       Nan::SetPrivate(info.This(), Nan::New("parent_").ToLocalChecked(), object_store.get(f->parent_ds));
@@ -146,6 +156,10 @@ Local<Value> Dataset::New(GDALDataset *raw, GDALDataset *parent) {
     Nan::NewInstance(Nan::GetFunction(Nan::New(Dataset::constructor)).ToLocalChecked(), 1, &ext).ToLocalChecked();
 
   wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid);
+  if (wrapped->uid == 0) {
+    Nan::ThrowError("Parent Dataset object has already been destroyed");
+    return scope.Escape(Nan::Undefined());
+  }
 
   return scope.Escape(obj);
 }
@@ -663,7 +677,7 @@ GDAL_ASYNCABLE_DEFINE(Dataset::buildOverviews) {
   // because the lambda becomes non-copyable
   // But we can use a shared_ptr because the lifetime of the lambda is limited by the lifetime
   // of the async worker
-  job.main = [raw, resampling, n_overviews, o, n_bands, b, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [raw, resampling, n_overviews, o, n_bands, b](const GDALExecutionProgress &progress) {
     if (b != nullptr) {
       for (int i = 0; i < n_bands; i++) {
         if (b.get()[i] > raw->GetRasterCount() || b.get()[i] < 1) { throw "invalid band id"; }
@@ -676,8 +690,8 @@ GDAL_ASYNCABLE_DEFINE(Dataset::buildOverviews) {
       o.get(),
       n_bands,
       b.get(),
-      progress_cb ? ProgressTrampoline : nullptr,
-      progress_cb ? (void *)&progress : nullptr);
+      progress.trampoline(),
+      (void *)&progress);
     if (err != CE_None) { throw CPLGetLastErrorMsg(); }
     return err;
   };
@@ -686,6 +700,430 @@ GDAL_ASYNCABLE_DEFINE(Dataset::buildOverviews) {
   job.run(info, async, 4);
 }
 
+// One operation of a batch, parsed in the main thread
+struct BatchOp {
+  enum { RasterSize, GeoTransform, SRS, BandCount, Band, NoDataValue, Read } kind;
+  int band;
+  int x, y, w, h;
+  int buffer_w, buffer_h;
+  GDALDataType type;
+  void *data;
+};
+
+// The result of one operation of a batch, produced in the worker thread
+struct BatchResult {
+  bool null;
+  int x, y;
+  double values[6];
+  GDALRasterBand *band;
+  std::unique_ptr<OGRSpatialReference> srs;
+};
+
+/**
+ * @typedef {object} BatchOperation
+ * @property {string} op `"rasterSize"`, `"geoTransform"`, `"srs"`, `"bandCount"`, `"band"`, `"noDataValue"` or `"read"`
+ * @property {number} [band] Band number, required by `"band"`, `"noDataValue"` and `"read"`
+ * @property {number} [x] Required by `"read"`
+ * @property {number} [y] Required by `"read"`
+ * @property {number} [width] Required by `"read"`
+ * @property {number} [height] Required by `"read"`
+ * @property {TypedArray} [data] The TypedArray to put the data in, a new array is created if not given
+ * @property {string} [type] Data type of the new array, the band data type if not given
+ * @property {number} [buffer_width]
+ * @property {number} [buffer_height]
+ */
+
+/**
+ * Executes a list of read-only operations on the dataset while holding
+ * the dataset lock only once.
+ *
+ * Returns an array with the result of each operation in the same order:
+ * `rasterSize` => `xyz|null`, `geoTransform` => `number[]|null`, `srs` => `SpatialReference|null`,
+ * `bandCount` => `number`, `band` => `RasterBand`, `noDataValue` => `number|null`, `read` => `TypedArray`
+ *
+ * @example
+ *
+ * const [ size, gt, band, pixels ] = ds.batch([
+ *   { op: 'rasterSize' },
+ *   { op: 'geoTransform' },
+ *   { op: 'band', band: 1 },
+ *   { op: 'read', band: 1, x: 0, y: 0, width: 256, height: 256 }
+ * ])
+ *
+ * @throws Error
+ * @method batch
+ * @instance
+ * @memberof Dataset
+ * @param {BatchOperation[]} operations
+ * @return {any[]}
+ */
+
+/**
+ * Executes a list of read-only operations on the dataset as a single
+ * asynchronous job holding the dataset lock only once.
+ * @async
+ *
+ * Returns an array with the result of each operation in the same order:
+ * `rasterSize` => `xyz|null`, `geoTransform` => `number[]|null`, `srs` => `SpatialReference|null`,
+ * `bandCount` => `number`, `band` => `RasterBand`, `noDataValue` => `number|null`, `read` => `TypedArray`
+ *
+ * @example
+ *
+ * const [ size, gt, band, pixels ] = await ds.batchAsync([
+ *   { op: 'rasterSize' },
+ *   { op: 'geoTransform' },
+ *   { op: 'band', band: 1 },
+ *   { op: 'read', band: 1, x: 0, y: 0, width: 256, height: 256 }
+ * ])
+ *
+ * @throws Error
+ * @method batchAsync
+ * @instance
+ * @memberof Dataset
+ * @param {BatchOperation[]} operations
+ * @param {callback<any[]>} [callback=undefined]
+ * @return {Promise<any[]>}
+ */
+GDAL_ASYNCABLE_DEFINE(Dataset::batch) {
+
+  NODE_UNWRAP_CHECK(Dataset, info.This(), ds);
+  GDAL_RAW_CHECK(GDALDataset *, ds, raw);
+
+  Local<Array> list;
+  NODE_ARG_ARRAY(0, "operations", list);
+
+  GDALAsyncableJob<std::shared_ptr<std::vector<BatchResult>>> job(ds->uid);
+  std::vector<BatchOp> ops(list->Length());
+  // Only the operations returning a RasterBand object need the main handle
+  bool poolable = true;
+
+  for (unsigned i = 0; i < ops.size(); i++) {
+    BatchOp &op = ops[i];
+    Local<Value> val = Nan::Get(list, i).ToLocalChecked();
+    if (!val->IsObject()) {
+      Nan::ThrowTypeError("operations must be an array of objects");
+      return;
+    }
+    Local<Object> obj = val.As<Object>();
+
+    std::string name;
+    NODE_STR_FROM_OBJ(obj, "op", name);
+    op.band = 0;
+    if (name == "rasterSize")
+      op.kind = BatchOp::RasterSize;
+    else if (name == "geoTransform")
+      op.kind = BatchOp::GeoTransform;
+    else if (name == "srs")
+      op.kind = BatchOp::SRS;
+    else if (name == "bandCount")
+      op.kind = BatchOp::BandCount;
+    else if (name == "band")
+      op.kind = BatchOp::Band;
+    else if (name == "noDataValue")
+      op.kind = BatchOp::NoDataValue;
+    else if (name == "read")
+      op.kind = BatchOp::Read;
+    else {
+      Nan::ThrowError(("Invalid batch operation \"" + name + "\"").c_str());
+      return;
+    }
+
+    if (op.kind == BatchOp::Band || op.kind == BatchOp::NoDataValue || op.kind == BatchOp::Read) {
+      NODE_INT_FROM_OBJ(obj, "band", op.band);
+      if (op.band < 1 || op.band > raw->GetRasterCount()) {
+        Nan::ThrowRangeError("Invalid band number");
+        return;
+      }
+    }
+    if (op.kind == BatchOp::Band) poolable = false;
+    if (op.kind != BatchOp::Read) continue;
+
+    NODE_INT_FROM_OBJ(obj, "x", op.x);
+    NODE_INT_FROM_OBJ(obj, "y", op.y);
+    NODE_INT_FROM_OBJ(obj, "width", op.w);
+    NODE_INT_FROM_OBJ(obj, "height", op.h);
+    op.buffer_w = op.w;
+    op.buffer_h = op.h;
+    NODE_INT_FROM_OBJ_OPT(obj, "buffer_width", op.buffer_w);
+    NODE_INT_FROM_OBJ_OPT(obj, "buffer_height", op.buffer_h);
+    if (op.buffer_w <= 0 || op.buffer_h <= 0) {
+      Nan::ThrowRangeError("Invalid buffer size");
+      return;
+    }
+
+    std::string type_name = "";
+    NODE_STR_FROM_OBJ_OPT(obj, "type", type_name);
+    op.type = raw->GetRasterBand(op.band)->GetRasterDataType();
+    if (!type_name.empty()) op.type = GDALGetDataTypeByName(type_name.c_str());
+
+    Local<Object> array;
+    Local<Value> data = Nan::Get(obj, Nan::New("data").ToLocalChecked()).ToLocalChecked();
+    if (data->IsObject()) {
+      array = data.As<Object>();
+      op.type = TypedArray::Identify(array);
+    }
+    if (op.type == GDT_Unknown) {
+      Nan::ThrowError("Invalid array");
+      return;
+    }
+
+    int length = op.buffer_w * op.buffer_h;
+    if (array.IsEmpty()) {
+      Local<Value> created = TypedArray::New(op.type, length);
+      if (created.IsEmpty() || !created->IsObject()) {
+        return; // TypedArray::New threw an error
+      }
+      array = created.As<Object>();
+    }
+    op.data = TypedArray::Validate(array, op.type, length);
+    if (!op.data) {
+      return; // TypedArray::Validate threw an error
+    }
+    job.persist("array" + std::to_string(i), array);
+  }
+
+  job.pooled = poolable;
+  job.main = [raw, ops](const GDALExecutionProgress &progress) {
+    GDALDataset *gdal_ds = progress.pooledDataset(raw);
+    auto results = std::make_shared<std::vector<BatchResult>>(ops.size());
+    for (size_t i = 0; i < ops.size(); i++) {
+      const BatchOp &op = ops[i];
+      BatchResult &r = (*results)[i];
+      if (progress.isAborted()) throw abortedError;
+      r.null = false;
+      CPLErrorReset();
+      switch (op.kind) {
+        case BatchOp::RasterSize:
+          if (gdal_ds->GetDriver() == nullptr || !gdal_ds->GetDriver()->GetMetadataItem(GDAL_DCAP_RASTER)) {
+            r.null = true;
+            break;
+          }
+          r.x = gdal_ds->GetRasterXSize();
+          r.y = gdal_ds->GetRasterYSize();
+          break;
+        case BatchOp::GeoTransform: r.null = gdal_ds->GetGeoTransform(r.values) != CE_None; break;
+        case BatchOp::SRS: {
+          OGRChar *wkt = (OGRChar *)gdal_ds->GetProjectionRef();
+          if (*wkt == '\0') {
+            r.null = true;
+            break;
+          }
+          r.srs = std::unique_ptr<OGRSpatialReference>(new OGRSpatialReference());
+          int err = r.srs->importFromWkt(&wkt);
+          if (err) throw getOGRErrMsg(err);
+          break;
+        }
+        case BatchOp::BandCount: r.x = gdal_ds->GetRasterCount(); break;
+        case BatchOp::Band:
+          r.band = raw->GetRasterBand(op.band);
+          if (r.band == nullptr) throw CPLGetLastErrorMsg();
+          break;
+        case BatchOp::NoDataValue: {
+          GDALRasterBand *band = gdal_ds->GetRasterBand(op.band);
+          if (band == nullptr) throw CPLGetLastErrorMsg();
+          int success = 0;
+          r.values[0] = band->GetNoDataValue(&success);
+          r.null = !success;
+          break;
+        }
+        case BatchOp::Read: {
+          GDALRasterBand *band = gdal_ds->GetRasterBand(op.band);
+          if (band == nullptr) throw CPLGetLastErrorMsg();
+          CPLErr err = band->RasterIO(
+            GF_Read, op.x, op.y, op.w, op.h, op.data, op.buffer_w, op.buffer_h, op.type, 0, 0, nullptr);
+          if (err != CE_None) throw CPLGetLastErrorMsg();
+          break;
+        }
+      }
+    }
+    return results;
+  };
+
+  job.rval = [raw, ops](std::shared_ptr<std::vector<BatchResult>> results, const GetFromPersistentFunc &getter) {
+    Nan::EscapableHandleScope scope;
+    Local<Array> rval = Nan::New<Array>(results->size());
+    for (unsigned i = 0; i < results->size(); i++) {
+      BatchResult &r = (*results)[i];
+      Local<Value> val = Nan::Null();
+      if (!r.null) {
+        switch (ops[i].kind) {
+          case BatchOp::RasterSize: {
+            Local<Object> xy = Nan::New<Object>();
+            Nan::Set(xy, Nan::New("x").ToLocalChecked(), Nan::New<Integer>(r.x));
+            Nan::Set(xy, Nan::New("y").ToLocalChecked(), Nan::New<Integer>(r.y));
+            val = xy;
+            break;
+          }
+          case BatchOp::GeoTransform: {
+            Local<Array> gt = Nan::New<Array>(6);
+            for (int j = 0; j < 6; j++) Nan::Set(gt, j, Nan::New<Number>(r.values[j]));
+            val = gt;
+            break;
+          }
+          case BatchOp::SRS: val = SpatialReference::New(r.srs.release(), true); break;
+          case BatchOp::BandCount: val = Nan::New<Integer>(r.x); break;
+          case BatchOp::Band: val = RasterBand::New(r.band, raw); break;
+          case BatchOp::NoDataValue: val = Nan::New<Number>(r.values[0]); break;
+          case BatchOp::Read: val = getter(("array" + std::to_string(i)).c_str()); break;
+        }
+      }
+      Nan::Set(rval, i, val);
+    }
+    return scope.Escape(rval.As<Value>());
+  };
+
+  job.run(info, async, 1);
+}
+
+/**
+ * @typedef {object} TileOptions
+ * @property {number} z
+ * @property {number} x
+ * @property {number} y
+ * @property {number} [tileSize]
+ * @property {string} [srs]
+ * @property {string} [resampling]
+ * @property {string} [format]
+ * @property {number[]} [bands]
+ * @property {boolean} [alpha]
+ * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
+ */
+
+/**
+ * Renders a tile of a XYZ / WMTS tile matrix set.
+ *
+ * The tile is warped from the overview that best matches its resolution
+ * directly into an image buffer and encoded without any intermediate Dataset.
+ * The coordinate transformation is created only once per Dataset and matrix set.
+ *
+ * The bands are all the bands of the Dataset except its alpha band by default.
+ * The PNG and WEBP drivers support only Byte data (and UInt16 for PNG), `raw`
+ * returns the pixel-interleaved values in the data type of the first band.
+ *
+ * @example
+ * const ds = gdal.openPool('ortho.tif', { handles: 4 })
+ * app.get('/tiles/:z/:x/:y.png', async (req, res) => {
+ *   const { z, x, y } = req.params
+ *   res.type('png').send(await ds.renderTileAsync({ z: +z, x: +x, y: +y, resampling: gdal.GRA_Bilinear }))
+ * })
+ *
+ * @throws Error
+ * @method renderTile
+ * @instance
+ * @memberof Dataset
+ * @param {TileOptions} options
+ * @param {number} options.z Zoom level
+ * @param {number} options.x Column, from the left
+ * @param {number} options.y Row, from the top
+ * @param {number} [options.tileSize=256]
+ * @param {string} [options.srs=EPSG:3857] `EPSG:3857` (WebMercatorQuad) or `EPSG:4326` (WorldCRS84Quad)
+ * @param {string} [options.resampling=NearestNeighbor] Resampling algorithm ({@link GRA|available options})
+ * @param {string} [options.format=png] `png`, `webp` or `raw`, `webp` requires 1 (expanded to RGB) or 3 bands
+ * @param {number[]} [options.bands] The band numbers
+ * @param {boolean} [options.alpha] Add an alpha band, by default for `png` and `webp`
+ * @param {ProgressCb} [options.progress_cb]
+ * @return {Buffer}
+ */
+
+/**
+ * Renders a tile of a XYZ / WMTS tile matrix set.
+ * @async
+ *
+ * The tile is warped from the overview that best matches its resolution
+ * directly into an image buffer and encoded without any intermediate Dataset.
+ * The coordinate transformation is created only once per Dataset and matrix set.
+ *
+ * The bands are all the bands of the Dataset except its alpha band by default.
+ * The PNG and WEBP drivers support only Byte data (and UInt16 for PNG), `raw`
+ * returns the pixel-interleaved values in the data type of the first band.
+ *
+ * Tiles of a Dataset opened with {@link gdal.openPool} are rendered in parallel.
+ *
+ * @throws Error
+ * @method renderTileAsync
+ * @instance
+ * @memberof Dataset
+ * @param {TileOptions} options
+ * @param {number} options.z Zoom level
+ * @param {number} options.x Column, from the left
+ * @param {number} options.y Row, from the top
+ * @param {number} [options.tileSize=256]
+ * @param {string} [options.srs=EPSG:3857] `EPSG:3857` (WebMercatorQuad) or `EPSG:4326` (WorldCRS84Quad)
+ * @param {string} [options.resampling=NearestNeighbor] Resampling algorithm ({@link GRA|available options})
+ * @param {string} [options.format=png] `png`, `webp` or `raw`, `webp` requires 1 (expanded to RGB) or 3 bands
+ * @param {number[]} [options.bands] The band numbers
+ * @param {boolean} [options.alpha] Add an alpha band, by default for `png` and `webp`
+ * @param {ProgressCb} [options.progress_cb]
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
+ * @param {callback<Buffer>} [callback=undefined]
+ * @return {Promise<Buffer>}
+ */
+GDAL_ASYNCABLE_DEFINE(Dataset::renderTile) {
+  NODE_UNWRAP_CHECK(Dataset, info.This(), ds);
+  GDAL_RAW_CHECK(GDALDataset *, ds, raw);
+
+  Local<Object> options;
+  Local<Array> band_list;
+  Nan::Callback *progress_cb = nullptr;
+  TileRequest tile;
+  tile.size = 256;
+  tile.srs = "EPSG:3857";
+  tile.format = "png";
+
+  NODE_ARG_OBJECT(0, "options", options);
+  NODE_INT_FROM_OBJ(options, "z", tile.z);
+  NODE_INT_FROM_OBJ(options, "x", tile.x);
+  NODE_INT_FROM_OBJ(options, "y", tile.y);
+  NODE_INT_FROM_OBJ_OPT(options, "tileSize", tile.size);
+  NODE_STR_FROM_OBJ_OPT(options, "srs", tile.srs);
+  NODE_STR_FROM_OBJ_OPT(options, "format", tile.format);
+  NODE_ARRAY_FROM_OBJ_OPT(options, "bands", band_list);
+  tile.alpha = tile.format != "raw";
+  NODE_BOOL_FROM_OBJ_OPT(options, "alpha", tile.alpha);
+  NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
+
+  WarpOptions warp;
+  if (warp.parseResamplingAlg(Nan::Get(options, Nan::New("resampling").ToLocalChecked()).ToLocalChecked())) return;
+  tile.resampling = warp.get()->eResampleAlg;
+
+  if (!band_list.IsEmpty()) {
+    for (unsigned i = 0; i < band_list->Length(); i++) {
+      Local<Value> id = Nan::Get(band_list, i).ToLocalChecked();
+      if (!id->IsInt32()) {
+        Nan::ThrowError("bands must be an array of band numbers");
+        return;
+      }
+      tile.bands.push_back(Nan::To<int32_t>(id).ToChecked());
+    }
+  }
+
+  const char *error = validateTile(tile);
+  if (error != nullptr) {
+    Nan::ThrowError(error);
+    return;
+  }
+
+  long uid = ds->uid;
+  GDALAsyncableJob<RenderedTile> job(uid);
+  job.progress = progress_cb;
+  job.pooled = true;
+  job.main = [raw, uid, tile](const GDALExecutionProgress &progress) {
+    return renderTile(progress, uid, progress.pooledDataset(raw), tile);
+  };
+  job.rval = [](RenderedTile r, const GetFromPersistentFunc &) {
+    return Nan::NewBuffer(
+             reinterpret_cast<char *>(r.data), r.length, [](char *data, void *) { VSIFree(data); }, nullptr)
+      .ToLocalChecked()
+      .As<Value>();
+  };
+  job.run(info, async, 1);
+}
+
 /**
  * @readonly
  * @kind member
@@ -1008,6 +1446,20 @@ NAN_GETTER(Dataset::bandsGetter) {
   info.GetReturnValue().Set(Nan::GetPrivate(info.This(), Nan::New("bands_").ToLocalChecked()).ToLocalChecked());
 }
 
+/**
+ * The pixels of several bands, read or written in a single operation
+ *
+ * @readonly
+ * @kind member
+ * @name pixels
+ * @instance
+ * @memberof Dataset
+ * @type {DatasetPixels}
+ */
+NAN_GETTER(Dataset::pixelsGetter) {
+  info.GetReturnValue().Set(Nan::GetPrivate(info.This(), Nan::New("pixels_").ToLocalChecked()).ToLocalChecked());
+}
+
 /**
  * @readonly
  * @kind member
@@ -27,7 +27,7 @@ namespace node_gdal {
 
 class Dataset : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
   static Local<Value> New(GDALDataset *ds, GDALDataset *parent = nullptr);
@@ -42,9 +42,12 @@ class Dataset : public Nan::ObjectWrap {
   GDAL_ASYNCABLE_DECLARE(executeSQL);
   static NAN_METHOD(testCapability);
   GDAL_ASYNCABLE_DECLARE(buildOverviews);
+  GDAL_ASYNCABLE_DECLARE(batch);
+  GDAL_ASYNCABLE_DECLARE(renderTile);
   static NAN_METHOD(close);
 
   static NAN_GETTER(bandsGetter);
+  static NAN_GETTER(pixelsGetter);
   GDAL_ASYNCABLE_GETTER_DECLARE(rasterSizeGetter);
   GDAL_ASYNCABLE_GETTER_DECLARE(srsGetter);
   static NAN_GETTER(driverGetter);
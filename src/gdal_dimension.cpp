@@ -14,7 +14,7 @@ namespace node_gdal {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
 
-Nan::Persistent<FunctionTemplate> Dimension::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Dimension::constructor;
 
 void Dimension::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -112,6 +112,10 @@ Local<Value> Dimension::New(std::shared_ptr<GDALDimension> raw, GDALDataset *par
   long parent_uid = unwrapped_ds->uid;
 
   wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid);
+  if (wrapped->uid == 0) {
+    Nan::ThrowError("Parent Dataset object has already been destroyed");
+    return scope.Escape(Nan::Undefined());
+  }
   wrapped->parent_ds = parent_ds;
   wrapped->parent_uid = parent_uid;
 
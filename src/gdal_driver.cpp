@@ -8,7 +8,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Driver::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Driver::constructor;
 
 void Driver::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -315,11 +315,11 @@ GDAL_ASYNCABLE_DEFINE(Driver::createCopy) {
   job.persist(driver->handle());
   job.progress = progress_cb;
 
-  job.main = [raw, filename, raw_ds, strict, options, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [raw, filename, raw_ds, strict, options](const GDALExecutionProgress &progress) {
     std::unique_ptr<StringList> options_ptr(options);
     CPLErrorReset();
     GDALDataset *ds = raw->CreateCopy(
-      filename.c_str(), raw_ds, strict, options->get(), progress_cb ? ProgressTrampoline : nullptr, (void *)&progress);
+      filename.c_str(), raw_ds, strict, options->get(), progress.trampoline(), (void *)&progress);
     if (!ds) throw CPLGetLastErrorMsg();
     return ds;
   };
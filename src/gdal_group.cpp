@@ -15,7 +15,7 @@ namespace node_gdal {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
 
-Nan::Persistent<FunctionTemplate> Group::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Group::constructor;
 
 void Group::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -130,6 +130,10 @@ Local<Value> Group::New(std::shared_ptr<GDALGroup> raw, Local<Object> parent_ds)
   long parent_uid = unwrapped_ds->uid;
 
   wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid);
+  if (wrapped->uid == 0) {
+    Nan::ThrowError("Parent Dataset object has already been destroyed");
+    return scope.Escape(Nan::Undefined());
+  }
   wrapped->parent_ds = unwrapped_ds->get();
   wrapped->parent_uid = parent_uid;
   Nan::SetPrivate(obj, Nan::New("ds_").ToLocalChecked(), parent_ds);
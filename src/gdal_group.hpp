@@ -25,7 +25,7 @@ namespace node_gdal {
 
 class Group : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
   static Local<Value> New(std::shared_ptr<GDALGroup> group, Local<Object> parent_ds);
@@ -15,7 +15,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Layer::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Layer::constructor;
 
 void Layer::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -137,6 +137,10 @@ Local<Value> Layer::New(OGRLayer *raw, GDALDataset *raw_parent, bool result_set)
   long parent_uid = unwrapped->uid;
 
   wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid, result_set);
+  if (wrapped->uid == 0) {
+    Nan::ThrowError("Parent Dataset object has already been destroyed");
+    return scope.Escape(Nan::Undefined());
+  }
   wrapped->parent_ds = raw_parent;
   wrapped->parent_uid = parent_uid;
   Nan::SetPrivate(obj, Nan::New("ds_").ToLocalChecked(), ds);
@@ -20,7 +20,7 @@ namespace node_gdal {
 
 class Layer : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
   static Local<Value> New(OGRLayer *raw, GDALDataset *raw_parent);
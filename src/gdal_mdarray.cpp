@@ -14,7 +14,7 @@ namespace node_gdal {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
 
-Nan::Persistent<FunctionTemplate> MDArray::constructor;
+thread_local Nan::Persistent<FunctionTemplate> MDArray::constructor;
 
 void MDArray::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -128,6 +128,10 @@ Local<Value> MDArray::New(std::shared_ptr<GDALMDArray> raw, GDALDataset *parent_
   long parent_uid = unwrapped_ds->uid;
 
   wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid);
+  if (wrapped->uid == 0) {
+    Nan::ThrowError("Parent Dataset object has already been destroyed");
+    return scope.Escape(Nan::Undefined());
+  }
   wrapped->parent_ds = parent_ds;
   wrapped->parent_uid = parent_uid;
   wrapped->dimensions = dim;
@@ -202,6 +206,7 @@ findHighest(int dimensions, std::shared_ptr<size_t> span, std::shared_ptr<GPtrDi
  * @property {number[]} [stride]
  * @property {string} [data_type]
  * @property {TypedArray} [data]
+ * @property {boolean} [shared]
  * @property {number} [_offset]
  */
 
@@ -224,6 +229,7 @@ findHighest(int dimensions, std::shared_ptr<size_t> span, std::shared_ptr<GPtrDi
  * @param {number[]} [options.stride] An array of strides for the output array, mandatory if the array is specified
  * @param {string} [options.data_type] See {@link GDT|GDT constants}
  * @param {TypedArray} [options.data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {boolean} [options.shared=false] Allocate the array in a SharedArrayBuffer that can be sent to other worker_threads without copying
  * @return {TypedArray}
  */
 
@@ -247,6 +253,7 @@ findHighest(int dimensions, std::shared_ptr<size_t> span, std::shared_ptr<GPtrDi
  * @param {number[]} [options.stride] An array of strides for the output array, mandatory if the array is specified
  * @param {string} [options.data_type] See {@link GDT|GDT constants}
  * @param {TypedArray} [options.data] The TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {boolean} [options.shared=false] Allocate the array in a SharedArrayBuffer that can be sent to other worker_threads without copying
  * @param {ProgressCb} [options.progress_cb]
  * @param {callback<TypedArray>} [callback=undefined]
  * @return {Promise<TypedArray>} A TypedArray (https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
@@ -260,6 +267,7 @@ GDAL_ASYNCABLE_DEFINE(MDArray::read) {
   std::string type_name;
   GDALDataType type = GDT_Byte;
   GPtrDiff_t offset = 0;
+  bool shared = false;
 
   NODE_ARG_OBJECT(0, "options", options);
   NODE_ARRAY_FROM_OBJ(options, "origin", origin);
@@ -267,6 +275,7 @@ GDAL_ASYNCABLE_DEFINE(MDArray::read) {
   NODE_ARRAY_FROM_OBJ_OPT(options, "stride", stride);
   NODE_STR_FROM_OBJ_OPT(options, "data_type", type_name);
   NODE_INT64_FROM_OBJ_OPT(options, "_offset", offset);
+  NODE_BOOL_FROM_OBJ_OPT(options, "shared", shared);
   if (!type_name.empty()) { type = GDALGetDataTypeByName(type_name.c_str()); }
 
   std::shared_ptr<GUInt64> gdal_origin;
@@ -311,7 +320,7 @@ GDAL_ASYNCABLE_DEFINE(MDArray::read) {
       }
       type = exType.GetNumericDataType();
     }
-    data = node_gdal::TypedArray::New(type, length);
+    data = node_gdal::TypedArray::New(type, length, shared);
     if (data.IsEmpty() || !data->IsObject()) {
       Nan::ThrowError("Failed to allocate array");
       return; // TypedArray::New threw an error
@@ -8,7 +8,7 @@ namespace node_gdal {
  * @namespace vsimem
  */
 
-std::map<void *, Memfile *> Memfile::memfile_collection;
+thread_local std::map<void *, Memfile *> Memfile::memfile_collection;
 
 Memfile::Memfile(void *data, const std::string &filename) : data(data), filename(filename) {
 }
@@ -34,7 +34,8 @@ class Memfile {
   static Memfile *get(Local<Object>);
   static Memfile *get(Local<Object>, const std::string &filename);
   static bool copy(Local<Object>, const std::string &filename);
-  static std::map<void *, Memfile *> memfile_collection;
+  // The anonymous files of the current isolate
+  static thread_local std::map<void *, Memfile *> memfile_collection;
 
   static void Initialize(Local<Object> target);
   static NAN_METHOD(vsimemSet);
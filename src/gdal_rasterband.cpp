@@ -8,15 +8,20 @@
 #include "gdal_mdarray.hpp"
 #include "gdal_majorobject.hpp"
 #include "gdal_rasterband.hpp"
+#include "utils/block_reducer.hpp"
 #include "utils/string_list.hpp"
+#include "utils/typed_array.hpp"
 
 #include <cpl_port.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
-#include <mutex>
+#include <string>
+#include <vector>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> RasterBand::constructor;
+thread_local Nan::Persistent<FunctionTemplate> RasterBand::constructor;
 
 void RasterBand::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -34,6 +39,8 @@ void RasterBand::Initialize(Local<Object> target) {
   Nan::SetPrototypeMethod(lcons, "getStatistics", getStatistics);
   Nan::SetPrototypeMethod(lcons, "setStatistics", setStatistics);
   Nan__SetPrototypeAsyncableMethod(lcons, "computeStatistics", computeStatistics);
+  Nan__SetPrototypeAsyncableMethod(lcons, "computeHistogram", computeHistogram);
+  Nan__SetPrototypeAsyncableMethod(lcons, "computePercentiles", computePercentiles);
   Nan::SetPrototypeMethod(lcons, "getMaskBand", getMaskBand);
   Nan::SetPrototypeMethod(lcons, "getMaskFlags", getMaskFlags);
   Nan::SetPrototypeMethod(lcons, "createMaskBand", createMaskBand);
@@ -149,6 +156,10 @@ Local<Value> RasterBand::New(GDALRasterBand *raw, GDALDataset *raw_parent) {
   Dataset *parent = Nan::ObjectWrap::Unwrap<Dataset>(ds);
   long parent_uid = parent->uid;
   wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid);
+  if (wrapped->uid == 0) {
+    Nan::ThrowError("Parent Dataset object has already been destroyed");
+    return scope.Escape(Nan::Undefined());
+  }
   wrapped->parent_ds = raw_parent;
   wrapped->parent_uid = parent_uid;
   Nan::SetPrivate(obj, Nan::New("ds_").ToLocalChecked(), ds);
@@ -289,19 +300,170 @@ GDAL_ASYNCABLE_DEFINE(RasterBand::fill) {
 // --- Custom error handling to handle VRT errors ---
 // see: https://github.com/mapbox/mapnik-omnivore/issues/10
 
-std::mutex stats_lock;
-std::string stats_file_err = "";
-CPLErrorHandler last_err_handler;
-void CPL_STDCALL statisticsErrorHandler(CPLErr eErrClass, int err_no, const char *msg) {
-  if (err_no == CPLE_OpenFailed) { stats_file_err = msg; }
-  if (last_err_handler) { last_err_handler(eErrClass, err_no, msg); }
+// Captures the open errors (ie missing VRT sources) raised while computing
+// the statistics, GDAL does not always report them as a failure
+// The handler is pushed on the error handler stack of the current thread,
+// every computation has its own and they can run concurrently
+// The first open error is recorded and all the errors are passed on to
+// the previous handler, the debug messages do not go through it
+class StatsErrorCapture {
+    public:
+  StatsErrorCapture() : file_err() {
+    push();
+  }
+  ~StatsErrorCapture() {
+    CPLPopErrorHandler();
+  }
+  std::string file_err;
+
+    private:
+  void push() {
+    CPLPushErrorHandlerEx(handler, this);
+    CPLSetCurrentErrorHandlerCatchDebug(FALSE);
+  }
+  static void CPL_STDCALL handler(CPLErr err_class, int err_no, const char *msg) {
+    StatsErrorCapture *self = reinterpret_cast<StatsErrorCapture *>(CPLGetErrorHandlerUserData());
+    if (err_no == CPLE_OpenFailed && self->file_err.empty()) self->file_err = msg;
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 7)
+    CPLCallPreviousHandler(err_class, err_no, msg);
+#else
+    // msg points to the last error message that CPLError() overwrites
+    std::string copy(msg);
+    CPLPopErrorHandler();
+    CPLError(err_class, err_no, "%s", copy.c_str());
+    self->push();
+#endif
+  }
+};
+
+// Exact statistics computed by the block reducer, concurrently on the free
+// handles of a pooled Dataset
+// Only the bands without a mask band or with a NoData mask are supported,
+// supported is set to false if the band must be handled by GDAL
+static CPLErr parallelStatistics(
+  long ds_uid,
+  GDALRasterBand *own_band,
+  int parallel,
+  const GDALExecutionProgress &progress,
+  double *min,
+  double *max,
+  double *mean,
+  double *std_dev,
+  bool &supported) {
+  int flags = own_band->GetMaskFlags();
+  supported = !GDALDataTypeIsComplex(own_band->GetRasterDataType()) && (flags == GMF_ALL_VALID || flags == GMF_NODATA);
+  if (!supported) return CE_None;
+
+  NoDataFilter filter(own_band);
+  PartialStats stats;
+  int w = own_band->GetXSize(), h = own_band->GetYSize();
+  CPLErr err = reduceBlockRows(
+    progress,
+    ds_uid,
+    own_band,
+    -1,
+    0,
+    0,
+    w,
+    h,
+    parallel,
+    stats,
+    [&filter](PartialStats &partial, const double *values, size_t length) {
+      partial.reduce(values, length, filter);
+    });
+  if (err != CE_None) return err;
+  if (stats.count == 0) {
+    CPLError(CE_Failure, CPLE_AppDefined, "Failed to compute statistics, no valid pixels found in sampling.");
+    return CE_Failure;
+  }
+
+  *min = stats.min;
+  *max = stats.max;
+  *mean = stats.mean;
+  *std_dev = stats.std_dev();
+  // Persisted like the statistics computed by GDAL
+  own_band->SetStatistics(*min, *max, *mean, *std_dev);
+  own_band->SetMetadataItem(
+    "STATISTICS_VALID_PERCENT", CPLSPrintf("%.4g", 100.0 * stats.count / (static_cast<double>(w) * h)));
+  return CE_None;
+}
+
+// The region reduced by the histogram and the percentiles, either in the
+// band or, when approximating, in the overview used by GDAL for the
+// approximate statistics
+struct ReducedWindow {
+  int overview, x, y, w, h;
+};
+
+// A negative width/height selects the whole band
+static ReducedWindow reducedWindow(GDALRasterBand *band, bool approx, int x, int y, int w, int h) {
+  if (w < 0) {
+    x = 0;
+    w = band->GetXSize();
+  }
+  if (h < 0) {
+    y = 0;
+    h = band->GetYSize();
+  }
+  ReducedWindow r = {approx ? sampleOverview(band) : -1, x, y, w, h};
+  // An invalid window is left as it is for reduceBlockRows to reject it
+  if (r.overview < 0 || x < 0 || y < 0 || x + w > band->GetXSize() || y + h > band->GetYSize()) return r;
+
+  GDALRasterBand *overview = band->GetOverview(r.overview);
+  double sx = static_cast<double>(overview->GetXSize()) / band->GetXSize();
+  double sy = static_cast<double>(overview->GetYSize()) / band->GetYSize();
+  r.x = static_cast<int>(std::floor(x * sx));
+  r.y = static_cast<int>(std::floor(y * sy));
+  r.w = std::min(std::max(static_cast<int>(std::ceil((x + w) * sx)) - r.x, 1), overview->GetXSize() - r.x);
+  r.h = std::min(std::max(static_cast<int>(std::ceil((y + h) * sy)) - r.y, 1), overview->GetYSize() - r.y);
+  return r;
 }
-void pushStatsErrorHandler() {
-  last_err_handler = CPLSetErrorHandler(statisticsErrorHandler);
+
+// The statistics of the valid pixels of a window, throws on error
+static PartialStats windowStatistics(
+  const GDALExecutionProgress &progress,
+  long ds_uid,
+  GDALRasterBand *band,
+  const ReducedWindow &win,
+  int parallel,
+  const NoDataFilter &filter) {
+  PartialStats stats;
+  CPLErr err = reduceBlockRows(
+    progress,
+    ds_uid,
+    band,
+    win.overview,
+    win.x,
+    win.y,
+    win.w,
+    win.h,
+    parallel,
+    stats,
+    [&filter](PartialStats &partial, const double *values, size_t length) {
+      partial.reduce(values, length, filter);
+    });
+  if (err != CE_None) throw CPLGetLastErrorMsg();
+  return stats;
 }
-void popStatsErrorHandler() {
-  if (!last_err_handler) return;
-  CPLSetErrorHandler(last_err_handler);
+
+// The window option of computeHistogram/computePercentiles, returns an error message
+static const char *parseWindow(Local<Object> options, int &x, int &y, int &w, int &h) {
+  Local<String> sym = Nan::New("window").ToLocalChecked();
+  if (!Nan::HasOwnProperty(options, sym).FromMaybe(false)) return nullptr;
+  Local<Value> val = Nan::Get(options, sym).ToLocalChecked();
+  if (val->IsUndefined() || val->IsNull()) return nullptr;
+  if (!val->IsObject()) return "window must be an object";
+
+  Local<Object> window = val.As<Object>();
+  const char *keys[] = {"x", "y", "width", "height"};
+  int *fields[] = {&x, &y, &w, &h};
+  for (int i = 0; i < 4; i++) {
+    Local<Value> field = Nan::Get(window, Nan::New(keys[i]).ToLocalChecked()).ToLocalChecked();
+    if (!field->IsNumber()) return "window must have numeric x, y, width and height properties";
+    *fields[i] = Nan::To<int32_t>(field).ToChecked();
+  }
+  if (w <= 0 || h <= 0) return "Invalid window";
+  return nullptr;
 }
 
 /**
@@ -361,11 +523,10 @@ NAN_METHOD(RasterBand::getStatistics) {
   NODE_ARG_BOOL(1, "force", force);
   NODE_UNWRAP_CHECK(RasterBand, info.This(), band);
   GDAL_LOCK_PARENT(band);
-  pushStatsErrorHandler();
+  StatsErrorCapture capture;
   CPLErr err = band->this_->GetStatistics(approx, force, &min, &max, &mean, &std_dev);
-  popStatsErrorHandler();
-  if (!stats_file_err.empty()) {
-    Nan::ThrowError(stats_file_err.c_str());
+  if (!capture.file_err.empty()) {
+    Nan::ThrowError(capture.file_err.c_str());
   } else if (err) {
     if (!force && err == CE_Warning) {
       Nan::ThrowError("Statistics cannot be efficiently computed without scanning raster");
@@ -392,6 +553,11 @@ NAN_METHOD(RasterBand::getStatistics) {
  * @property {number} std_dev
  */
 
+/**
+ * @typedef {object} StatisticsOptions
+ * @property {number} [parallel]
+ */
+
 /**
  * Computes image statistics.
  *
@@ -400,6 +566,8 @@ NAN_METHOD(RasterBand::getStatistics) {
  * `allow_approximation` argument can be set to `true` in which case overviews,
  * or a subset of image tiles may be used in computing the statistics.
  *
+ * Statistics of different bands can be computed at the same time.
+ *
  * @throws Error
  * @method computeStatistics
  * @instance
@@ -407,6 +575,8 @@ NAN_METHOD(RasterBand::getStatistics) {
 
  * @param {boolean} allow_approximation If `true` statistics may be computed
  * based on overviews or a subset of all tiles.
+ * @param {StatisticsOptions} [options]
+ * @param {number} [options.parallel=1] Compute the exact statistics by reducing the block rows concurrently on up to this many handles of a Dataset opened with {@link gdal.openPool}
  * @return {stats} Statistics containing `"min"`, `"max"`, `"mean"`,
  * `"std_dev"` properties.
  */
@@ -420,12 +590,16 @@ NAN_METHOD(RasterBand::getStatistics) {
  * `allow_approximation` argument can be set to `true` in which case overviews,
  * or a subset of image tiles may be used in computing the statistics.
  *
+ * Statistics of different bands can be computed at the same time.
+ *
  * @throws Error
  * @method computeStatisticsAsync
  * @instance
  * @memberof RasterBand
  * @param {boolean} allow_approximation If `true` statistics may be computed
  * based on overviews or a subset of all tiles.
+ * @param {StatisticsOptions} [options]
+ * @param {number} [options.parallel=1] Compute the exact statistics by reducing the block rows concurrently on up to this many handles of a Dataset opened with {@link gdal.openPool}
  * @param {callback<stats>} [callback=undefined]
  * @return {Promise<stats>} Statistics containing `"min"`, `"max"`, `"mean"`,
  * `"std_dev"` properties.
@@ -435,24 +609,41 @@ GDAL_ASYNCABLE_DEFINE(RasterBand::computeStatistics) {
     double min, max, mean, std_dev;
   };
   int approx;
+  int parallel = 1;
 
   NODE_ARG_BOOL(0, "allow approximation", approx);
+  NODE_ARG_INT_OPT(1, "parallel", parallel);
   NODE_UNWRAP_CHECK(RasterBand, info.This(), band);
 
   GDALAsyncableJob<stats_t> job(band->parent_uid);
   GDALRasterBand *gdal_obj = band->this_;
+  long ds_uid = band->parent_uid;
+  // The block reducer is used only when there are other handles to run it on
+  if (approx || !band->isPoolable()) parallel = 1;
 
-  job.main = [gdal_obj, approx](const GDALExecutionProgress &) {
+  job.main = [gdal_obj, approx, parallel, ds_uid](const GDALExecutionProgress &progress) {
     struct stats_t stats;
-    std::lock_guard<std::mutex> guard(stats_lock);
+    std::string file_err;
+    CPLErr err = CE_None;
 
     CPLErrorReset();
-    pushStatsErrorHandler();
-    CPLErr err = gdal_obj->ComputeStatistics(approx, &stats.min, &stats.max, &stats.mean, &stats.std_dev, NULL, NULL);
-    popStatsErrorHandler();
-    if (!stats_file_err.empty()) {
-      throw stats_file_err.c_str();
-    } else if (err != CPLE_None) {
+    {
+      StatsErrorCapture capture;
+      bool supported = false;
+      if (parallel > 1) {
+        err = parallelStatistics(
+          ds_uid, gdal_obj, parallel, progress, &stats.min, &stats.max, &stats.mean, &stats.std_dev, supported);
+      }
+      if (!supported) {
+        err = gdal_obj->ComputeStatistics(approx, &stats.min, &stats.max, &stats.mean, &stats.std_dev, NULL, NULL);
+      }
+      file_err = capture.file_err;
+    }
+    if (!file_err.empty()) {
+      // Raised again outside of the capture, it becomes the last error of this thread
+      CPLError(CE_Failure, CPLE_OpenFailed, "%s", file_err.c_str());
+      throw CPLGetLastErrorMsg();
+    } else if (err != CE_None) {
       throw CPLGetLastErrorMsg();
     }
 
@@ -469,9 +660,393 @@ GDAL_ASYNCABLE_DEFINE(RasterBand::computeStatistics) {
     return scope.Escape(result);
   };
 
+  job.run(info, async, 2);
+}
+
+/**
+ * @typedef {object} HistogramWindow
+ * @property {number} x
+ * @property {number} y
+ * @property {number} width
+ * @property {number} height
+ */
+
+/**
+ * @typedef {object} HistogramOptions
+ * @property {number} [buckets]
+ * @property {number} [min]
+ * @property {number} [max]
+ * @property {boolean} [approx]
+ * @property {boolean} [includeOutOfRange]
+ * @property {HistogramWindow} [window]
+ * @property {number} [parallel]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
+ */
+
+/**
+ * @typedef {object} Histogram
+ * @property {number} min
+ * @property {number} max
+ * @property {Float64Array} counts
+ */
+
+/**
+ * Computes the histogram of the valid pixels of the band.
+ *
+ * The range is divided in `buckets` buckets of equal width, the last one
+ * includes `max`. The pixels that are NoData, NaN or invalid according to the
+ * mask band are ignored.
+ *
+ * @throws Error
+ * @method computeHistogram
+ * @instance
+ * @memberof RasterBand
+ * @param {HistogramOptions} [options]
+ * @param {number} [options.buckets=256]
+ * @param {number} [options.min] The minimum of the band by default
+ * @param {number} [options.max] The maximum of the band by default
+ * @param {boolean} [options.approx=false] Compute the histogram from the overview used for the approximate statistics
+ * @param {boolean} [options.includeOutOfRange=false] Count the values out of range in the first and the last bucket
+ * @param {HistogramWindow} [options.window] A region of the band, the whole band by default
+ * @param {number} [options.parallel=1] Reduce the block rows concurrently on up to this many handles of a Dataset opened with {@link gdal.openPool}
+ * @return {Histogram}
+ */
+
+/**
+ * Computes the histogram of the valid pixels of the band.
+ * {{async}}
+ *
+ * The range is divided in `buckets` buckets of equal width, the last one
+ * includes `max`. The pixels that are NoData, NaN or invalid according to the
+ * mask band are ignored.
+ *
+ * @throws Error
+ * @method computeHistogramAsync
+ * @instance
+ * @memberof RasterBand
+ * @param {HistogramOptions} [options]
+ * @param {number} [options.buckets=256]
+ * @param {number} [options.min] The minimum of the band by default
+ * @param {number} [options.max] The maximum of the band by default
+ * @param {boolean} [options.approx=false] Compute the histogram from the overview used for the approximate statistics
+ * @param {boolean} [options.includeOutOfRange=false] Count the values out of range in the first and the last bucket
+ * @param {HistogramWindow} [options.window] A region of the band, the whole band by default
+ * @param {number} [options.parallel=1] Reduce the block rows concurrently on up to this many handles of a Dataset opened with {@link gdal.openPool}
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
+ * @param {callback<Histogram>} [callback=undefined]
+ * @return {Promise<Histogram>}
+ */
+GDAL_ASYNCABLE_DEFINE(RasterBand::computeHistogram) {
+  struct histogram_t {
+    double min, max;
+    std::vector<uint64_t> counts;
+  };
+  Local<Object> options = Nan::New<Object>();
+  int buckets = 256;
+  double min = std::numeric_limits<double>::quiet_NaN();
+  double max = std::numeric_limits<double>::quiet_NaN();
+  bool approx = false;
+  bool include_out_of_range = false;
+  int parallel = 1;
+  int x = 0, y = 0, w = -1, h = -1;
+
+  NODE_ARG_OBJECT_OPT(0, "options", options);
+  NODE_INT_FROM_OBJ_OPT(options, "buckets", buckets);
+  NODE_DOUBLE_FROM_OBJ_OPT(options, "min", min);
+  NODE_DOUBLE_FROM_OBJ_OPT(options, "max", max);
+  NODE_BOOL_FROM_OBJ_OPT(options, "approx", approx);
+  NODE_BOOL_FROM_OBJ_OPT(options, "includeOutOfRange", include_out_of_range);
+  NODE_INT_FROM_OBJ_OPT(options, "parallel", parallel);
+  const char *window_err = parseWindow(options, x, y, w, h);
+  if (window_err != nullptr) {
+    Nan::ThrowTypeError(window_err);
+    return;
+  }
+  if (buckets < 1) {
+    Nan::ThrowRangeError("buckets must be a positive number");
+    return;
+  }
+  if (!std::isnan(min) && !std::isnan(max) && !(max > min)) {
+    Nan::ThrowRangeError("max must be greater than min");
+    return;
+  }
+  NODE_UNWRAP_CHECK(RasterBand, info.This(), band);
+
+  GDALAsyncableJob<histogram_t> job(band->parent_uid);
+  GDALRasterBand *gdal_obj = band->this_;
+  long ds_uid = band->parent_uid;
+
+  job.main = [gdal_obj, ds_uid, buckets, min, max, approx, include_out_of_range, parallel, x, y, w, h](
+               const GDALExecutionProgress &progress) {
+    ReducedWindow win = reducedWindow(gdal_obj, approx, x, y, w, h);
+    NoDataFilter filter(gdal_obj);
+    histogram_t r = {min, max, {}};
+
+    CPLErrorReset();
+    if (std::isnan(min) || std::isnan(max)) {
+      PartialStats stats = windowStatistics(progress, ds_uid, gdal_obj, win, parallel, filter);
+      if (stats.count == 0) throw "No valid pixels to compute the range of the histogram";
+      if (std::isnan(min)) r.min = stats.min;
+      if (std::isnan(max)) r.max = stats.max;
+      if (!(r.max > r.min)) {
+        if (!std::isnan(min) || !std::isnan(max)) throw "max must be greater than min";
+        // A constant band, centered in the range like in the GDAL default histogram
+        r.min -= 0.5;
+        r.max += 0.5;
+      }
+    }
+
+    PartialHistogram hist(r.min, r.max, buckets, include_out_of_range);
+    CPLErr err = reduceBlockRows(
+      progress,
+      ds_uid,
+      gdal_obj,
+      win.overview,
+      win.x,
+      win.y,
+      win.w,
+      win.h,
+      parallel,
+      hist,
+      [&filter](PartialHistogram &partial, const double *values, size_t length) {
+        partial.reduce(values, length, filter);
+      });
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+    r.counts = std::move(hist.counts);
+    return r;
+  };
+
+  job.rval = [](histogram_t r, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("min").ToLocalChecked(), Nan::New<Number>(r.min));
+    Nan::Set(result, Nan::New("max").ToLocalChecked(), Nan::New<Number>(r.max));
+    Local<Value> counts = TypedArray::New(GDT_Float64, static_cast<unsigned int>(r.counts.size()));
+    if (!counts.IsEmpty() && counts->IsObject()) {
+      double *data = static_cast<double *>(
+        TypedArray::Validate(counts.As<Object>(), GDT_Float64, static_cast<int>(r.counts.size())));
+      for (size_t i = 0; i < r.counts.size(); i++) data[i] = static_cast<double>(r.counts[i]);
+      Nan::Set(result, Nan::New("counts").ToLocalChecked(), counts);
+    }
+    return scope.Escape(result);
+  };
+
   job.run(info, async, 1);
 }
 
+// The values between the minimum and the maximum are first counted in
+// percentileBuckets buckets, then the values of the buckets containing the
+// requested ranks are collected and sorted - unless there are more than
+// percentileMaxCollected of them, then they are interpolated in the bucket
+static const int percentileBuckets = 65536;
+static const uint64_t percentileMaxCollected = 1 << 24;
+
+// The values of some of the buckets of a histogram
+struct PartialBucketValues {
+  std::vector<std::vector<double>> values;
+
+  void merge(const PartialBucketValues &o) {
+    for (size_t i = 0; i < values.size(); i++) values[i].insert(values[i].end(), o.values[i].begin(), o.values[i].end());
+  }
+};
+
+/**
+ * @typedef {object} PercentilesOptions
+ * @property {boolean} [approx]
+ * @property {HistogramWindow} [window]
+ * @property {number} [parallel]
+ * @property {AbortSignal} [signal]
+ * @property {number} [priority]
+ * @property {number} [deadline]
+ */
+
+/**
+ * Computes percentiles of the valid pixels of the band.
+ *
+ * The percentiles are interpolated linearly between the closest ranks,
+ * `50` is the median. The pixels that are NoData, NaN or invalid according to
+ * the mask band are ignored.
+ *
+ * @example
+ * // the bounds of a 2%-98% contrast stretch
+ * const [ low, high ] = band.computePercentiles([ 2, 98 ], { approx: true });
+ *
+ * @throws Error
+ * @method computePercentiles
+ * @instance
+ * @memberof RasterBand
+ * @param {number[]} percentiles Between `0` and `100`
+ * @param {PercentilesOptions} [options]
+ * @param {boolean} [options.approx=false] Compute the percentiles from the overview used for the approximate statistics
+ * @param {HistogramWindow} [options.window] A region of the band, the whole band by default
+ * @param {number} [options.parallel=1] Reduce the block rows concurrently on up to this many handles of a Dataset opened with {@link gdal.openPool}
+ * @return {Float64Array}
+ */
+
+/**
+ * Computes percentiles of the valid pixels of the band.
+ * {{async}}
+ *
+ * The percentiles are interpolated linearly between the closest ranks,
+ * `50` is the median. The pixels that are NoData, NaN or invalid according to
+ * the mask band are ignored.
+ *
+ * @throws Error
+ * @method computePercentilesAsync
+ * @instance
+ * @memberof RasterBand
+ * @param {number[]} percentiles Between `0` and `100`
+ * @param {PercentilesOptions} [options]
+ * @param {boolean} [options.approx=false] Compute the percentiles from the overview used for the approximate statistics
+ * @param {HistogramWindow} [options.window] A region of the band, the whole band by default
+ * @param {number} [options.parallel=1] Reduce the block rows concurrently on up to this many handles of a Dataset opened with {@link gdal.openPool}
+ * @param {AbortSignal} [options.signal] Abort the operation when this AbortSignal is triggered
+ * @param {number} [options.priority=0] Operations with higher priority are started first
+ * @param {number} [options.deadline] Fail if the operation has not started before this time (`Date.now()` ms)
+ * @param {callback<Float64Array>} [callback=undefined]
+ * @return {Promise<Float64Array>}
+ */
+GDAL_ASYNCABLE_DEFINE(RasterBand::computePercentiles) {
+  Local<Array> list;
+  Local<Object> options = Nan::New<Object>();
+  std::vector<double> percentiles;
+  bool approx = false;
+  int parallel = 1;
+  int x = 0, y = 0, w = -1, h = -1;
+
+  NODE_ARG_ARRAY(0, "percentiles", list);
+  NODE_ARG_OBJECT_OPT(1, "options", options);
+  NODE_BOOL_FROM_OBJ_OPT(options, "approx", approx);
+  NODE_INT_FROM_OBJ_OPT(options, "parallel", parallel);
+  const char *window_err = parseWindow(options, x, y, w, h);
+  if (window_err != nullptr) {
+    Nan::ThrowTypeError(window_err);
+    return;
+  }
+  for (unsigned i = 0; i < list->Length(); i++) {
+    Local<Value> p = Nan::Get(list, i).ToLocalChecked();
+    if (!p->IsNumber()) {
+      Nan::ThrowTypeError("percentiles must be an array of numbers");
+      return;
+    }
+    percentiles.push_back(Nan::To<double>(p).ToChecked());
+    if (!(percentiles.back() >= 0 && percentiles.back() <= 100)) {
+      Nan::ThrowRangeError("percentiles must be between 0 and 100");
+      return;
+    }
+  }
+  NODE_UNWRAP_CHECK(RasterBand, info.This(), band);
+
+  GDALAsyncableJob<std::vector<double>> job(band->parent_uid);
+  GDALRasterBand *gdal_obj = band->this_;
+  long ds_uid = band->parent_uid;
+
+  job.main = [gdal_obj, ds_uid, percentiles, approx, parallel, x, y, w, h](const GDALExecutionProgress &progress) {
+    ReducedWindow win = reducedWindow(gdal_obj, approx, x, y, w, h);
+    NoDataFilter filter(gdal_obj);
+
+    CPLErrorReset();
+    PartialStats stats = windowStatistics(progress, ds_uid, gdal_obj, win, parallel, filter);
+    if (stats.count == 0) throw "No valid pixels to compute the percentiles";
+    std::vector<double> r(percentiles.size(), stats.min);
+    if (stats.min == stats.max) return r;
+
+    PartialHistogram hist(stats.min, stats.max, percentileBuckets, false);
+    CPLErr err = reduceBlockRows(
+      progress,
+      ds_uid,
+      gdal_obj,
+      win.overview,
+      win.x,
+      win.y,
+      win.w,
+      win.h,
+      parallel,
+      hist,
+      [&filter](PartialHistogram &partial, const double *values, size_t length) {
+        partial.reduce(values, length, filter);
+      });
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+
+    // The bucket and the position in the bucket of the value of a rank
+    auto locate = [&hist](uint64_t rank, uint64_t &offset) {
+      int b = 0;
+      int last = static_cast<int>(hist.counts.size()) - 1;
+      while (b < last && rank >= hist.counts[b]) rank -= hist.counts[b++];
+      offset = rank;
+      return b;
+    };
+
+    // Select the buckets that will be sorted
+    std::vector<int> slots(percentileBuckets, -1);
+    PartialBucketValues collected;
+    for (double p : percentiles) {
+      double pos = p / 100 * (stats.count - 1);
+      for (double rank : {std::floor(pos), std::ceil(pos)}) {
+        uint64_t offset;
+        int b = locate(static_cast<uint64_t>(rank), offset);
+        if (slots[b] < 0 && hist.counts[b] <= percentileMaxCollected) {
+          slots[b] = static_cast<int>(collected.values.size());
+          collected.values.emplace_back();
+        }
+      }
+    }
+
+    err = reduceBlockRows(
+      progress,
+      ds_uid,
+      gdal_obj,
+      win.overview,
+      win.x,
+      win.y,
+      win.w,
+      win.h,
+      parallel,
+      collected,
+      [&filter, &hist, &slots](PartialBucketValues &partial, const double *values, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+          double v = values[i];
+          if (!filter.valid(v)) continue;
+          int b = hist.bucket(v);
+          if (b >= 0 && slots[b] >= 0) partial.values[slots[b]].push_back(v);
+        }
+      });
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+    for (auto &values : collected.values) std::sort(values.begin(), values.end());
+
+    auto value = [&](uint64_t rank) {
+      uint64_t offset;
+      int b = locate(rank, offset);
+      if (slots[b] >= 0 && offset < collected.values[slots[b]].size()) return collected.values[slots[b]][offset];
+      return hist.min + (b + (offset + 0.5) / hist.counts[b]) / hist.scale;
+    };
+    for (size_t i = 0; i < percentiles.size(); i++) {
+      double pos = percentiles[i] / 100 * (stats.count - 1);
+      double lower = value(static_cast<uint64_t>(std::floor(pos)));
+      double upper = value(static_cast<uint64_t>(std::ceil(pos)));
+      r[i] = lower + (pos - std::floor(pos)) * (upper - lower);
+    }
+    return r;
+  };
+
+  job.rval = [](std::vector<double> r, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    Local<Value> array = TypedArray::New(GDT_Float64, static_cast<unsigned int>(r.size()));
+    if (!array.IsEmpty() && array->IsObject()) {
+      double *data =
+        static_cast<double *>(TypedArray::Validate(array.As<Object>(), GDT_Float64, static_cast<int>(r.size())));
+      for (size_t i = 0; i < r.size(); i++) data[i] = r[i];
+    }
+    return scope.Escape(array);
+  };
+
+  job.run(info, async, 2);
+}
+
 /**
  * Set statistics on the band. This method can be used to store
  * min/max/mean/standard deviation statistics.
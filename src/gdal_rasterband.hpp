@@ -20,7 +20,7 @@ namespace node_gdal {
 
 class RasterBand : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
   static Local<Value> New(GDALRasterBand *band, GDALDataset *parent);
@@ -32,6 +32,8 @@ class RasterBand : public Nan::ObjectWrap {
 #endif
   static NAN_METHOD(getStatistics);
   GDAL_ASYNCABLE_DECLARE(computeStatistics);
+  GDAL_ASYNCABLE_DECLARE(computeHistogram);
+  GDAL_ASYNCABLE_DECLARE(computePercentiles);
   static NAN_METHOD(setStatistics);
   static NAN_METHOD(getMaskBand);
   static NAN_METHOD(getMaskFlags);
@@ -78,6 +80,10 @@ class RasterBand : public Nan::ObjectWrap {
   inline GDALDataset *getParent() {
     return parent_ds;
   }
+  // The band can be found by its number on the other handles of a pooled Dataset
+  inline bool isPoolable() {
+    return this_->GetBand() > 0 && this_->GetDataset() == parent_ds;
+  }
   void dispose();
   long uid;
   // Dataset that will be locked
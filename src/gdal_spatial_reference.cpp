@@ -6,7 +6,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> SpatialReference::constructor;
+thread_local Nan::Persistent<FunctionTemplate> SpatialReference::constructor;
 
 void SpatialReference::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
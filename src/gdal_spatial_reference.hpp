@@ -26,7 +26,7 @@ typedef const char OGRChar;
 
 class SpatialReference : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static void Initialize(Local<Object> target);
 
   static NAN_METHOD(New);
@@ -89,12 +89,12 @@ GDAL_ASYNCABLE_DEFINE(Utils::translate) {
 
   GDALAsyncableJob<GDALDataset *> job(ds->uid);
   job.progress = progress_cb;
-  job.main = [raw, dst, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [raw, dst, aosOptions](const GDALExecutionProgress &progress) {
     CPLErrorReset();
     auto b = aosOptions;
     auto psOptions = GDALTranslateOptionsNew(aosOptions->List(), nullptr);
     if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-    if (progress_cb) GDALTranslateOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+    GDALTranslateOptionsSetProgress(psOptions, progress.trampoline(), (void *)&progress);
     GDALDataset *r = GDALDatasetFromHandle(GDALTranslate(dst.c_str(), GDALDatasetToHandle(raw), psOptions, nullptr));
     GDALTranslateOptionsFree(psOptions);
     if (r == nullptr) throw CPLGetLastErrorMsg();
@@ -192,7 +192,7 @@ GDAL_ASYNCABLE_DEFINE(Utils::vectorTranslate) {
     auto psOptions = GDALVectorTranslateOptionsNew(aosOptions->List(), nullptr);
     if (psOptions == nullptr) throw CPLGetLastErrorMsg();
 
-    if (progress_cb) GDALVectorTranslateOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+    GDALVectorTranslateOptionsSetProgress(psOptions, progress.trampoline(), (void *)&progress);
 
     auto srcH = GDALDatasetToHandle(src_raw);
     GDALDataset *r = GDALDatasetFromHandle(
@@ -362,11 +362,11 @@ GDAL_ASYNCABLE_DEFINE(Utils::warp) {
   int src_count = src_ds->Length();
   job.progress = progress_cb;
   job.main =
-    [dst_path, gdal_dst_ds, src_count, gdal_src_ds, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+    [dst_path, gdal_dst_ds, src_count, gdal_src_ds, aosOptions](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       auto psOptions = GDALWarpAppOptionsNew(aosOptions->List(), nullptr);
       if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-      if (progress_cb) GDALWarpAppOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+      GDALWarpAppOptionsSetProgress(psOptions, progress.trampoline(), (void *)&progress);
       GDALDatasetH r = GDALWarp(
         dst_path.length() > 0 ? dst_path.c_str() : nullptr,
         gdal_dst_ds,
@@ -486,11 +486,11 @@ GDAL_ASYNCABLE_DEFINE(Utils::buildvrt) {
   int src_count = src_ds->Length();
   job.progress = progress_cb;
   job.main =
-    [dst_path, src_count, gdalSrcDs, aosSrcDs, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+    [dst_path, src_count, gdalSrcDs, aosSrcDs, aosOptions](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       auto psOptions = GDALBuildVRTOptionsNew(aosOptions->List(), nullptr);
       if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-      if (progress_cb) GDALBuildVRTOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+      GDALBuildVRTOptionsSetProgress(psOptions, progress.trampoline(), (void *)&progress);
 
       GDALDatasetH r = GDALBuildVRT(
         dst_path.c_str(),
@@ -594,11 +594,11 @@ GDAL_ASYNCABLE_DEFINE(Utils::rasterize) {
 
   GDALAsyncableJob<GDALDataset *> job(ds->uid);
   job.progress = progress_cb;
-  job.main = [dst_path, dst_raw, src_raw, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [dst_path, dst_raw, src_raw, aosOptions](const GDALExecutionProgress &progress) {
     CPLErrorReset();
     auto psOptions = GDALRasterizeOptionsNew(aosOptions->List(), nullptr);
     if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-    if (progress_cb) GDALRasterizeOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+    GDALRasterizeOptionsSetProgress(psOptions, progress.trampoline(), (void *)&progress);
 
     GDALDatasetH r = GDALRasterize(
       dst_path.length() > 0 ? dst_path.c_str() : nullptr,
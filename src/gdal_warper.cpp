@@ -291,7 +291,7 @@ GDAL_ASYNCABLE_DEFINE(Warper::reprojectImage) {
   // opts is a pointer inside options memory space
   // the lifetime of the options shared_ptr is limited by the lifetime of the lambda
   if (options->useMultithreading()) {
-    job.main = [options, opts, s_srs_str, t_srs_str, maxError, progress_cb](const GDALExecutionProgress &progress) {
+    job.main = [options, opts, s_srs_str, t_srs_str, maxError](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       CPLErr err = GDALReprojectImageMulti(
         opts->hSrcDS,
@@ -301,14 +301,14 @@ GDAL_ASYNCABLE_DEFINE(Warper::reprojectImage) {
         opts->eResampleAlg,
         opts->dfWarpMemoryLimit,
         maxError,
-        progress_cb ? ProgressTrampoline : nullptr,
-        progress_cb ? (void *)&progress : nullptr,
+        progress.trampoline(),
+        (void *)&progress,
         opts);
       if (err) { throw CPLGetLastErrorMsg(); }
       return err;
     };
   } else {
-    job.main = [options, opts, s_srs_str, t_srs_str, maxError, progress_cb](const GDALExecutionProgress &progress) {
+    job.main = [options, opts, s_srs_str, t_srs_str, maxError](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       CPLErr err = GDALReprojectImage(
         opts->hSrcDS,
@@ -318,8 +318,8 @@ GDAL_ASYNCABLE_DEFINE(Warper::reprojectImage) {
         opts->eResampleAlg,
         opts->dfWarpMemoryLimit,
         maxError,
-        progress_cb ? ProgressTrampoline : nullptr,
-        progress_cb ? (void *)&progress : nullptr,
+        progress.trampoline(),
+        (void *)&progress,
         opts);
       if (err) { throw CPLGetLastErrorMsg(); }
       return err;
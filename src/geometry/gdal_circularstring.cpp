@@ -11,7 +11,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> CircularString::constructor;
+thread_local Nan::Persistent<FunctionTemplate> CircularString::constructor;
 
 void CircularString::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -22,7 +22,7 @@ namespace node_gdal {
 class CircularString : public CurveBase<CircularString, OGRCircularString, LineStringPoints> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using CurveBase<CircularString, OGRCircularString, LineStringPoints>::CurveBase;
 
   static void Initialize(Local<Object> target);
@@ -23,7 +23,7 @@ class CompoundCurve : public CurveBase<CompoundCurve, OGRCompoundCurve, Compound
   friend CurveBase;
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using CurveBase<CompoundCurve, OGRCompoundCurve, CompoundCurveCurves>::CurveBase;
 
   static void Initialize(Local<Object> target);
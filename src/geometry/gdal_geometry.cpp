@@ -23,7 +23,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Geometry::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Geometry::constructor;
 
 void Geometry::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
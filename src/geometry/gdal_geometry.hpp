@@ -21,7 +21,7 @@ namespace node_gdal {
 
 class Geometry : public GeometryBase<Geometry, OGRGeometry> {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using GeometryBase<Geometry, OGRGeometry>::GeometryBase;
 
   static void Initialize(Local<Object> target);
@@ -22,7 +22,7 @@ namespace node_gdal {
 class LineString : public CurveBase<LineString, OGRLineString, LineStringPoints> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using CurveBase<LineString, OGRLineString, LineStringPoints>::CurveBase;
 
   static void Initialize(Local<Object> target);
@@ -9,7 +9,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> MultiCurve::constructor;
+thread_local Nan::Persistent<FunctionTemplate> MultiCurve::constructor;
 
 void MultiCurve::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
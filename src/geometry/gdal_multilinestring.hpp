@@ -21,7 +21,7 @@ namespace node_gdal {
 class MultiLineString : public GeometryCollectionBase<MultiLineString, OGRMultiLineString> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using GeometryCollectionBase<MultiLineString, OGRMultiLineString>::GeometryCollectionBase;
 
   static void Initialize(Local<Object> target);
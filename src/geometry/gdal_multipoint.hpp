@@ -21,7 +21,7 @@ namespace node_gdal {
 class MultiPoint : public GeometryCollectionBase<MultiPoint, OGRMultiPoint> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using GeometryCollectionBase<MultiPoint, OGRMultiPoint>::GeometryCollectionBase;
 
   static void Initialize(Local<Object> target);
@@ -6,7 +6,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Point::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Point::constructor;
 
 void Point::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
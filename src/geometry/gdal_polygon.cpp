@@ -8,7 +8,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Polygon::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Polygon::constructor;
 
 void Polygon::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -23,7 +23,7 @@ class Polygon : public CurveBase<Polygon, OGRPolygon, PolygonRings> {
   friend CurveBase;
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using CurveBase<Polygon, OGRPolygon, PolygonRings>::CurveBase;
 
   static void Initialize(Local<Object> target);
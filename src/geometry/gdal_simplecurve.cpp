@@ -10,7 +10,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> SimpleCurve::constructor;
+thread_local Nan::Persistent<FunctionTemplate> SimpleCurve::constructor;
 
 void SimpleCurve::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
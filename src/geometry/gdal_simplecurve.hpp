@@ -22,7 +22,7 @@ namespace node_gdal {
 class SimpleCurve : public CurveBase<SimpleCurve, OGRSimpleCurve, LineStringPoints> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using CurveBase<SimpleCurve, OGRSimpleCurve, LineStringPoints>::CurveBase;
 
   static void Initialize(Local<Object> target);
@@ -48,6 +48,7 @@
 
 // collections
 #include "collections/dataset_bands.hpp"
+#include "collections/dataset_pixels.hpp"
 #include "collections/dataset_layers.hpp"
 #include "collections/group_groups.hpp"
 #include "collections/group_arrays.hpp"
@@ -235,6 +236,90 @@ GDAL_ASYNCABLE_DEFINE(gdal_open) {
   job.run(info, async, 2);
 }
 
+/**
+ * @typedef {object} PoolOptions
+ * @property {number} [handles]
+ */
+
+/**
+ * Opens a raster dataset in read-only mode with multiple underlying GDAL handles.
+ *
+ * GDAL supports only one operation at a time per handle. The pixel reads of a pooled
+ * Dataset (`RasterBandPixels.readAsync`, `readBlockAsync` and `getAsync` on its bands)
+ * can be executed in parallel on any free handle. All other operations use the main handle.
+ *
+ * @example
+ *
+ * var dataset = gdal.openPool('./cog.tif', { handles: 8 });
+ *
+ * @throws Error
+ * @method openPool
+ * @static
+ * @param {string} path Path to dataset to open
+ * @param {PoolOptions} [options]
+ * @param {number} [options.handles=4] Number of GDAL handles
+ * @return {Dataset}
+ */
+
+/**
+ * Opens a raster dataset in read-only mode with multiple underlying GDAL handles.
+ * @async
+ *
+ * GDAL supports only one operation at a time per handle. The pixel reads of a pooled
+ * Dataset (`RasterBandPixels.readAsync`, `readBlockAsync` and `getAsync` on its bands)
+ * can be executed in parallel on any free handle. All other operations use the main handle.
+ *
+ * @example
+ *
+ * var dataset = await gdal.openPoolAsync('./cog.tif', { handles: 8 });
+ *
+ * @throws Error
+ * @method openPoolAsync
+ * @static
+ * @param {string} path Path to dataset to open
+ * @param {PoolOptions} [options]
+ * @param {number} [options.handles=4] Number of GDAL handles
+ * @param {callback<Dataset>} [callback=undefined]
+ * @return {Promise<Dataset>}
+ */
+GDAL_ASYNCABLE_GLOBAL(gdal_openPool);
+GDAL_ASYNCABLE_DEFINE(gdal_openPool) {
+  std::string path;
+  Local<Object> options;
+  int handles = 4;
+
+  NODE_ARG_STR(0, "path", path);
+  NODE_ARG_OBJECT_OPT(1, "options", options);
+  if (!options.IsEmpty()) NODE_INT_FROM_OBJ_OPT(options, "handles", handles);
+  if (handles < 1) {
+    Nan::ThrowRangeError("handles must be at least 1");
+    return;
+  }
+
+  unsigned int flags = GDAL_OF_RASTER | GDAL_OF_READONLY | GDAL_OF_VERBOSE_ERROR;
+
+  GDALAsyncableJob<std::vector<GDALDataset *>> job(0);
+  job.main = [path, flags, handles](const GDALExecutionProgress &) {
+    std::vector<GDALDataset *> pool;
+    for (int i = 0; i < handles; i++) {
+      GDALDataset *ds = (GDALDataset *)GDALOpenEx(path.c_str(), flags, NULL, NULL, NULL);
+      if (!ds) {
+        for (GDALDataset *opened : pool) GDALClose(opened);
+        throw CPLGetLastErrorMsg();
+      }
+      pool.push_back(ds);
+    }
+    return pool;
+  };
+  job.rval = [](std::vector<GDALDataset *> pool, const GetFromPersistentFunc &) {
+    Local<Value> obj = Dataset::New(pool[0]);
+    Dataset *ds = Nan::ObjectWrap::Unwrap<Dataset>(obj.As<Object>());
+    object_store.addPool(ds->uid, std::vector<GDALDataset *>(pool.begin() + 1, pool.end()));
+    return obj;
+  };
+  job.run(info, async, 2);
+}
+
 static NAN_METHOD(setConfigOption) {
 
   std::string name;
@@ -314,6 +399,56 @@ static NAN_METHOD(setPROJSearchPath) {
 #endif
 }
 
+/**
+ * @typedef {object} LatencyHistogram
+ * @property {number} count
+ * @property {number} total Sum of all durations in µs
+ * @property {number} max Longest duration in µs
+ * @property {number} p50 Median in µs
+ * @property {number} p90 90th percentile in µs
+ * @property {number} p99 99th percentile in µs
+ * @property {[number, number][]} buckets The non-empty buckets of the log-linear histogram as `[ upper bound in µs, count ]`
+ */
+
+/**
+ * @typedef {object} CallStats
+ * @property {number} calls
+ * @property {number} errors
+ * @property {LatencyHistogram} queue Time spent by async operations waiting for their Datasets
+ * @property {LatencyHistogram} pool Time spent by async operations waiting for a thread of the libuv pool
+ * @property {LatencyHistogram} lock Time spent by sync operations blocked on a Dataset lock
+ * @property {LatencyHistogram} execute Time spent in GDAL
+ * @property {LatencyHistogram} rval Time spent producing the JS return value on the main thread
+ */
+
+/**
+ * @typedef {object} Stats
+ * @property {Record<string, CallStats>} methods Per method name
+ * @property {Record<number, CallStats>} datasets Per Dataset uid, the closed Datasets are removed
+ */
+
+/**
+ * Returns the telemetry counters of all the operations that use a Dataset
+ * lock since the start of the process or since the last call of `gdal.resetStats()`
+ *
+ * @static
+ * @method stats
+ * @return {Stats}
+ */
+static NAN_METHOD(stats) {
+  info.GetReturnValue().Set(async_stats.toObject());
+}
+
+/**
+ * Resets the telemetry counters returned by `gdal.stats()`
+ *
+ * @static
+ * @method resetStats
+ */
+static NAN_METHOD(resetStats) {
+  async_stats.reset();
+}
+
 static NAN_METHOD(ThrowDummyCPLError) {
   CPLError(CE_Failure, CPLE_AppDefined, "Mock error");
   return;
@@ -327,24 +462,37 @@ static NAN_METHOD(isAlive) {
   info.GetReturnValue().Set(Nan::New(object_store.isAlive(uid)));
 }
 
+// Called when the environment of an isolate is destroyed, the main one
+// on process exit or the one of a worker_threads Worker when it exits
+// The pending pixel function calls must fail first: a worker thread waiting
+// for one of them holds a Dataset lock that the cleanup of the ObjectStore needs
 void Cleanup(void *) {
+  Algorithms::shutdown();
   object_store.cleanup();
+  async_scheduler.shutdown();
 }
 
-static void Init(Local<Object> target, Local<v8::Value>, void *) {
-  static bool initialized = false;
+// The addon is context-aware, it is initialized once per V8 isolate
+// GDAL and the ObjectStore with the Dataset locks are shared by the whole process
+// while the constructors, the JS objects of the ObjectStore, the AsyncScheduler
+// and the telemetry counters are per isolate (thread_local)
+static void Init(Local<Object> target) {
+  static thread_local bool initialized = false;
   if (initialized) {
     Nan::ThrowError("gdal-async does not yet support multiple instances per V8 isolate");
     return;
   }
   initialized = true;
-  mainV8ThreadId = std::this_thread::get_id();
+  async_scheduler.initialize();
 
   Nan__SetAsyncableMethod(target, "open", gdal_open);
+  Nan__SetAsyncableMethod(target, "openPool", gdal_openPool);
   Nan::SetMethod(target, "setConfigOption", setConfigOption);
   Nan::SetMethod(target, "getConfigOption", getConfigOption);
   Nan::SetMethod(target, "decToDMS", decToDMS);
   Nan::SetMethod(target, "setPROJSearchPath", setPROJSearchPath);
+  Nan::SetMethod(target, "stats", stats);
+  Nan::SetMethod(target, "resetStats", resetStats);
   Nan::SetMethod(target, "_triggerCPLError", ThrowDummyCPLError); // for tests
   Nan::SetMethod(target, "_isAlive", isAlive);                    // for tests
 
@@ -384,6 +532,7 @@ static void Init(Local<Object> target, Local<v8::Value>, void *) {
   ColorTable::Initialize(target);
 
   DatasetBands::Initialize(target);
+  DatasetPixels::Initialize(target);
   DatasetLayers::Initialize(target);
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
   GroupGroups::Initialize(target);
@@ -1786,11 +1935,10 @@ static void Init(Local<Object> target, Local<v8::Value>, void *) {
   NODE_DEFINE_CONSTANT(target, CPLE_NoWriteAccess);
   NODE_DEFINE_CONSTANT(target, CPLE_UserInterrupt);
 
-  auto *env = GetCurrentEnvironment(target->GetIsolate()->GetCurrentContext());
-  AtExit(env, Cleanup, nullptr);
+  node::AddEnvironmentCleanupHook(target->GetIsolate(), Cleanup, nullptr);
 }
 }
 
 } // namespace node_gdal
 
-NODE_MODULE(NODE_GYP_MODULE_NAME, node_gdal::Init);
+NAN_MODULE_WORKER_ENABLED(NODE_GYP_MODULE_NAME, node_gdal::Init)
@@ -0,0 +1,149 @@
+#include "async_stats.hpp"
+
+#include <algorithm>
+
+namespace node_gdal {
+
+thread_local AsyncStatsRegistry async_stats;
+thread_local const char *currentMethod = nullptr;
+
+LatencyHistogram::LatencyHistogram() {
+  reset();
+}
+
+void LatencyHistogram::reset() {
+  for (int i = 0; i < size; i++) buckets[i] = 0;
+  count = 0;
+  total = 0;
+  max = 0;
+}
+
+int LatencyHistogram::bucketOf(uint64_t us) {
+  if (us < linear) return static_cast<int>(us);
+  int exp = 4;
+  while (exp < maxExponent - 1 && (us >> (exp + 1)) != 0) exp++;
+  int sub = static_cast<int>((us >> (exp - 2)) & (subBuckets - 1));
+  return linear + (exp - 4) * subBuckets + sub;
+}
+
+// The largest value that falls in this bucket
+uint64_t LatencyHistogram::upperBound(int bucket) {
+  if (bucket < linear) return bucket;
+  int exp = 4 + (bucket - linear) / subBuckets;
+  uint64_t sub = (bucket - linear) % subBuckets;
+  return ((subBuckets + sub + 1) << (exp - 2)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t us) {
+  buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_relaxed);
+  total.fetch_add(us, std::memory_order_relaxed);
+  uint64_t m = max.load(std::memory_order_relaxed);
+  while (us > m && !max.compare_exchange_weak(m, us, std::memory_order_relaxed))
+    ;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+  uint64_t n = count.load(std::memory_order_relaxed);
+  if (n == 0) return 0;
+  uint64_t rank = static_cast<uint64_t>(p * n + 0.5);
+  if (rank < 1) rank = 1;
+  uint64_t cumulative = 0;
+  for (int i = 0; i < size; i++) {
+    cumulative += buckets[i].load(std::memory_order_relaxed);
+    if (cumulative >= rank) return std::min(upperBound(i), max.load(std::memory_order_relaxed));
+  }
+  return max.load(std::memory_order_relaxed);
+}
+
+Local<Object> LatencyHistogram::toObject() const {
+  Nan::EscapableHandleScope scope;
+  Local<Object> r = Nan::New<Object>();
+  Nan::Set(r, Nan::New("count").ToLocalChecked(), Nan::New<Number>(static_cast<double>(count.load())));
+  Nan::Set(r, Nan::New("total").ToLocalChecked(), Nan::New<Number>(static_cast<double>(total.load())));
+  Nan::Set(r, Nan::New("max").ToLocalChecked(), Nan::New<Number>(static_cast<double>(max.load())));
+  Nan::Set(r, Nan::New("p50").ToLocalChecked(), Nan::New<Number>(static_cast<double>(percentile(0.5))));
+  Nan::Set(r, Nan::New("p90").ToLocalChecked(), Nan::New<Number>(static_cast<double>(percentile(0.9))));
+  Nan::Set(r, Nan::New("p99").ToLocalChecked(), Nan::New<Number>(static_cast<double>(percentile(0.99))));
+  // Only the non-empty buckets as [ upper bound, count ]
+  Local<Array> list = Nan::New<Array>();
+  uint32_t n = 0;
+  for (int i = 0; i < size; i++) {
+    uint64_t v = buckets[i].load(std::memory_order_relaxed);
+    if (v == 0) continue;
+    Local<Array> bucket = Nan::New<Array>(2);
+    Nan::Set(bucket, 0, Nan::New<Number>(static_cast<double>(upperBound(i))));
+    Nan::Set(bucket, 1, Nan::New<Number>(static_cast<double>(v)));
+    Nan::Set(list, n++, bucket);
+  }
+  Nan::Set(r, Nan::New("buckets").ToLocalChecked(), list);
+  return scope.Escape(r);
+}
+
+AsyncStats::AsyncStats() : calls(0), errors(0), queue(), pool(), lock(), execute(), rval() {
+}
+
+Local<Object> AsyncStats::toObject() const {
+  Nan::EscapableHandleScope scope;
+  Local<Object> r = Nan::New<Object>();
+  Nan::Set(r, Nan::New("calls").ToLocalChecked(), Nan::New<Number>(static_cast<double>(calls.load())));
+  Nan::Set(r, Nan::New("errors").ToLocalChecked(), Nan::New<Number>(static_cast<double>(errors.load())));
+  Nan::Set(r, Nan::New("queue").ToLocalChecked(), queue.toObject());
+  Nan::Set(r, Nan::New("pool").ToLocalChecked(), pool.toObject());
+  Nan::Set(r, Nan::New("lock").ToLocalChecked(), lock.toObject());
+  Nan::Set(r, Nan::New("execute").ToLocalChecked(), execute.toObject());
+  Nan::Set(r, Nan::New("rval").ToLocalChecked(), rval.toObject());
+  return scope.Escape(r);
+}
+
+AsyncStatsRegistry::AsyncStatsRegistry() : methods(), datasets() {
+}
+
+std::shared_ptr<AsyncStats> AsyncStatsRegistry::method(const char *name) {
+  if (name == nullptr) name = "unknown";
+  auto &stats = methods[name];
+  if (stats == nullptr) stats = std::make_shared<AsyncStats>();
+  return stats;
+}
+
+std::shared_ptr<AsyncStats> AsyncStatsRegistry::dataset(long uid) {
+  auto &stats = datasets[uid];
+  if (stats == nullptr) stats = std::make_shared<AsyncStats>();
+  return stats;
+}
+
+void AsyncStatsRegistry::forget(long uid) {
+  datasets.erase(uid);
+}
+
+void AsyncStatsRegistry::reset() {
+  methods.clear();
+  datasets.clear();
+}
+
+Local<Object> AsyncStatsRegistry::toObject() const {
+  Nan::EscapableHandleScope scope;
+  Local<Object> r = Nan::New<Object>();
+  Local<Object> m = Nan::New<Object>();
+  for (auto const &i : methods) Nan::Set(m, Nan::New(i.first).ToLocalChecked(), i.second->toObject());
+  Local<Object> d = Nan::New<Object>();
+  for (auto const &i : datasets) Nan::Set(d, Nan::New<Number>(static_cast<double>(i.first)), i.second->toObject());
+  Nan::Set(r, Nan::New("methods").ToLocalChecked(), m);
+  Nan::Set(r, Nan::New("datasets").ToLocalChecked(), d);
+  return scope.Escape(r);
+}
+
+StatsRecorder::StatsRecorder(const std::vector<long> &uids) : targets(), count(0) {
+  targets[count++] = async_stats.method(currentMethod);
+  for (long uid : uids)
+    if (uid != 0 && count < maxTargets) targets[count++] = async_stats.dataset(uid);
+}
+
+void StatsRecorder::complete(bool error) {
+  for (unsigned i = 0; i < count; i++) {
+    targets[i]->calls.fetch_add(1, std::memory_order_relaxed);
+    if (error) targets[i]->errors.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+} // namespace node_gdal
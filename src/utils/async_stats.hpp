@@ -0,0 +1,135 @@
+#ifndef __ASYNC_STATS_H__
+#define __ASYNC_STATS_H__
+
+// node
+#include <node.h>
+
+// nan
+#include "../nan-wrapper.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace v8;
+
+namespace node_gdal {
+
+// Monotonic time in microseconds
+inline uint64_t statsNow() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+}
+
+// A lock-free log-linear histogram of durations in microseconds
+//
+// The values below 16µs have their own bucket, above that every power
+// of 2 is divided in 4 buckets, giving a relative error of at most 25%
+//
+// It can be updated from any thread, it is read on the main thread
+class LatencyHistogram {
+    public:
+  static const int linear = 16;
+  static const int subBuckets = 4;
+  static const int maxExponent = 40;
+  static const int size = linear + (maxExponent - 4) * subBuckets;
+
+  LatencyHistogram();
+  void record(uint64_t us);
+  void reset();
+  Local<Object> toObject() const;
+
+    private:
+  std::atomic<uint64_t> buckets[size];
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> total;
+  std::atomic<uint64_t> max;
+
+  static int bucketOf(uint64_t us);
+  static uint64_t upperBound(int bucket);
+  uint64_t percentile(double p) const;
+};
+
+// The counters of a single method or a single Dataset
+struct AsyncStats {
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> errors;
+  // Waiting in the scheduler queues for a Dataset
+  LatencyHistogram queue;
+  // Waiting for a thread of the libuv pool
+  LatencyHistogram pool;
+  // Blocked on a Dataset lock (sync calls only, async jobs never block)
+  LatencyHistogram lock;
+  // Running GDAL
+  LatencyHistogram execute;
+  // Producing the JS return value on the main thread
+  LatencyHistogram rval;
+
+  AsyncStats();
+  Local<Object> toObject() const;
+};
+
+// The registry of all the counters
+//
+// The lookups happen on the main thread when a job is created, the jobs
+// keep a reference to their counters and update them from any thread
+// A reset creates new counters, the jobs still running update the old ones
+// Every isolate has its own registry
+class AsyncStatsRegistry {
+    public:
+  AsyncStatsRegistry();
+  std::shared_ptr<AsyncStats> method(const char *name);
+  std::shared_ptr<AsyncStats> dataset(long uid);
+  // Called when the Dataset is destroyed
+  void forget(long uid);
+  void reset();
+  Local<Object> toObject() const;
+
+    private:
+  // The method names are string literals, one per method
+  std::map<const char *, std::shared_ptr<AsyncStats>> methods;
+  std::map<long, std::shared_ptr<AsyncStats>> datasets;
+};
+
+extern thread_local AsyncStatsRegistry async_stats;
+
+// The counters updated by a single call: those of its method and those of its Datasets
+// Created on the main thread, record() can be called from any thread
+// Only the first Datasets of a job are counted, this keeps it allocation-free
+class StatsRecorder {
+    public:
+  StatsRecorder(const std::vector<long> &uids);
+  inline void record(LatencyHistogram AsyncStats::*histogram, uint64_t us) {
+    for (unsigned i = 0; i < count; i++) ((*targets[i]).*histogram).record(us);
+  }
+  void complete(bool error);
+
+    private:
+  static const unsigned maxTargets = 4;
+  std::shared_ptr<AsyncStats> targets[maxTargets];
+  unsigned count;
+};
+
+// The name of the method currently being called from JS, main thread only
+extern thread_local const char *currentMethod;
+
+// Sets currentMethod for the duration of a call
+class CurrentMethodScope {
+    public:
+  inline CurrentMethodScope(const char *name) : previous(currentMethod) {
+    currentMethod = name;
+  }
+  inline ~CurrentMethodScope() {
+    currentMethod = previous;
+  }
+
+    private:
+  const char *previous;
+};
+
+} // namespace node_gdal
+#endif
@@ -0,0 +1,285 @@
+#ifndef __BLOCK_REDUCER_H__
+#define __BLOCK_REDUCER_H__
+
+// gdal
+#include <gdal_priv.h>
+
+#include "../gdal_common.hpp"
+#include "../async.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace node_gdal {
+
+// The NaNs and the NoData value of a band are not valid
+struct NoDataFilter {
+  bool has_nodata;
+  double nodata;
+
+  NoDataFilter(GDALRasterBand *band) {
+    int success = 0;
+    nodata = band->GetNoDataValue(&success);
+    has_nodata = success != 0;
+    // GDAL compares the single precision values
+    if (has_nodata && band->GetRasterDataType() == GDT_Float32) nodata = static_cast<double>(static_cast<float>(nodata));
+  }
+  inline bool valid(double v) const {
+    return !std::isnan(v) && !(has_nodata && v == nodata);
+  }
+};
+
+// The statistics of a set of values, partial results are merged
+// with the pairwise formula of Chan et al.
+struct PartialStats {
+  uint64_t count;
+  double min, max, mean, m2;
+
+  PartialStats()
+    : count(0),
+      min(std::numeric_limits<double>::infinity()),
+      max(-std::numeric_limits<double>::infinity()),
+      mean(0),
+      m2(0) {
+  }
+
+  // Two passes over a buffer that is still in the CPU cache:
+  // count/sum/min/max, then the sum of the squared deviations
+  void reduce(const double *values, size_t length, const NoDataFilter &filter) {
+    PartialStats r;
+    double sum = 0;
+    for (size_t i = 0; i < length; i++) {
+      double v = values[i];
+      if (!filter.valid(v)) continue;
+      r.count++;
+      sum += v;
+      if (v < r.min) r.min = v;
+      if (v > r.max) r.max = v;
+    }
+    if (r.count == 0) return;
+    r.mean = sum / r.count;
+    for (size_t i = 0; i < length; i++) {
+      double v = values[i];
+      if (!filter.valid(v)) continue;
+      r.m2 += (v - r.mean) * (v - r.mean);
+    }
+    merge(r);
+  }
+
+  void merge(const PartialStats &o) {
+    if (o.count == 0) return;
+    if (count == 0) {
+      *this = o;
+      return;
+    }
+    double n = static_cast<double>(count + o.count);
+    double delta = o.mean - mean;
+    mean += delta * o.count / n;
+    m2 += o.m2 + delta * delta * count * o.count / n;
+    count += o.count;
+    if (o.min < min) min = o.min;
+    if (o.max > max) max = o.max;
+  }
+
+  inline double std_dev() const {
+    return count > 0 ? std::sqrt(m2 / count) : 0;
+  }
+};
+
+// The counts of the values in buckets of equal width between min and max
+// The last bucket is closed and includes max, the values out of range are
+// either counted in the first/last bucket or ignored
+struct PartialHistogram {
+  double min, max, scale;
+  bool include_out_of_range;
+  std::vector<uint64_t> counts;
+
+  PartialHistogram(double min, double max, int buckets, bool include_out_of_range)
+    : min(min),
+      max(max),
+      scale(buckets / (max - min)),
+      include_out_of_range(include_out_of_range),
+      counts(buckets, 0) {
+  }
+
+  // The bucket of a valid value, -1 if it is ignored
+  inline int bucket(double v) const {
+    int last = static_cast<int>(counts.size()) - 1;
+    if (v < min) return include_out_of_range ? 0 : -1;
+    if (v > max) return include_out_of_range ? last : -1;
+    int b = static_cast<int>((v - min) * scale);
+    return b > last ? last : b;
+  }
+
+  void reduce(const double *values, size_t length, const NoDataFilter &filter) {
+    for (size_t i = 0; i < length; i++) {
+      double v = values[i];
+      if (!filter.valid(v)) continue;
+      int b = bucket(v);
+      if (b >= 0) counts[b]++;
+    }
+  }
+
+  void merge(const PartialHistogram &o) {
+    for (size_t i = 0; i < counts.size(); i++) counts[i] += o.counts[i];
+  }
+};
+
+// Reads a window as doubles, the pixels that are invalid according to
+// a mask band (not a NoData mask) are replaced by NaN
+inline CPLErr readValues(
+  GDALRasterBand *band, int x, int y, int w, int h, bool masked, std::vector<double> &values, std::vector<GByte> &mask) {
+  size_t length = static_cast<size_t>(w) * h;
+  values.resize(length);
+  CPLErrorReset();
+  CPLErr err = band->RasterIO(GF_Read, x, y, w, h, values.data(), w, h, GDT_Float64, 0, 0, nullptr);
+  if (err == CE_None && masked) {
+    mask.resize(length);
+    err = band->GetMaskBand()->RasterIO(GF_Read, x, y, w, h, mask.data(), w, h, GDT_Byte, 0, 0, nullptr);
+    for (size_t j = 0; err == CE_None && j < length; j++)
+      if (mask[j] == 0) values[j] = std::numeric_limits<double>::quiet_NaN();
+  }
+  return err;
+}
+
+// Calls worker(GDALRasterBand *) on the job's own band and, concurrently, on the
+// same band of up to threads - 1 free handles of a pooled Dataset (see gdal.openPool)
+// Without free handles, the worker is called only once, in the calling thread
+template <typename Worker>
+void runOnPooledBands(long ds_uid, GDALRasterBand *own_band, int overview, size_t threads, const Worker &worker) {
+  std::vector<AsyncLock> locks;
+  std::vector<std::thread> pool;
+  try {
+    while (pool.size() + 1 < threads) {
+      GDALDataset *handle;
+      AsyncLock lock = object_store.tryLockPooledDataset(ds_uid, handle);
+      if (lock == nullptr) break;
+      locks.push_back(lock);
+      GDALRasterBand *band = handle == nullptr ? own_band : handle->GetRasterBand(own_band->GetBand());
+      if (overview >= 0) band = band->GetOverview(overview);
+      if (band == nullptr) break;
+      pool.emplace_back(worker, band);
+    }
+  } catch (const char *) {
+    // The Dataset is being destroyed, it will wait for us
+  }
+  worker(overview < 0 ? own_band : own_band->GetOverview(overview));
+  for (auto &t : pool) t.join();
+  if (!locks.empty()) object_store.unlockDatasets(locks);
+}
+
+// A window of a band, or of one of its overviews, reduced by block rows
+//
+// The block rows are distributed over the job's own handle and the free
+// handles of a pooled Dataset - without free handles this is a
+// single-threaded reducer
+// The values are read by readValues()
+// Partial must be copyable and have a merge(const Partial &) method,
+// every thread reduces into a copy of the initial value of result,
+// reduce(Partial &, const double *values, size_t length) is called for every
+// block row of the window
+// On failure, the error is the last CPL error of the calling thread
+template <typename Partial, typename Reduce>
+CPLErr reduceBlockRows(
+  const GDALExecutionProgress &progress,
+  long ds_uid,
+  GDALRasterBand *own_band,
+  int overview,
+  int x,
+  int y,
+  int w,
+  int h,
+  int parallel,
+  Partial &result,
+  const Reduce &reduce) {
+
+  GDALRasterBand *own = overview < 0 ? own_band : own_band->GetOverview(overview);
+  if (own == nullptr) {
+    CPLError(CE_Failure, CPLE_AppDefined, "Invalid overview");
+    return CE_Failure;
+  }
+  if (GDALDataTypeIsComplex(own->GetRasterDataType())) {
+    CPLError(CE_Failure, CPLE_NotSupported, "Complex data types are not supported");
+    return CE_Failure;
+  }
+  if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > own->GetXSize() || y + h > own->GetYSize()) {
+    CPLError(CE_Failure, CPLE_IllegalArg, "Invalid window");
+    return CE_Failure;
+  }
+  bool masked = !(own->GetMaskFlags() & (GMF_ALL_VALID | GMF_NODATA));
+
+  int block_w, block_h;
+  own->GetBlockSize(&block_w, &block_h);
+  if (block_h < 1) block_h = 1;
+  std::vector<std::pair<int, int>> strips;
+  for (int top = y; top < y + h;) {
+    // Cut on the next block boundary, counted from the top of the raster
+    int bottom = (top / block_h + 1) * block_h;
+    if (bottom > y + h) bottom = y + h;
+    strips.push_back({top, bottom});
+    top = bottom;
+  }
+
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  std::mutex lock;
+  std::string error;
+  const Partial empty = result;
+
+  auto fail = [&](const char *msg) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!failed) error = msg;
+    failed = true;
+  };
+  auto worker = [&](GDALRasterBand *band) {
+    std::vector<double> values;
+    std::vector<GByte> mask;
+    Partial local = empty;
+    size_t i;
+    while (!failed && (i = next++) < strips.size()) {
+      if (progress.isAborted()) {
+        fail(abortedError);
+        break;
+      }
+      int top = strips[i].first;
+      int rows = strips[i].second - top;
+      if (readValues(band, x, top, w, rows, masked, values, mask) != CE_None) {
+        fail(CPLGetLastErrorMsg());
+        break;
+      }
+      reduce(local, values.data(), values.size());
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    result.merge(local);
+  };
+
+  size_t threads = parallel > 1 ? std::min(static_cast<size_t>(parallel), strips.size()) : 1;
+  runOnPooledBands(ds_uid, own_band, overview, threads, worker);
+
+  if (failed) {
+    // Move the error message to this thread
+    if (error.empty()) error = "Failed reducing the raster band";
+    CPLError(CE_Failure, CPLE_AppDefined, "%s", error.c_str());
+    return CE_Failure;
+  }
+  return CE_None;
+}
+
+// The overview used by GDAL for the approximate statistics of a band, -1 for the full resolution
+inline int sampleOverview(GDALRasterBand *band) {
+  GDALRasterBand *sample = band->GetRasterSampleOverview(GDALSTAT_APPROX_NUMSAMPLES);
+  for (int i = 0; i < band->GetOverviewCount(); i++)
+    if (band->GetOverview(i) == sample) return i;
+  return -1;
+}
+
+} // namespace node_gdal
+#endif
@@ -0,0 +1,168 @@
+#ifndef __INLINE_FUNCTION_H__
+#define __INLINE_FUNCTION_H__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace node_gdal {
+
+// A replacement for std::function with a large inline buffer
+//
+// The lambdas of the GDALAsyncableJobs capture raw pointers and a few
+// small values, they fit in the buffer and creating, moving and calling
+// them does not allocate (std::function allocates for anything larger
+// than two pointers)
+//
+// Larger callables and callables that can throw when moved fall back to the heap
+template <typename Signature, size_t Capacity = 128> class InlineFunction;
+
+template <typename R, typename... Args, size_t Capacity> class InlineFunction<R(Args...), Capacity> {
+  typedef typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type Storage;
+
+  struct Ops {
+    R (*invoke)(void *, Args &&...);
+    void (*copy)(const void *, void *);
+    void (*move)(void *, void *);
+    void (*destroy)(void *);
+  };
+
+  // The callable lives in the buffer
+  template <typename F> struct Inline {
+    static R invoke(void *s, Args &&...args) {
+      return (*reinterpret_cast<F *>(s))(std::forward<Args>(args)...);
+    }
+    static void copy(const void *from, void *to) {
+      new (to) F(*reinterpret_cast<const F *>(from));
+    }
+    static void move(void *from, void *to) {
+      new (to) F(std::move(*reinterpret_cast<F *>(from)));
+    }
+    static void destroy(void *s) {
+      reinterpret_cast<F *>(s)->~F();
+    }
+    static const Ops ops;
+  };
+
+  // The buffer contains a pointer to the callable
+  template <typename F> struct Heap {
+    static F *&ptr(void *s) {
+      return *reinterpret_cast<F **>(s);
+    }
+    static R invoke(void *s, Args &&...args) {
+      return (*ptr(s))(std::forward<Args>(args)...);
+    }
+    static void copy(const void *from, void *to) {
+      new (to) F *(new F(**reinterpret_cast<F *const *>(from)));
+    }
+    static void move(void *from, void *to) {
+      new (to) F *(ptr(from));
+      ptr(from) = nullptr;
+    }
+    static void destroy(void *s) {
+      delete ptr(s);
+    }
+    static const Ops ops;
+  };
+
+  template <typename F>
+  using fitsInline = std::integral_constant<
+    bool,
+    sizeof(F) <= Capacity && alignof(Storage) % alignof(F) == 0 && std::is_nothrow_move_constructible<F>::value>;
+
+  template <typename F> void assign(F &&f, std::true_type) {
+    typedef typename std::decay<F>::type T;
+    new (&storage) T(std::forward<F>(f));
+    ops = &Inline<T>::ops;
+  }
+
+  template <typename F> void assign(F &&f, std::false_type) {
+    typedef typename std::decay<F>::type T;
+    new (&storage) T *(new T(std::forward<F>(f)));
+    ops = &Heap<T>::ops;
+  }
+
+  template <typename F>
+  using enableIfCallable =
+    typename std::enable_if<!std::is_same<typename std::decay<F>::type, InlineFunction>::value>::type;
+
+  Storage storage;
+  const Ops *ops;
+
+    public:
+  InlineFunction() noexcept : ops(nullptr) {
+  }
+
+  InlineFunction(std::nullptr_t) noexcept : ops(nullptr) {
+  }
+
+  template <typename F, typename = enableIfCallable<F>> InlineFunction(F &&f) : ops(nullptr) {
+    assign(std::forward<F>(f), fitsInline<typename std::decay<F>::type>());
+  }
+
+  InlineFunction(const InlineFunction &o) : ops(nullptr) {
+    if (o.ops == nullptr) return;
+    o.ops->copy(&o.storage, &storage);
+    ops = o.ops;
+  }
+
+  InlineFunction(InlineFunction &&o) noexcept : ops(nullptr) {
+    if (o.ops == nullptr) return;
+    o.ops->move(&o.storage, &storage);
+    ops = o.ops;
+    o.reset();
+  }
+
+  ~InlineFunction() {
+    reset();
+  }
+
+  InlineFunction &operator=(const InlineFunction &o) {
+    if (this != &o) *this = InlineFunction(o);
+    return *this;
+  }
+
+  InlineFunction &operator=(InlineFunction &&o) noexcept {
+    if (this == &o) return *this;
+    reset();
+    if (o.ops == nullptr) return *this;
+    o.ops->move(&o.storage, &storage);
+    ops = o.ops;
+    o.reset();
+    return *this;
+  }
+
+  template <typename F, typename = enableIfCallable<F>> InlineFunction &operator=(F &&f) {
+    reset();
+    assign(std::forward<F>(f), fitsInline<typename std::decay<F>::type>());
+    return *this;
+  }
+
+  inline R operator()(Args... args) const {
+    return ops->invoke(const_cast<Storage *>(&storage), std::forward<Args>(args)...);
+  }
+
+  inline explicit operator bool() const noexcept {
+    return ops != nullptr;
+  }
+
+  inline void reset() noexcept {
+    if (ops == nullptr) return;
+    ops->destroy(&storage);
+    ops = nullptr;
+  }
+};
+
+template <typename R, typename... Args, size_t Capacity>
+template <typename F>
+const typename InlineFunction<R(Args...), Capacity>::Ops InlineFunction<R(Args...), Capacity>::Inline<F>::ops = {
+  &Inline<F>::invoke, &Inline<F>::copy, &Inline<F>::move, &Inline<F>::destroy};
+
+template <typename R, typename... Args, size_t Capacity>
+template <typename F>
+const typename InlineFunction<R(Args...), Capacity>::Ops InlineFunction<R(Args...), Capacity>::Heap<F>::ops = {
+  &Heap<F>::invoke, &Heap<F>::copy, &Heap<F>::move, &Heap<F>::destroy};
+
+} // namespace node_gdal
+#endif
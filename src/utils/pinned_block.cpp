@@ -0,0 +1,134 @@
+#include "pinned_block.hpp"
+#include "typed_array.hpp"
+#include "../gdal_common.hpp"
+
+namespace node_gdal {
+
+thread_local std::unordered_map<long, std::list<PinnedBlock *>> PinnedBlock::pinned;
+thread_local Nan::Persistent<FunctionTemplate> PinnedBlock::releaseTemplate;
+std::mutex PinnedBlock::inflight_lock;
+std::unordered_multimap<long, GDALRasterBlock *> PinnedBlock::inflight;
+
+PinnedBlock::PinnedBlock(GDALRasterBlock *block, long ds_uid) : block(block), ds_uid(ds_uid), buffer(), band() {
+  std::list<PinnedBlock *> &list = pinned[ds_uid];
+  self = list.insert(list.end(), this);
+}
+
+PinnedBlock::~PinnedBlock() {
+  unpin();
+}
+
+void PinnedBlock::pin(GDALRasterBlock *block, long ds_uid) {
+  std::lock_guard<std::mutex> lock(inflight_lock);
+  inflight.emplace(ds_uid, block);
+}
+
+// Removes the block from the in-flight table, false if the Dataset has already
+// been closed and its lock dropped
+bool PinnedBlock::claim(GDALRasterBlock *block, long ds_uid) {
+  std::lock_guard<std::mutex> lock(inflight_lock);
+  auto range = inflight.equal_range(ds_uid);
+  for (auto i = range.first; i != range.second; i++) {
+    if (i->second == block) {
+      inflight.erase(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+Local<Value> PinnedBlock::New(GDALRasterBlock *block, Local<Object> band, long ds_uid) {
+  Nan::EscapableHandleScope scope;
+
+  if (!claim(block, ds_uid)) throw "Dataset object has already been destroyed";
+  if (!object_store.isAlive(ds_uid)) {
+    block->DropLock();
+    throw "Dataset object has already been destroyed";
+  }
+
+  GDALDataType type = block->GetDataType();
+  unsigned int length = block->GetXSize() * block->GetYSize();
+  Local<Object> array;
+  try {
+    array = TypedArray::New(type, block->GetDataRef(), length).As<Object>();
+  } catch (const char *) {
+    block->DropLock();
+    throw;
+  }
+
+  PinnedBlock *pb = new PinnedBlock(block, ds_uid);
+  pb->band.Reset(band);
+  pb->buffer.Reset(array.As<ArrayBufferView>()->Buffer());
+  pb->buffer.SetWeak(pb, weakCallback, Nan::WeakCallbackType::kParameter);
+
+  if (releaseTemplate.IsEmpty()) releaseTemplate.Reset(Nan::New<FunctionTemplate>(release));
+  Nan::SetPrivate(array, Nan::New("pinned_").ToLocalChecked(), Nan::New<External>(pb));
+  Nan::DefineOwnProperty(
+    array,
+    Nan::New("release").ToLocalChecked(),
+    Nan::GetFunction(Nan::New(releaseTemplate)).ToLocalChecked(),
+    static_cast<PropertyAttribute>(DontEnum));
+
+  return scope.Escape(array);
+}
+
+// The ArrayBuffer is not referenced anymore, nothing can access the block
+void PinnedBlock::weakCallback(const Nan::WeakCallbackInfo<PinnedBlock> &data) {
+  PinnedBlock *pb = data.GetParameter();
+  pb->buffer.Reset();
+  delete pb;
+}
+
+// Empties the ArrayBuffer so that JS cannot access the block anymore
+void PinnedBlock::detach() {
+  if (buffer.IsEmpty()) return;
+  Nan::HandleScope scope;
+  Local<ArrayBuffer> ab = Nan::New(buffer);
+  if (ab->IsDetachable()) ab->Detach();
+}
+
+void PinnedBlock::unpin() {
+  if (block == nullptr) return;
+  block->DropLock();
+  block = nullptr;
+  band.Reset();
+
+  auto list = pinned.find(ds_uid);
+  if (list == pinned.end()) return;
+  list->second.erase(self);
+  if (list->second.empty()) pinned.erase(list);
+}
+
+void PinnedBlock::releaseAll(long ds_uid) {
+  {
+    // The blocks locked by jobs whose result has not been delivered yet
+    std::lock_guard<std::mutex> lock(inflight_lock);
+    auto range = inflight.equal_range(ds_uid);
+    for (auto i = range.first; i != range.second; i++) i->second->DropLock();
+    inflight.erase(range.first, range.second);
+  }
+  // unpin() removes the element and the list with the last one
+  while (true) {
+    auto list = pinned.find(ds_uid);
+    if (list == pinned.end()) break;
+    PinnedBlock *pb = list->second.front();
+    pb->detach();
+    pb->unpin();
+  }
+}
+
+// The release() method of the arrays returned by RasterBandPixels.lockBlock()
+// Calling it more than once has no effect
+NAN_METHOD(PinnedBlock::release) {
+  Local<Value> ext;
+  if (!info.This()->IsObject() ||
+      !Nan::GetPrivate(info.This(), Nan::New("pinned_").ToLocalChecked()).ToLocal(&ext) || !ext->IsExternal()) {
+    Nan::ThrowError("Object is not a locked block");
+    return;
+  }
+  PinnedBlock *pb = reinterpret_cast<PinnedBlock *>(ext.As<External>()->Value());
+  pb->detach();
+  pb->unpin();
+}
+
+} // namespace node_gdal
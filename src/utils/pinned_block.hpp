@@ -0,0 +1,68 @@
+#ifndef __PINNED_BLOCK_H__
+#define __PINNED_BLOCK_H__
+
+// node
+#include <node.h>
+
+// nan
+#include "../nan-wrapper.h"
+
+// gdal
+#include <gdal_priv.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+using namespace v8;
+
+namespace node_gdal {
+
+// A block of the GDAL block cache exposed to JS without copying
+//
+// The block is locked with GetLockedBlockRef() so that the cache cannot evict it
+// and its memory is the backing store of an external ArrayBuffer
+// The lock is dropped when release() is called or when the Dataset is closed -
+// the ArrayBuffer is then detached and its views become empty - or when
+// the ArrayBuffer is collected by the GC
+//
+// The PinnedBlocks are per isolate, they are used only on the main thread
+//
+// Between the worker thread that locks the block and the main thread that wraps it,
+// the lock is in flight: it is registered in a process-wide table so that closing
+// the Dataset in the meantime can drop it
+class PinnedBlock {
+    public:
+  // Registers a freshly locked block, called in the worker thread with the Dataset lock held
+  static void pin(GDALRasterBlock *block, long ds_uid);
+  // Takes ownership of the lock of a block registered by pin() (called on the main thread)
+  // Throws if the Dataset has been closed in the meantime
+  static Local<Value> New(GDALRasterBlock *block, Local<Object> band, long ds_uid);
+  // Drops all the locks held on the blocks of a Dataset, called before closing it
+  static void releaseAll(long ds_uid);
+  static NAN_METHOD(release);
+
+    private:
+  PinnedBlock(GDALRasterBlock *block, long ds_uid);
+  ~PinnedBlock();
+  void detach();
+  void unpin();
+  static void weakCallback(const Nan::WeakCallbackInfo<PinnedBlock> &data);
+
+  GDALRasterBlock *block;
+  long ds_uid;
+  Nan::Persistent<ArrayBuffer> buffer;
+  // The RasterBand keeps its Dataset alive, it cannot be collected while there are pinned blocks
+  Nan::Persistent<Object> band;
+  std::list<PinnedBlock *>::iterator self;
+
+  static thread_local std::unordered_map<long, std::list<PinnedBlock *>> pinned;
+  static thread_local Nan::Persistent<FunctionTemplate> releaseTemplate;
+
+  static bool claim(GDALRasterBlock *block, long ds_uid);
+  static std::mutex inflight_lock;
+  static std::unordered_multimap<long, GDALRasterBlock *> inflight;
+};
+
+} // namespace node_gdal
+#endif
@@ -0,0 +1,241 @@
+#include "pixel_conversion.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace node_gdal {
+
+PixelConversion::PixelConversion()
+  : noData(false),
+    scaled(false),
+    hasNoDataValue(false),
+    noDataValue(0),
+    marker(std::numeric_limits<double>::quiet_NaN()),
+    scale(1),
+    offset(0) {
+}
+
+PixelConversion PixelConversion::forBand(GDALRasterBand *band) const {
+  PixelConversion r = *this;
+  int success = 0;
+  r.noDataValue = band->GetNoDataValue(&success);
+  r.hasNoDataValue = success != 0;
+  r.scale = band->GetScale(&success);
+  if (!success) r.scale = 1;
+  r.offset = band->GetOffset(&success);
+  if (!success) r.offset = 0;
+  return r;
+}
+
+// Can the value be stored in T without loss
+template <typename T> static bool representable(double v) {
+  if (std::is_floating_point<T>::value) {
+    return !std::isfinite(v) || std::fabs(v) <= static_cast<double>(std::numeric_limits<T>::max());
+  }
+  return std::isfinite(v) && v >= static_cast<double>(std::numeric_limits<T>::lowest()) &&
+    v <= static_cast<double>(std::numeric_limits<T>::max()) && v == std::floor(v);
+}
+
+enum class Match { None, NaN, Value };
+
+template <typename T, Match match, bool scaled>
+static inline T convertValue(T v, T from, T to, double a, double b) {
+  if (match == Match::NaN && v != v) return to;
+  if (match == Match::Value && v == from) return to;
+  if (scaled) return static_cast<T>(v * a + b);
+  return v;
+}
+
+// The contiguous rows are written as plain loops without data-dependent
+// branches so that the compiler can vectorize them (compare and blend)
+template <typename T, Match match, bool scaled>
+static void convertRows(uint8_t *data, int w, int h, int pixel_space, int line_space, T from, T to, double a, double b) {
+  for (int y = 0; y < h; y++) {
+    uint8_t *row = data + static_cast<ptrdiff_t>(y) * line_space;
+    if (pixel_space == sizeof(T)) {
+      T *p = reinterpret_cast<T *>(row);
+      for (int x = 0; x < w; x++) p[x] = convertValue<T, match, scaled>(p[x], from, to, a, b);
+    } else {
+      for (int x = 0; x < w; x++) {
+        T *p = reinterpret_cast<T *>(row + static_cast<ptrdiff_t>(x) * pixel_space);
+        *p = convertValue<T, match, scaled>(*p, from, to, a, b);
+      }
+    }
+  }
+}
+
+template <typename T>
+static void convert(
+  uint8_t *data,
+  int w,
+  int h,
+  int pixel_space,
+  int line_space,
+  bool hasFrom,
+  double from,
+  double to,
+  bool scaled,
+  double a,
+  double b) {
+  if (scaled && !std::is_floating_point<T>::value) {
+    throw "Applying the scale and offset requires a floating point data type";
+  }
+
+  Match match = Match::None;
+  if (hasFrom) {
+    if (std::isnan(from))
+      match = std::is_floating_point<T>::value ? Match::NaN : Match::None;
+    else if (representable<T>(from))
+      match = Match::Value;
+    // else no pixel can have this value
+  }
+  if (match != Match::None && !representable<T>(to)) throw "The NoData value cannot be represented in the data type";
+
+  T tFrom = match == Match::Value ? static_cast<T>(from) : T();
+  T tTo = match != Match::None ? static_cast<T>(to) : T();
+  switch (match) {
+    case Match::None:
+      if (scaled) convertRows<T, Match::None, true>(data, w, h, pixel_space, line_space, tFrom, tTo, a, b);
+      break;
+    case Match::NaN:
+      if (scaled)
+        convertRows<T, Match::NaN, true>(data, w, h, pixel_space, line_space, tFrom, tTo, a, b);
+      else
+        convertRows<T, Match::NaN, false>(data, w, h, pixel_space, line_space, tFrom, tTo, a, b);
+      break;
+    case Match::Value:
+      if (scaled)
+        convertRows<T, Match::Value, true>(data, w, h, pixel_space, line_space, tFrom, tTo, a, b);
+      else
+        convertRows<T, Match::Value, false>(data, w, h, pixel_space, line_space, tFrom, tTo, a, b);
+      break;
+  }
+}
+
+static void convert(
+  void *data,
+  GDALDataType type,
+  int w,
+  int h,
+  int pixel_space,
+  int line_space,
+  bool hasFrom,
+  double from,
+  double to,
+  bool scaled,
+  double a,
+  double b) {
+  uint8_t *p = reinterpret_cast<uint8_t *>(data);
+  switch (type) {
+    case GDT_Byte: convert<uint8_t>(p, w, h, pixel_space, line_space, hasFrom, from, to, scaled, a, b); break;
+    case GDT_Int16: convert<int16_t>(p, w, h, pixel_space, line_space, hasFrom, from, to, scaled, a, b); break;
+    case GDT_UInt16: convert<uint16_t>(p, w, h, pixel_space, line_space, hasFrom, from, to, scaled, a, b); break;
+    case GDT_Int32: convert<int32_t>(p, w, h, pixel_space, line_space, hasFrom, from, to, scaled, a, b); break;
+    case GDT_UInt32: convert<uint32_t>(p, w, h, pixel_space, line_space, hasFrom, from, to, scaled, a, b); break;
+    case GDT_Float32: convert<float>(p, w, h, pixel_space, line_space, hasFrom, from, to, scaled, a, b); break;
+    case GDT_Float64: convert<double>(p, w, h, pixel_space, line_space, hasFrom, from, to, scaled, a, b); break;
+    default: throw "Unsupported data type for the NoData and scale conversion";
+  }
+}
+
+void unpackPixels(
+  const PixelConversion &conv,
+  void *data,
+  GDALDataType type,
+  int buffer_w,
+  int buffer_h,
+  int pixel_space,
+  int line_space) {
+  if (!conv.active()) return;
+  convert(
+    data,
+    type,
+    buffer_w,
+    buffer_h,
+    pixel_space,
+    line_space,
+    conv.noData && conv.hasNoDataValue,
+    conv.noDataValue,
+    conv.marker,
+    conv.scaled,
+    conv.scale,
+    conv.offset);
+}
+
+void packPixels(
+  const PixelConversion &conv,
+  void *data,
+  GDALDataType type,
+  int buffer_w,
+  int buffer_h,
+  int pixel_space,
+  int line_space) {
+  if (!conv.active()) return;
+  if (conv.scaled && conv.scale == 0) throw "The scale of the band is 0";
+  convert(
+    data,
+    type,
+    buffer_w,
+    buffer_h,
+    pixel_space,
+    line_space,
+    conv.noData && conv.hasNoDataValue,
+    conv.marker,
+    conv.noDataValue,
+    conv.scaled,
+    1 / conv.scale,
+    -conv.offset / conv.scale);
+}
+
+template <typename T> static void noDataMask(const T *data, size_t length, double noDataValue, uint8_t *mask) {
+  if (std::isnan(noDataValue)) {
+    for (size_t i = 0; i < length; i++) mask[i] = data[i] != data[i] ? 0 : 255;
+    return;
+  }
+  if (!representable<T>(noDataValue)) {
+    memset(mask, 255, length);
+    return;
+  }
+  T nd = static_cast<T>(noDataValue);
+  for (size_t i = 0; i < length; i++) mask[i] = data[i] == nd ? 0 : 255;
+}
+
+void noDataMask(const void *data, GDALDataType type, size_t length, double noDataValue, uint8_t *mask) {
+  switch (type) {
+    case GDT_Byte: noDataMask(reinterpret_cast<const uint8_t *>(data), length, noDataValue, mask); break;
+    case GDT_Int16: noDataMask(reinterpret_cast<const int16_t *>(data), length, noDataValue, mask); break;
+    case GDT_UInt16: noDataMask(reinterpret_cast<const uint16_t *>(data), length, noDataValue, mask); break;
+    case GDT_Int32: noDataMask(reinterpret_cast<const int32_t *>(data), length, noDataValue, mask); break;
+    case GDT_UInt32: noDataMask(reinterpret_cast<const uint32_t *>(data), length, noDataValue, mask); break;
+    case GDT_Float32: noDataMask(reinterpret_cast<const float *>(data), length, noDataValue, mask); break;
+    case GDT_Float64: noDataMask(reinterpret_cast<const double *>(data), length, noDataValue, mask); break;
+    default: throw "Unsupported data type for the NoData mask";
+  }
+}
+
+template <typename T> static void premultiplyPixels(T *data, size_t length, const uint8_t *mask) {
+  if (std::is_floating_point<T>::value) {
+    for (size_t i = 0; i < length; i++) data[i] = static_cast<T>(data[i] * (mask[i] / 255.0));
+  } else {
+    for (size_t i = 0; i < length; i++) data[i] = static_cast<T>(std::round(data[i] * (mask[i] / 255.0)));
+  }
+}
+
+void premultiplyPixels(void *data, GDALDataType type, size_t length, const uint8_t *mask) {
+  switch (type) {
+    case GDT_Byte: premultiplyPixels(reinterpret_cast<uint8_t *>(data), length, mask); break;
+    case GDT_Int16: premultiplyPixels(reinterpret_cast<int16_t *>(data), length, mask); break;
+    case GDT_UInt16: premultiplyPixels(reinterpret_cast<uint16_t *>(data), length, mask); break;
+    case GDT_Int32: premultiplyPixels(reinterpret_cast<int32_t *>(data), length, mask); break;
+    case GDT_UInt32: premultiplyPixels(reinterpret_cast<uint32_t *>(data), length, mask); break;
+    case GDT_Float32: premultiplyPixels(reinterpret_cast<float *>(data), length, mask); break;
+    case GDT_Float64: premultiplyPixels(reinterpret_cast<double *>(data), length, mask); break;
+    default: throw "Unsupported data type for premultiplying";
+  }
+}
+
+} // namespace node_gdal
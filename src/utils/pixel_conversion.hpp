@@ -0,0 +1,69 @@
+#ifndef __PIXEL_CONVERSION_H__
+#define __PIXEL_CONVERSION_H__
+
+// gdal
+#include <gdal_priv.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace node_gdal {
+
+// A per-pixel transformation applied to a RasterIO buffer in the worker thread
+//
+// When reading, the NoData value of the band is replaced by a marker
+// (usually NaN) and the other values are unpacked with the scale and
+// offset of the band
+// When writing, the marker is replaced by the NoData value of the band
+// and the other values are packed with the inverse transformation
+//
+// The values of the band are retrieved by the job from the band it runs on
+struct PixelConversion {
+  // Replace the NoData values
+  bool noData;
+  // Apply the scale/offset
+  bool scaled;
+  // The NoData value of the band, only when it has one
+  bool hasNoDataValue;
+  double noDataValue;
+  // The value representing NoData in the buffer
+  double marker;
+  double scale;
+  double offset;
+
+  PixelConversion();
+  inline bool active() const {
+    return noData || scaled;
+  }
+  // A copy with the NoData value, the scale and the offset of the band
+  PixelConversion forBand(GDALRasterBand *band) const;
+};
+
+// These throw a const char * when the conversion cannot be applied to the data type
+//
+// band value -> buffer value
+void unpackPixels(
+  const PixelConversion &conv,
+  void *data,
+  GDALDataType type,
+  int buffer_w,
+  int buffer_h,
+  int pixel_space,
+  int line_space);
+// buffer value -> band value
+void packPixels(
+  const PixelConversion &conv,
+  void *data,
+  GDALDataType type,
+  int buffer_w,
+  int buffer_h,
+  int pixel_space,
+  int line_space);
+
+// The validity mask of contiguous pixels of the band data type: 0 for NoData, 255 for valid pixels
+void noDataMask(const void *data, GDALDataType type, size_t length, double noDataValue, uint8_t *mask);
+// Multiplies contiguous pixels by mask / 255
+void premultiplyPixels(void *data, GDALDataType type, size_t length, const uint8_t *mask);
+
+} // namespace node_gdal
+#endif
@@ -6,13 +6,16 @@
 #include "../gdal_attribute.hpp"
 #include "../gdal_layer.hpp"
 #include "../gdal_rasterband.hpp"
+#include "../async.hpp"
+#include "pinned_block.hpp"
+#include "tile_renderer.hpp"
 
 #include <sstream>
 #include <thread>
 
 // Here used to be dragons, but now there is a shopping mall
 //
-// This is the object store, a singleton
+// This is the object store, a singleton shared by all the V8 isolates (worker_threads)
 //
 // It serves 2 purposes:
 //
@@ -22,39 +25,55 @@
 // For this use, the V8 objects are indexed with the pointer to the GDAL
 // base object
 // uids won't work for this use
+// Every isolate has its own JS objects, so these ptr maps are per isolate
+// (an isolate always runs on the same thread, they are thread_local)
 //
 // Second, it is allocated entirely outside of the V8 memory management and the GC
 // Thus, it is accessible from the worker threads
 // The async locks live here
 // For this use, the V8 objects are indexed with numeric uids
 // ptrs won't be safe for this use
+// The uids are unique across all the isolates and the uid table with
+// the Dataset locks is shared by the whole process
 
 // Async lock semantics:
 //
-// * There is one global master lock, all operations on the ObjectStore structures
-//   must acquire it
-// * There is one async lock per dataset and it is a semaphore because it needs
+// * The uid table is split in shards, each one with its own lock, looking up
+//   a uid locks only its shard - this is the only structure used by the worker threads
+// * There is one global master lock that protects the ptr maps and the
+//   parent/children relations, only the main threads of the isolates (that create,
+//   reuse and destroy the objects) acquire it
+// * There is one async lock per dataset, a DatasetLock, because it needs
 //   to support being acquired by the main thread and being unlocked in a worker
-// * Sync operations can sleep on the semaphore as only the main thread can
-//   delete a semaphore
-// * Async operations should sleep on the master_sleep condition as semaphores
-//   can be deleted by the main thread (but this would also mean that someone forgot
-//   to protect his object from the GC)
+// * Every DatasetLock has its own wait queue, a thread sleeping on a Dataset
+//   is woken up only when this Dataset is released and the waiters are
+//   served in FIFO order
+// * The DatasetLock is found in the uid table, then the shard lock is released
+//   before sleeping on the DatasetLock - the shared_ptr keeps it alive
+// * The Dataset could have been destroyed after being found, so disposed must be
+//   checked again after acquiring the DatasetLock - this applies to the non-blocking
+//   tryLock* methods too
 //   - Failing to protect an object from the GC means that GC could potentially sleep
-//   on a semaphore when disposing
+//   on a DatasetLock when disposing
 //   - GC that sleeps -> event loop that does run
-// * Acquiring a semaphore requires acquiring the master look otherwise the
-//   semaphore may disappear
-// * When waking from master_sleep, the presence of the semaphore (isAlive) must be
-//   checked again
-// * When unlocking a semaphore, the master_sleep condition is to be broadcasted
-// * Never acquire the master lock while holding a semaphore (deadlock avoidance)
-// * Multiple datasets are to be locked with .lockDataset which sorts locks (deadlock avoidance)
+// * When unlocking a DatasetLock, the AsyncSchedulers are to be woken up - except when
+//   rolling back a failed multi-lock attempt, unless another attempt has failed on it meanwhile
+// * Async jobs never sleep on a DatasetLock, the AsyncScheduler acquires their locks
+//   on the main thread with tryLockDatasets and hands them to libuv only when
+//   they can run (see async.hpp), the worker thread releases them
+// * Never acquire the master lock while holding a DatasetLock (deadlock avoidance),
+//   dispose is the only exception as it holds the master lock while waiting
+//   for a DatasetLock, but releasing a DatasetLock never requires the master lock
+// * Multiple datasets are to be locked with .lockDatasets which always acquires
+//   the locks in the same order (deadlock avoidance)
 // * Never sleep with the master lock held (performance)
 // * All objects carry the dataset uid
 // * All GDAL operations on a dependant object require locking the parent dataset
 // - This is best accomplished though .lockDataset
-// * Dependant Datasets share a semaphore with their parent through a shared_ptr
+// * Dependant Datasets share a DatasetLock with their parent through a shared_ptr
+// * A pooled Dataset has additional read-only handles, each one with its own DatasetLock,
+//   a job that can run on any handle acquires the first free one with tryLockPooledDataset,
+//   all other operations use only the main handle and its DatasetLock
 
 namespace node_gdal {
 
@@ -62,15 +81,59 @@ namespace node_gdal {
 // these two must be here and must have file scope
 // MSVC throws an Internal Compiler Error when specializing templated variables
 // and the linker doesn't use the right address when processing exported symbols
-template <typename GDALPTR> using UidMap = map<long, shared_ptr<ObjectStoreItem<GDALPTR>>>;
-template <typename GDALPTR> using PtrMap = map<GDALPTR, shared_ptr<ObjectStoreItem<GDALPTR>>>;
-template <typename GDALPTR> static UidMap<GDALPTR> uidMap;
-template <typename GDALPTR> static PtrMap<GDALPTR> ptrMap;
+// The ptr maps are per isolate, a thread_local template variable is not
+// dynamically initialized by g++, they are function-scope statics
+template <typename GDALPTR> using PtrMap = unordered_map<GDALPTR, shared_ptr<ObjectStoreItem<GDALPTR>>>;
+template <typename GDALPTR> static PtrMap<GDALPTR> &ptrMap() {
+  static thread_local PtrMap<GDALPTR> map;
+  return map;
+}
+
+// The unified uid table, every uid maps to its item and its type
+struct UidEntry {
+  ObjectStoreType type;
+  shared_ptr<void> item;
+};
 
-void uv_sem_deleter::operator()(uv_sem_t *p) {
-  uv_sem_destroy(p);
-  delete p;
+struct UidShard {
+  uv_mutex_t lock;
+  unordered_map<long, UidEntry> map;
+};
+
+static const long uidShards = 16;
+
+static inline ObjectStoreType typeOf(GDALDriver *) {
+  return ObjectStoreType::Driver;
+}
+static inline ObjectStoreType typeOf(GDALDataset *) {
+  return ObjectStoreType::Dataset;
+}
+static inline ObjectStoreType typeOf(OGRLayer *) {
+  return ObjectStoreType::Layer;
+}
+static inline ObjectStoreType typeOf(GDALRasterBand *) {
+  return ObjectStoreType::RasterBand;
+}
+static inline ObjectStoreType typeOf(OGRSpatialReference *) {
+  return ObjectStoreType::SpatialReference;
+}
+static inline ObjectStoreType typeOf(GDALColorTable *) {
+  return ObjectStoreType::ColorTable;
+}
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
+static inline ObjectStoreType typeOf(const shared_ptr<GDALGroup> &) {
+  return ObjectStoreType::Group;
 }
+static inline ObjectStoreType typeOf(const shared_ptr<GDALMDArray> &) {
+  return ObjectStoreType::MDArray;
+}
+static inline ObjectStoreType typeOf(const shared_ptr<GDALDimension> &) {
+  return ObjectStoreType::Dimension;
+}
+static inline ObjectStoreType typeOf(const shared_ptr<GDALAttribute> &) {
+  return ObjectStoreType::Attribute;
+}
+#endif
 
 class uv_scoped_mutex {
     public:
@@ -85,7 +148,45 @@ class uv_scoped_mutex {
   uv_mutex_t *lock;
 };
 
-ObjectStore::ObjectStore() : uid(1) {
+DatasetLock::DatasetLock() : next_ticket(0), now_serving(0), contended(false) {
+  uv_mutex_init(&mutex);
+  uv_cond_init(&cond);
+}
+
+DatasetLock::~DatasetLock() {
+  uv_mutex_destroy(&mutex);
+  uv_cond_destroy(&cond);
+}
+
+// Take a ticket and sleep until it is served
+void DatasetLock::lock() {
+  uv_scoped_mutex lock(&mutex);
+  unsigned long ticket = next_ticket++;
+  while (ticket != now_serving) uv_cond_wait(&cond, &mutex);
+}
+
+// Take a ticket only if it can be served right away
+bool DatasetLock::tryLock() {
+  uv_scoped_mutex lock(&mutex);
+  if (next_ticket != now_serving) {
+    contended = true;
+    return false;
+  }
+  next_ticket++;
+  return true;
+}
+
+// Serve the next ticket, only the threads waiting on this lock wake up
+bool DatasetLock::unlock() {
+  uv_scoped_mutex lock(&mutex);
+  now_serving++;
+  uv_cond_broadcast(&cond);
+  bool missed = contended;
+  contended = false;
+  return missed;
+}
+
+ObjectStore::ObjectStore() : uid(1), uid_table(new UidShard[uidShards]) {
 #ifdef PTHREAD_MUTEX_DEBUG
   pthread_mutexattr_t attr;
   pthread_mutexattr_init(&attr);
@@ -94,23 +195,46 @@ ObjectStore::ObjectStore() : uid(1) {
 #else
   uv_mutex_init(&master_lock);
 #endif
-  uv_cond_init(&master_sleep);
+  for (long i = 0; i < uidShards; i++) uv_mutex_init(&uid_table[i].lock);
 }
 
 ObjectStore::~ObjectStore() {
   uv_mutex_destroy(&master_lock);
-  uv_cond_destroy(&master_sleep);
+  for (long i = 0; i < uidShards; i++) uv_mutex_destroy(&uid_table[i].lock);
+  delete[] uid_table;
+}
+
+// uids are sequential, consecutive objects land in different shards
+UidShard &ObjectStore::shard(long uid) {
+  return uid_table[uid % uidShards];
+}
+
+void ObjectStore::insertUid(long uid, ObjectStoreType type, shared_ptr<void> item) {
+  UidShard &s = shard(uid);
+  uv_scoped_mutex lock(&s.lock);
+  s.map[uid] = {type, item};
+}
+
+void ObjectStore::eraseUid(long uid) {
+  UidShard &s = shard(uid);
+  uv_scoped_mutex lock(&s.lock);
+  s.map.erase(uid);
+}
+
+// Returns nullptr if the uid does not exist or if it is of another type
+template <typename GDALPTR> shared_ptr<ObjectStoreItem<GDALPTR>> ObjectStore::lookup(long uid) {
+  UidShard &s = shard(uid);
+  uv_scoped_mutex lock(&s.lock);
+  auto entry = s.map.find(uid);
+  if (entry == s.map.end() || entry->second.type != typeOf(GDALPTR())) return nullptr;
+  return static_pointer_cast<ObjectStoreItem<GDALPTR>>(entry->second.item);
 }
 
 bool ObjectStore::isAlive(long uid) {
   if (uid == 0) return true;
-  return uidMap<GDALRasterBand *>.count(uid) > 0 || uidMap<OGRLayer *>.count(uid) > 0 ||
-    uidMap<GDALDataset *>.count(uid) > 0 || uidMap<GDALColorTable *>.count(uid)
-#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
-    || uidMap<shared_ptr<GDALGroup>>.count(uid) > 0 || uidMap<shared_ptr<GDALMDArray>>.count(uid) > 0 ||
-    uidMap<shared_ptr<GDALDimension>>.count(uid) > 0 || uidMap<shared_ptr<GDALAttribute>>.count(uid) > 0
-#endif
-    ;
+  UidShard &s = shard(uid);
+  uv_scoped_mutex lock(&s.lock);
+  return s.map.count(uid) > 0;
 }
 
 static inline void sortUnique(vector<long> &uids) {
@@ -121,21 +245,33 @@ static inline void sortUnique(vector<long> &uids) {
   if (uids.front() == 0) uids.erase(uids.begin());
 }
 
+// Dependant Datasets share the lock of their parent, lock each lock only once
+// and always in the same order (deadlock avoidance)
+static inline void sortUniqueLocks(vector<AsyncLock> &locks) {
+  sort(locks.begin(), locks.end());
+  locks.erase(unique(locks.begin(), locks.end()), locks.end());
+}
+
+// Find a Dataset by uid, throws when the Dataset has been destroyed
+shared_ptr<ObjectStoreItem<GDALDataset *>> ObjectStore::findDataset(long uid) {
+  auto item = lookup<GDALDataset *>(uid);
+  if (item == nullptr) { throw "Parent Dataset object has already been destroyed"; }
+  return item;
+}
+
 /*
  * Lock a Dataset by uid, throws when the Dataset has been destroyed
- * There is a single global condition which allows to avoid active spinning
- * Every time a Dataset releases a lock it must broadcast the condition
+ * The thread sleeps in the wait queue of this Dataset
  */
 AsyncLock ObjectStore::lockDataset(long uid) {
   if (uid == 0) return nullptr;
-  uv_scoped_mutex lock(&master_lock);
-  while (true) {
-    auto parent = uidMap<GDALDataset *>.find(uid);
-    if (parent == uidMap<GDALDataset *>.end()) { throw "Parent Dataset object has already been destroyed"; }
-    int r = uv_sem_trywait(parent->second->async_lock.get());
-    if (r == 0) { return parent->second->async_lock; }
-    uv_cond_wait(&master_sleep, &master_lock);
+  shared_ptr<ObjectStoreItem<GDALDataset *>> item = findDataset(uid);
+  item->async_lock->lock();
+  if (item->disposed) {
+    unlockDataset(item->async_lock);
+    throw "Parent Dataset object has already been destroyed";
   }
+  return item->async_lock;
 }
 
 /*
@@ -145,14 +281,34 @@ vector<AsyncLock> ObjectStore::lockDatasets(vector<long> uids) {
   // There is lots of copying around here but these vectors are never longer than 3 elements
   sortUnique(uids);
   if (uids.size() == 0) return {};
-  uv_scoped_mutex lock(&master_lock);
-  while (true) {
-    try {
-      vector<AsyncLock> locks = _tryLockDatasets(uids);
-      if (locks.size() > 0) { return locks; }
-    } catch (const char *msg) { throw msg; }
-    uv_cond_wait(&master_sleep, &master_lock);
+  vector<shared_ptr<ObjectStoreItem<GDALDataset *>>> items;
+  vector<AsyncLock> locks;
+  for (long uid : uids) {
+    items.push_back(findDataset(uid));
+    locks.push_back(items.back()->async_lock);
+  }
+  sortUniqueLocks(locks);
+  for (const AsyncLock &l : locks) l->lock();
+  for (auto const &item : items) {
+    if (item->disposed) {
+      unlockDatasets(locks);
+      throw "Parent Dataset object has already been destroyed";
+    }
   }
+  return locks;
+}
+
+/*
+ * Release a lock, wake up the threads waiting for it and the async schedulers
+ */
+void ObjectStore::unlockDataset(AsyncLock lock) {
+  lock->unlock();
+  AsyncScheduler::wakeupAll();
+}
+
+void ObjectStore::unlockDatasets(vector<AsyncLock> locks) {
+  for (const AsyncLock &l : locks) l->unlock();
+  AsyncScheduler::wakeupAll();
 }
 
 /*
@@ -160,37 +316,50 @@ vector<AsyncLock> ObjectStore::lockDatasets(vector<long> uids) {
  */
 AsyncLock ObjectStore::tryLockDataset(long uid) {
   if (uid == 0) return nullptr;
-  uv_scoped_mutex lock(&master_lock);
-  auto parent = uidMap<GDALDataset *>.find(uid);
-  if (parent == uidMap<GDALDataset *>.end()) { throw "Parent Dataset object has already been destroyed"; }
-  int r = uv_sem_trywait(parent->second->async_lock.get());
-  if (r == 0) return parent->second->async_lock;
-  return nullptr;
+  auto item = findDataset(uid);
+  if (!item->async_lock->tryLock()) return nullptr;
+  if (item->disposed) {
+    unlockDataset(item->async_lock);
+    throw "Parent Dataset object has already been destroyed";
+  }
+  return item->async_lock;
+}
+
+// Release the locks taken by a failed attempt, the async schedulers are woken up
+// only if one of them has failed to acquire one of these locks in the meantime,
+// otherwise a scheduler retrying a contended job would wake itself up in a loop
+static inline void rollbackLocks(const vector<AsyncLock> &locks) {
+  bool missed = false;
+  for (const AsyncLock &l : locks) missed |= l->unlock();
+  if (missed) AsyncScheduler::wakeupAll();
 }
 
 vector<AsyncLock> ObjectStore::_tryLockDatasets(vector<long> uids) {
+  vector<shared_ptr<ObjectStoreItem<GDALDataset *>>> items;
   vector<AsyncLock> locks;
   for (long uid : uids) {
-    auto parent = uidMap<GDALDataset *>.find(uid);
-    if (parent == uidMap<GDALDataset *>.end()) { throw "Parent Dataset object has already been destroyed"; }
-    locks.push_back(parent->second->async_lock);
+    items.push_back(findDataset(uid));
+    locks.push_back(items.back()->async_lock);
   }
+  sortUniqueLocks(locks);
   vector<AsyncLock> locked;
-  int r = 0;
-  for (AsyncLock &async_lock : locks) {
-    r = uv_sem_trywait(async_lock.get());
-    if (r == 0) {
+  for (const AsyncLock &async_lock : locks) {
+    if (async_lock->tryLock()) {
       locked.push_back(async_lock);
     } else {
       // We failed acquiring one of the locks =>
       // free all acquired locks and start a new cycle
-      for (AsyncLock &lock : locked) { uv_sem_post(lock.get()); }
-      uv_cond_broadcast(&master_sleep);
-      break;
+      rollbackLocks(locked);
+      return {};
     }
   }
-  if (r == 0) return locks;
-  return {};
+  for (auto const &item : items) {
+    if (item->disposed) {
+      rollbackLocks(locked);
+      throw "Parent Dataset object has already been destroyed";
+    }
+  }
+  return locked;
 }
 
 /*
@@ -200,14 +369,52 @@ vector<AsyncLock> ObjectStore::tryLockDatasets(vector<long> uids) {
   // There is lots of copying around here but these vectors are never longer than 3 elements
   sortUnique(uids);
   if (uids.size() == 0) return {};
-  uv_scoped_mutex lock(&master_lock);
   return _tryLockDatasets(uids);
 }
 
+/*
+ * Attach additional read-only handles to a Dataset
+ */
+void ObjectStore::addPool(long uid, const vector<GDALDataset *> &handles) {
+  uv_scoped_mutex lock(&master_lock);
+  auto item = findDataset(uid);
+  for (GDALDataset *handle : handles) {
+    item->pool.push_back(handle);
+    item->pool_locks.push_back(make_shared<DatasetLock>());
+  }
+}
+
+/*
+ * Acquire the lock of any free handle of a Dataset, do not block
+ * handle is set to the acquired pooled handle or to nullptr for the main handle
+ */
+AsyncLock ObjectStore::tryLockPooledDataset(long uid, GDALDataset *&handle) {
+  handle = nullptr;
+  if (uid == 0) return nullptr;
+  auto item = findDataset(uid);
+  AsyncLock acquired = nullptr;
+  if (item->async_lock->tryLock()) {
+    acquired = item->async_lock;
+  } else {
+    for (size_t i = 0; i < item->pool.size(); i++) {
+      if (item->pool_locks[i]->tryLock()) {
+        handle = item->pool[i];
+        acquired = item->pool_locks[i];
+        break;
+      }
+    }
+  }
+  if (acquired != nullptr && item->disposed) {
+    unlockDataset(acquired);
+    throw "Parent Dataset object has already been destroyed";
+  }
+  return acquired;
+}
+
 // The basic unit of the ObjectStore is the ObjectStoreItem<GDALPTR>
 // There is only one such item per GDALPTR
 // There are two shared_ptr to it:
-// * one in the uidMap
+// * one in the uid table
 // * one in the ptrMap
 // There is alo a reference to the Persistent in Nan::ObjectWrap
 // This is a Weak Persistent and Nan::ObjectWrap will call the C++ destructor
@@ -215,26 +422,26 @@ vector<AsyncLock> ObjectStore::tryLockDatasets(vector<long> uids) {
 
 template <typename GDALPTR> ObjectStoreItem<GDALPTR>::ObjectStoreItem(Nan::Persistent<Object> &obj) : obj(obj) {
 }
-ObjectStoreItem<GDALDataset *>::ObjectStoreItem(Nan::Persistent<Object> &obj) : obj(obj) {
+ObjectStoreItem<GDALDataset *>::ObjectStoreItem(Nan::Persistent<Object> &obj) : obj(obj), disposed(false) {
 }
 ObjectStoreItem<OGRLayer *>::ObjectStoreItem(Nan::Persistent<Object> &obj) : obj(obj) {
 }
 
 template <typename GDALPTR> long ObjectStore::add(GDALPTR ptr, Nan::Persistent<Object> &obj, long parent_uid) {
   uv_scoped_mutex lock(&master_lock);
+  // A child without its parent would get its own DatasetLock while there must be
+  // only one per GDAL handle, returns 0 if the parent has already been destroyed
+  // (this is called from V8 frames, the callers throw the JS exception)
+  shared_ptr<ObjectStoreItem<GDALDataset *>> parent = parent_uid ? lookup<GDALDataset *>(parent_uid) : nullptr;
+  if (parent_uid && parent == nullptr) return 0;
   shared_ptr<ObjectStoreItem<GDALPTR>> item(new ObjectStoreItem<GDALPTR>(obj));
   item->uid = uid++;
-  if (parent_uid) {
-    shared_ptr<ObjectStoreItem<GDALDataset *>> parent = uidMap<GDALDataset *>[parent_uid];
-    item->parent = parent;
-    parent->children.push_back(item->uid);
-  } else {
-    item->parent = nullptr;
-  }
+  item->parent = parent;
+  if (parent != nullptr) parent->children.push_back(item->uid);
   item->ptr = ptr;
 
-  uidMap<GDALPTR>[item->uid] = item;
-  ptrMap<GDALPTR>[ptr] = item;
+  insertUid(item->uid, typeOf(ptr), item);
+  ptrMap<GDALPTR>()[ptr] = item;
   LOG("ObjectStore: Add %s [%ld]<[%ld]", typeid(ptr).name(), item->uid, parent_uid);
   return item->uid;
 }
@@ -242,7 +449,8 @@ template <typename GDALPTR> long ObjectStore::add(GDALPTR ptr, Nan::Persistent<O
 // Creating a Layer object is a special case - it can contain SQL results
 long ObjectStore::add(OGRLayer *ptr, Nan::Persistent<Object> &obj, long parent_uid, bool is_result_set) {
   long uid = ObjectStore::add<OGRLayer *>(ptr, obj, parent_uid);
-  uidMap<OGRLayer *>[uid] -> is_result_set = is_result_set;
+  if (uid == 0) return 0;
+  lookup<OGRLayer *>(uid)->is_result_set = is_result_set;
   return uid;
 }
 
@@ -250,28 +458,28 @@ long ObjectStore::add(OGRLayer *ptr, Nan::Persistent<Object> &obj, long parent_u
 // It contains a lock (unless it is a dependant Dataset)
 long ObjectStore::add(GDALDataset *ptr, Nan::Persistent<Object> &obj, long parent_uid) {
   long uid = ObjectStore::add<GDALDataset *>(ptr, obj, parent_uid);
-  if (parent_uid == 0) {
-    uidMap<GDALDataset *>[uid] -> async_lock = shared_ptr<uv_sem_t>(new uv_sem_t(), uv_sem_deleter());
-    uv_sem_init(uidMap<GDALDataset *>[uid] -> async_lock.get(), 1);
+  if (uid == 0) return 0;
+  auto item = lookup<GDALDataset *>(uid);
+  if (item->parent == nullptr) {
+    item->async_lock = make_shared<DatasetLock>();
   } else {
-    uidMap<GDALDataset *>[uid] -> async_lock = uidMap<GDALDataset *>[parent_uid] -> async_lock;
+    item->async_lock = item->parent->async_lock;
   }
   return uid;
 }
 
 template <typename GDALPTR> bool ObjectStore::has(GDALPTR ptr) {
   uv_scoped_mutex lock(&master_lock);
-  return ptrMap<GDALPTR>.count(ptr) > 0;
+  return ptrMap<GDALPTR>().count(ptr) > 0;
 }
 template <typename GDALPTR> Local<Object> ObjectStore::get(GDALPTR ptr) {
   uv_scoped_mutex lock(&master_lock);
   Nan::EscapableHandleScope scope;
-  return scope.Escape(Nan::New(ptrMap<GDALPTR>[ptr] -> obj));
+  return scope.Escape(Nan::New(ptrMap<GDALPTR>()[ptr]->obj));
 }
 template <typename GDALPTR> Local<Object> ObjectStore::get(long uid) {
-  uv_scoped_mutex lock(&master_lock);
   Nan::EscapableHandleScope scope;
-  return scope.Escape(Nan::New(uidMap<GDALPTR>[uid] -> obj));
+  return scope.Escape(Nan::New(lookup<GDALPTR>(uid)->obj));
 }
 
 // Explicit instantiation:
@@ -313,8 +521,8 @@ const char warningGCBug[] =
   "Sleeping on semaphore in garbage collector, this is a bug in gdal-async, event loop blocked for ";
 const char warningManualClose[] =
   "Closing a dataset while background async operations are still running, event loop blocked for ";
-static inline void uv_sem_wait_with_warning(uv_sem_t *sem, const char *warning) {
-  if (uv_sem_trywait(sem) != 0) { MEASURE_EXECUTION_TIME(warning, uv_sem_wait(sem)); }
+static inline void lock_with_warning(const AsyncLock &lock, const char *warning) {
+  if (!lock->tryLock()) { MEASURE_EXECUTION_TIME(warning, lock->lock()); }
 }
 
 // dispose is called by the C++ destructor which is called by Nan::ObjectWrap
@@ -324,16 +532,19 @@ static inline void uv_sem_wait_with_warning(uv_sem_t *sem, const char *warning)
 
 // Disposing a Dataset is a special case - it has children (called with the master lock held)
 template <> void ObjectStore::dispose(shared_ptr<ObjectStoreItem<GDALDataset *>> item, bool manual) {
-  uv_sem_wait_with_warning(
-    item->async_lock.get(), manual ? (eventLoopWarn ? warningManualClose : nullptr) : warningGCBug);
-  uidMap<GDALDataset *>.erase(item->uid);
-  ptrMap<GDALDataset *>.erase(item->ptr);
+  const char *warning = manual ? (eventLoopWarn ? warningManualClose : nullptr) : warningGCBug;
+  lock_with_warning(item->async_lock, warning);
+  for (const AsyncLock &l : item->pool_locks) lock_with_warning(l, warning);
+  eraseUid(item->uid);
+  ptrMap<GDALDataset *>().erase(item->ptr);
   if (item->parent != nullptr) item->parent->children.remove(item->uid);
+  item->disposed = true;
 
-  uv_sem_post(item->async_lock.get());
-  uv_cond_broadcast(&master_sleep);
+  // The queued async jobs on this Dataset will fail
+  unlockDataset(item->async_lock);
+  if (!item->pool_locks.empty()) unlockDatasets(item->pool_locks);
   // Beyond this point the Dataset is not alive anymore ->
-  // anyone who was waiting for this semaphore should fail
+  // anyone who was waiting for this lock should fail
 
   // All the children are removed from the ObjectStore
   // but the Node/V8 objects still exist
@@ -341,11 +552,21 @@ template <> void ObjectStore::dispose(shared_ptr<ObjectStoreItem<GDALDataset *>>
   // When this happens, they will skip this in do_dispose
   while (!item->children.empty()) { do_dispose(item->children.back()); }
 
+  // GDAL cannot close a Dataset with locked blocks
+  PinnedBlock::releaseAll(item->uid);
+  releaseTileTransformers(item->uid);
+  async_stats.forget(item->uid);
+
   if (item->ptr) {
     LOG("Closing GDALDataset %ld [%p]", item->uid, item->ptr);
     GDALClose(item->ptr);
     item->ptr = nullptr;
   }
+  for (GDALDataset *handle : item->pool) {
+    LOG("Closing pooled GDALDataset %ld [%p]", item->uid, handle);
+    GDALClose(handle);
+  }
+  item->pool.clear();
 }
 
 const char warningSQL[] =
@@ -356,25 +577,24 @@ const char warningSQL[] =
 //   An asynchronous operation is running on one of the other layers
 //   The GC decides it is time to reclaim the SQL results
 template <> void ObjectStore::dispose(shared_ptr<ObjectStoreItem<OGRLayer *>> item, bool) {
-  ptrMap<OGRLayer *>.erase(item->ptr);
-  uidMap<OGRLayer *>.erase(item->uid);
+  ptrMap<OGRLayer *>().erase(item->ptr);
+  eraseUid(item->uid);
   if (item->parent != nullptr) { item->parent->children.remove(item->uid); }
   if (item->is_result_set) {
     LOG("Closing OGRLayer with SQL results [%ld] [%p]", uid, item->ptr);
     if (item->parent) {
-      uv_sem_wait_with_warning(item->parent->async_lock.get(), warningSQL);
+      lock_with_warning(item->parent->async_lock, warningSQL);
       GDALDataset *parent_ds = item->parent->ptr;
       parent_ds->ReleaseResultSet(item->ptr);
-      uv_sem_post(item->parent->async_lock.get());
-      uv_cond_broadcast(&object_store.master_sleep);
+      unlockDataset(item->parent->async_lock);
     }
   }
 }
 
 // Generic disposal (called with the master lock held)
 template <typename GDALPTR> void ObjectStore::dispose(shared_ptr<ObjectStoreItem<GDALPTR>> item, bool) {
-  ptrMap<GDALPTR>.erase(item->ptr);
-  uidMap<GDALPTR>.erase(item->uid);
+  ptrMap<GDALPTR>().erase(item->ptr);
+  eraseUid(item->uid);
   if (item->parent != nullptr) { item->parent->children.remove(item->uid); }
 }
 
@@ -387,35 +607,62 @@ void ObjectStore::dispose(long uid, bool manual) {
 
 // The locked section of the above function
 void ObjectStore::do_dispose(long uid, bool manual) {
-  if (uidMap<GDALDataset *>.count(uid))
-    dispose(uidMap<GDALDataset *>[uid], manual);
-  else if (uidMap<OGRLayer *>.count(uid))
-    dispose(uidMap<OGRLayer *>[uid], manual);
-  else if (uidMap<GDALRasterBand *>.count(uid))
-    dispose(uidMap<GDALRasterBand *>[uid], manual);
-  else if (uidMap<GDALDriver *>.count(uid))
-    dispose(uidMap<GDALDriver *>[uid], manual);
-  else if (uidMap<OGRSpatialReference *>.count(uid))
-    dispose(uidMap<OGRSpatialReference *>[uid], manual);
-  else if (uidMap<GDALColorTable *>.count(uid))
-    dispose(uidMap<GDALColorTable *>[uid], manual);
+  UidEntry entry;
+  {
+    UidShard &s = shard(uid);
+    uv_scoped_mutex lock(&s.lock);
+    auto found = s.map.find(uid);
+    if (found == s.map.end()) return;
+    entry = found->second;
+  }
+  switch (entry.type) {
+    case ObjectStoreType::Driver:
+      dispose(static_pointer_cast<ObjectStoreItem<GDALDriver *>>(entry.item), manual);
+      break;
+    case ObjectStoreType::Dataset:
+      dispose(static_pointer_cast<ObjectStoreItem<GDALDataset *>>(entry.item), manual);
+      break;
+    case ObjectStoreType::Layer: dispose(static_pointer_cast<ObjectStoreItem<OGRLayer *>>(entry.item), manual); break;
+    case ObjectStoreType::RasterBand:
+      dispose(static_pointer_cast<ObjectStoreItem<GDALRasterBand *>>(entry.item), manual);
+      break;
+    case ObjectStoreType::SpatialReference:
+      dispose(static_pointer_cast<ObjectStoreItem<OGRSpatialReference *>>(entry.item), manual);
+      break;
+    case ObjectStoreType::ColorTable:
+      dispose(static_pointer_cast<ObjectStoreItem<GDALColorTable *>>(entry.item), manual);
+      break;
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
-  else if (uidMap<shared_ptr<GDALGroup>>.count(uid))
-    dispose(uidMap<shared_ptr<GDALGroup>>[uid], manual);
-  else if (uidMap<shared_ptr<GDALMDArray>>.count(uid))
-    dispose(uidMap<shared_ptr<GDALMDArray>>[uid], manual);
-  else if (uidMap<shared_ptr<GDALDimension>>.count(uid))
-    dispose(uidMap<shared_ptr<GDALDimension>>[uid], manual);
-  else if (uidMap<shared_ptr<GDALAttribute>>.count(uid))
-    dispose(uidMap<shared_ptr<GDALAttribute>>[uid], manual);
+    case ObjectStoreType::Group:
+      dispose(static_pointer_cast<ObjectStoreItem<shared_ptr<GDALGroup>>>(entry.item), manual);
+      break;
+    case ObjectStoreType::MDArray:
+      dispose(static_pointer_cast<ObjectStoreItem<shared_ptr<GDALMDArray>>>(entry.item), manual);
+      break;
+    case ObjectStoreType::Dimension:
+      dispose(static_pointer_cast<ObjectStoreItem<shared_ptr<GDALDimension>>>(entry.item), manual);
+      break;
+    case ObjectStoreType::Attribute:
+      dispose(static_pointer_cast<ObjectStoreItem<shared_ptr<GDALAttribute>>>(entry.item), manual);
+      break;
 #endif
+    default: break;
+  }
 }
 
-// Closes still open Datasets on process exit
-// Called on the main thread after the event loop has exited
+// Closes the still open Datasets of an isolate when its environment is destroyed
+// Called on the main thread of the isolate after its event loop has exited
 void ObjectStore::cleanup() {
   // This unusual loop is needed since dispose deletes elements from the map
-  while (uidMap<GDALDataset *>.size() > 0) { dispose(uidMap<GDALDataset *>.cbegin()->second->uid, true); }
+  while (true) {
+    long uid;
+    {
+      uv_scoped_mutex lock(&master_lock);
+      if (ptrMap<GDALDataset *>().empty()) break;
+      uid = ptrMap<GDALDataset *>().cbegin()->second->uid;
+    }
+    dispose(uid, true);
+  }
 }
 
 } // namespace node_gdal
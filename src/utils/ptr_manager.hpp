@@ -16,13 +16,36 @@
 
 #include <list>
 #include <map>
+#include <unordered_map>
 
 using namespace v8;
 using namespace std;
 
 namespace node_gdal {
 
-typedef shared_ptr<uv_sem_t> AsyncLock;
+// The per-Dataset lock
+// It is not a mutex, it can be acquired by one thread and released by another one
+// Every lock has its own waiters which are served in FIFO order,
+// releasing it wakes up only the threads that are waiting for this lock
+class DatasetLock {
+    public:
+  DatasetLock();
+  ~DatasetLock();
+  void lock();
+  bool tryLock();
+  // Returns true if a tryLock() has failed while it was held
+  bool unlock();
+
+    private:
+  uv_mutex_t mutex;
+  uv_cond_t cond;
+  // Ticket lock, it is free when now_serving == next_ticket
+  unsigned long next_ticket;
+  unsigned long now_serving;
+  bool contended;
+};
+
+typedef shared_ptr<DatasetLock> AsyncLock;
 
 template <typename GDALPTR> struct ObjectStoreItem {
   long uid;
@@ -48,13 +71,30 @@ template <> struct ObjectStoreItem<GDALDataset *> {
   shared_ptr<ObjectStoreItem<GDALDataset *>> parent;
   list<long> children;
   AsyncLock async_lock;
+  // Set by dispose while holding async_lock
+  bool disposed;
+  // Additional read-only handles on the same file, each one with its own lock
+  vector<GDALDataset *> pool;
+  vector<AsyncLock> pool_locks;
   ObjectStoreItem(Nan::Persistent<Object> &obj);
 };
 
-struct uv_sem_deleter {
-  void operator()(uv_sem_t *p);
+// The type tag of the unified uid table
+enum class ObjectStoreType {
+  Driver,
+  Dataset,
+  Layer,
+  RasterBand,
+  SpatialReference,
+  ColorTable,
+  Group,
+  MDArray,
+  Dimension,
+  Attribute
 };
 
+struct UidShard;
+
 class ObjectStore {
     public:
   template <typename GDALPTR> long add(GDALPTR ptr, Nan::Persistent<Object> &obj, long parent_uid);
@@ -64,24 +104,16 @@ class ObjectStore {
   void dispose(long uid, bool manual = false);
   bool isAlive(long uid);
   inline void lockDataset(AsyncLock lock) {
-    uv_sem_wait(lock.get());
-  }
-  inline void unlockDataset(AsyncLock lock) {
-    uv_sem_post(lock.get());
-    uv_mutex_lock(&master_lock);
-    uv_cond_broadcast(&master_sleep);
-    uv_mutex_unlock(&master_lock);
-  }
-  inline void unlockDatasets(vector<AsyncLock> locks) {
-    for (const AsyncLock &l : locks) uv_sem_post(l.get());
-    uv_mutex_lock(&master_lock);
-    uv_cond_broadcast(&master_sleep);
-    uv_mutex_unlock(&master_lock);
+    lock->lock();
   }
+  void unlockDataset(AsyncLock lock);
+  void unlockDatasets(vector<AsyncLock> locks);
   AsyncLock lockDataset(long uid);
   vector<AsyncLock> lockDatasets(vector<long> uids);
   AsyncLock tryLockDataset(long uid);
   vector<AsyncLock> tryLockDatasets(vector<long> uids);
+  void addPool(long uid, const vector<GDALDataset *> &handles);
+  AsyncLock tryLockPooledDataset(long uid, GDALDataset *&handle);
 
   template <typename GDALPTR> bool has(GDALPTR ptr);
   template <typename GDALPTR> Local<Object> get(GDALPTR ptr);
@@ -95,7 +127,12 @@ class ObjectStore {
     private:
   long uid;
   uv_mutex_t master_lock;
-  uv_cond_t master_sleep;
+  UidShard *uid_table;
+  UidShard &shard(long uid);
+  void insertUid(long uid, ObjectStoreType type, shared_ptr<void> item);
+  void eraseUid(long uid);
+  template <typename GDALPTR> shared_ptr<ObjectStoreItem<GDALPTR>> lookup(long uid);
+  shared_ptr<ObjectStoreItem<GDALDataset *>> findDataset(long uid);
   vector<AsyncLock> _tryLockDatasets(vector<long> uids);
   template <typename GDALPTR> void dispose(shared_ptr<ObjectStoreItem<GDALPTR>> item, bool manual);
   void do_dispose(long uid, bool manual = false);
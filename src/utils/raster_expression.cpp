@@ -0,0 +1,524 @@
+#include "raster_expression.hpp"
+#include "block_reducer.hpp"
+
+// gdal
+#include <cpl_conv.h>
+#include <cpl_error.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace node_gdal {
+
+typedef RasterExpression::Op Op;
+typedef RasterExpression::Node Node;
+
+static inline bool truth(double v) {
+  return v != 0 && v == v;
+}
+
+// The formulas of the operators, shared by the constant folding and the vector kernels
+// clang-format off
+#define UNARY_OPS(X)                        \
+  X(Neg, -a)                                \
+  X(Not, truth(a) ? 0.0 : 1.0)              \
+  X(Abs, std::fabs(a))                      \
+  X(Sqrt, std::sqrt(a))                     \
+  X(Exp, std::exp(a))                       \
+  X(Log, std::log(a))                       \
+  X(Log10, std::log10(a))                   \
+  X(Sin, std::sin(a))                       \
+  X(Cos, std::cos(a))                       \
+  X(Tan, std::tan(a))                       \
+  X(Asin, std::asin(a))                     \
+  X(Acos, std::acos(a))                     \
+  X(Atan, std::atan(a))                     \
+  X(Floor, std::floor(a))                   \
+  X(Ceil, std::ceil(a))                     \
+  X(Round, std::floor(a + 0.5))             \
+  X(IsNaN, a != a ? 1.0 : 0.0)
+
+#define BINARY_OPS(X)                       \
+  X(Add, a + b)                             \
+  X(Sub, a - b)                             \
+  X(Mul, a * b)                             \
+  X(Div, a / b)                             \
+  X(Mod, std::fmod(a, b))                   \
+  X(Pow, std::pow(a, b))                    \
+  X(Atan2, std::atan2(a, b))                \
+  X(Min, a < b || a != a ? a : b)           \
+  X(Max, a > b || a != a ? a : b)           \
+  X(Lt, a < b ? 1.0 : 0.0)                  \
+  X(Le, a <= b ? 1.0 : 0.0)                 \
+  X(Gt, a > b ? 1.0 : 0.0)                  \
+  X(Ge, a >= b ? 1.0 : 0.0)                 \
+  X(Eq, a == b ? 1.0 : 0.0)                 \
+  X(Ne, a != b ? 1.0 : 0.0)                 \
+  X(And, truth(a) && truth(b) ? 1.0 : 0.0)  \
+  X(Or, truth(a) || truth(b) ? 1.0 : 0.0)
+// clang-format on
+
+static inline size_t arity(Op op) {
+  if (op <= Op::Input) return 0;
+  if (op <= Op::IsNaN) return 1;
+  if (op <= Op::Or) return 2;
+  return 3;
+}
+
+static double scalar(Op op, double a, double b, double c) {
+#define SCALAR_OP(name, formula) \
+  case Op::name: return formula;
+  switch (op) {
+    UNARY_OPS(SCALAR_OP)
+    BINARY_OPS(SCALAR_OP)
+    case Op::Select: return truth(a) ? b : c;
+    default: return std::numeric_limits<double>::quiet_NaN();
+  }
+#undef SCALAR_OP
+}
+
+struct Function {
+  const char *name;
+  Op op;
+  // min() and max() take any number of arguments
+  int arity;
+};
+
+static const Function functions[] = {
+  {"abs", Op::Abs, 1},     {"sqrt", Op::Sqrt, 1},   {"exp", Op::Exp, 1},     {"log", Op::Log, 1},
+  {"log10", Op::Log10, 1}, {"sin", Op::Sin, 1},     {"cos", Op::Cos, 1},     {"tan", Op::Tan, 1},
+  {"asin", Op::Asin, 1},   {"acos", Op::Acos, 1},   {"atan", Op::Atan, 1},   {"floor", Op::Floor, 1},
+  {"ceil", Op::Ceil, 1},   {"round", Op::Round, 1}, {"isnan", Op::IsNaN, 1}, {"pow", Op::Pow, 2},
+  {"atan2", Op::Atan2, 2}, {"min", Op::Min, -1},    {"max", Op::Max, -1}};
+
+// A recursive descent parser emitting the nodes in postfix order,
+// every method returns the index of the root of the sub-expression
+class ExpressionParser {
+    public:
+  ExpressionParser(const std::string &text, const std::vector<std::string> &variables, std::vector<Node> &program)
+    : text(text), variables(variables), program(program), pos(0) {
+  }
+
+  void parse() {
+    ternary();
+    skip();
+    if (pos < text.size()) fail("Unexpected character");
+  }
+
+    private:
+  const std::string &text;
+  const std::vector<std::string> &variables;
+  std::vector<Node> &program;
+  size_t pos;
+
+  void fail(const char *msg) {
+    CPLError(CE_Failure, CPLE_IllegalArg, "%s at position %d of the expression", msg, static_cast<int>(pos) + 1);
+    throw CPLGetLastErrorMsg();
+  }
+
+  void skip() {
+    while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) pos++;
+  }
+
+  bool accept(const char *token) {
+    skip();
+    size_t len = strlen(token);
+    if (text.compare(pos, len, token) != 0) return false;
+    pos += len;
+    return true;
+  }
+
+  void expect(const char *token) {
+    if (!accept(token)) {
+      CPLError(CE_Failure, CPLE_IllegalArg, "Expected \"%s\" at position %d of the expression", token, static_cast<int>(pos) + 1);
+      throw CPLGetLastErrorMsg();
+    }
+  }
+
+  size_t constant(double value) {
+    Node node = {Op::Const, value, 0, {0, 0, 0}};
+    program.push_back(node);
+    return program.size() - 1;
+  }
+
+  // The operands of an operator are always the last sub-expressions,
+  // when they are all constant they are single nodes that can be replaced
+  size_t emit(Op op, size_t a, size_t b = 0, size_t c = 0) {
+    Node node = {op, 0, 0, {a, b, c}};
+    size_t n = arity(op);
+    bool folded = true;
+    for (size_t i = 0; i < n; i++)
+      if (program[node.args[i]].op != Op::Const) folded = false;
+    if (folded) {
+      double v[3] = {0, 0, 0};
+      for (size_t i = 0; i < n; i++) v[i] = program[node.args[i]].value;
+      program.resize(program.size() - n);
+      return constant(scalar(op, v[0], v[1], v[2]));
+    }
+    program.push_back(node);
+    return program.size() - 1;
+  }
+
+  size_t ternary() {
+    size_t cond = logicalOr();
+    if (!accept("?")) return cond;
+    size_t a = ternary();
+    expect(":");
+    size_t b = ternary();
+    return emit(Op::Select, cond, a, b);
+  }
+
+  size_t logicalOr() {
+    size_t r = logicalAnd();
+    while (accept("||")) r = emit(Op::Or, r, logicalAnd());
+    return r;
+  }
+
+  size_t logicalAnd() {
+    size_t r = equality();
+    while (accept("&&")) r = emit(Op::And, r, equality());
+    return r;
+  }
+
+  size_t equality() {
+    size_t r = relational();
+    for (;;) {
+      if (accept("=="))
+        r = emit(Op::Eq, r, relational());
+      else if (accept("!="))
+        r = emit(Op::Ne, r, relational());
+      else
+        return r;
+    }
+  }
+
+  size_t relational() {
+    size_t r = additive();
+    for (;;) {
+      if (accept("<="))
+        r = emit(Op::Le, r, additive());
+      else if (accept("<"))
+        r = emit(Op::Lt, r, additive());
+      else if (accept(">="))
+        r = emit(Op::Ge, r, additive());
+      else if (accept(">"))
+        r = emit(Op::Gt, r, additive());
+      else
+        return r;
+    }
+  }
+
+  size_t additive() {
+    size_t r = multiplicative();
+    for (;;) {
+      if (accept("+"))
+        r = emit(Op::Add, r, multiplicative());
+      else if (accept("-"))
+        r = emit(Op::Sub, r, multiplicative());
+      else
+        return r;
+    }
+  }
+
+  size_t multiplicative() {
+    size_t r = unary();
+    for (;;) {
+      if (accept("*"))
+        r = emit(Op::Mul, r, unary());
+      else if (accept("/"))
+        r = emit(Op::Div, r, unary());
+      else if (accept("%"))
+        r = emit(Op::Mod, r, unary());
+      else
+        return r;
+    }
+  }
+
+  // -2^2 is -4 as in most languages (but not in JS where it is a syntax error)
+  size_t unary() {
+    if (accept("-")) return emit(Op::Neg, unary());
+    if (accept("+")) return unary();
+    if (accept("!")) return emit(Op::Not, unary());
+    return power();
+  }
+
+  size_t power() {
+    size_t base = primary();
+    if (accept("^")) return emit(Op::Pow, base, unary());
+    return base;
+  }
+
+  size_t primary() {
+    skip();
+    if (pos >= text.size()) fail("Unexpected end");
+    char first = text[pos];
+
+    if (isdigit(static_cast<unsigned char>(first)) || first == '.') {
+      const char *start = text.c_str() + pos;
+      char *end = nullptr;
+      double value = CPLStrtod(start, &end);
+      if (end == start) fail("Invalid number");
+      pos += end - start;
+      return constant(value);
+    }
+
+    if (accept("(")) {
+      size_t r = ternary();
+      expect(")");
+      return r;
+    }
+
+    if (!isalpha(static_cast<unsigned char>(first)) && first != '_') fail("Unexpected character");
+    size_t start = pos;
+    while (pos < text.size() && (isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_')) pos++;
+    std::string name = text.substr(start, pos - start);
+
+    if (accept("(")) return call(name);
+
+    for (size_t i = 0; i < variables.size(); i++) {
+      if (variables[i] == name) {
+        Node node = {Op::Input, 0, i, {0, 0, 0}};
+        program.push_back(node);
+        return program.size() - 1;
+      }
+    }
+    if (name == "pi") return constant(M_PI);
+    if (name == "e") return constant(std::exp(1.0));
+    if (name == "nan") return constant(std::numeric_limits<double>::quiet_NaN());
+
+    pos = start;
+    CPLError(CE_Failure, CPLE_IllegalArg, "Unknown variable \"%s\" in the expression", name.c_str());
+    throw CPLGetLastErrorMsg();
+  }
+
+  size_t call(const std::string &name) {
+    const Function *fn = nullptr;
+    for (const Function &f : functions)
+      if (name == f.name) fn = &f;
+    if (fn == nullptr) {
+      CPLError(CE_Failure, CPLE_IllegalArg, "Unknown function \"%s\" in the expression", name.c_str());
+      throw CPLGetLastErrorMsg();
+    }
+
+    // min(a, b, c) is min(min(a, b), c), the operands are always the last sub-expressions
+    size_t args[2];
+    int count = 0;
+    size_t r = 0;
+    if (!accept(")")) {
+      do {
+        size_t arg = ternary();
+        count++;
+        if (fn->arity < 0) {
+          r = count == 1 ? arg : emit(fn->op, r, arg);
+        } else if (count <= fn->arity) {
+          args[count - 1] = arg;
+        }
+      } while (accept(","));
+      expect(")");
+    }
+
+    if (fn->arity < 0) {
+      if (count == 0) {
+        CPLError(CE_Failure, CPLE_IllegalArg, "%s() requires at least one argument", fn->name);
+        throw CPLGetLastErrorMsg();
+      }
+      return r;
+    }
+    if (count != fn->arity) {
+      CPLError(CE_Failure, CPLE_IllegalArg, "%s() requires %d argument(s)", fn->name, fn->arity);
+      throw CPLGetLastErrorMsg();
+    }
+    return fn->arity == 1 ? emit(fn->op, args[0]) : emit(fn->op, args[0], args[1]);
+  }
+};
+
+RasterExpression::RasterExpression(const std::string &text, const std::vector<std::string> &variables)
+  : used(variables.size(), false) {
+  ExpressionParser(text, variables, program).parse();
+
+  // Every node is used once by its parent, so the registers of the operands
+  // can be reused for the result (the kernels work element by element)
+  slot.assign(program.size(), 0);
+  slots = 0;
+  std::vector<size_t> free;
+  for (size_t k = 0; k < program.size(); k++) {
+    const Node &node = program[k];
+    if (node.op == Op::Input) used[node.input] = true;
+    if (arity(node.op) == 0) continue;
+    for (size_t i = 0; i < arity(node.op); i++)
+      if (arity(program[node.args[i]].op) > 0) free.push_back(slot[node.args[i]]);
+    if (free.empty()) {
+      slot[k] = slots++;
+    } else {
+      slot[k] = free.back();
+      free.pop_back();
+    }
+  }
+}
+
+bool RasterExpression::uses(size_t input) const {
+  return used[input];
+}
+
+namespace {
+
+// The value of a node in the current chunk, either an array or a constant
+struct Operand {
+  const double *data;
+  double value;
+  inline double at(size_t i) const {
+    return data != nullptr ? data[i] : value;
+  }
+};
+
+template <typename F> void unaryKernel(double *dst, const Operand &a, size_t n, const F &f) {
+  if (a.data == nullptr) {
+    std::fill(dst, dst + n, f(a.value));
+    return;
+  }
+  const double *x = a.data;
+  for (size_t i = 0; i < n; i++) dst[i] = f(x[i]);
+}
+
+template <typename F> void binaryKernel(double *dst, const Operand &a, const Operand &b, size_t n, const F &f) {
+  const double *x = a.data;
+  const double *y = b.data;
+  if (x != nullptr && y != nullptr) {
+    for (size_t i = 0; i < n; i++) dst[i] = f(x[i], y[i]);
+  } else if (x != nullptr) {
+    double v = b.value;
+    for (size_t i = 0; i < n; i++) dst[i] = f(x[i], v);
+  } else if (y != nullptr) {
+    double v = a.value;
+    for (size_t i = 0; i < n; i++) dst[i] = f(v, y[i]);
+  } else {
+    std::fill(dst, dst + n, f(a.value, b.value));
+  }
+}
+
+void selectKernel(double *dst, const Operand &cond, const Operand &a, const Operand &b, size_t n) {
+  for (size_t i = 0; i < n; i++) dst[i] = truth(cond.at(i)) ? a.at(i) : b.at(i);
+}
+
+} // namespace
+
+void RasterExpression::evaluate(const std::vector<const double *> &inputs, double *output, size_t length) const {
+  std::vector<double> registers(slots * chunk);
+  std::vector<Operand> values(program.size());
+  const size_t root = program.size() - 1;
+
+  for (size_t start = 0; start < length; start += chunk) {
+    size_t n = std::min(chunk, length - start);
+    for (size_t k = 0; k < program.size(); k++) {
+      const Node &node = program[k];
+      if (node.op == Op::Const) {
+        values[k] = {nullptr, node.value};
+        continue;
+      }
+      if (node.op == Op::Input) {
+        values[k] = {inputs[node.input] + start, 0};
+        continue;
+      }
+
+      // The root is evaluated directly in the output
+      double *dst = k == root ? output + start : registers.data() + slot[k] * chunk;
+      const Operand &x = values[node.args[0]];
+      const Operand &y = values[node.args[1]];
+#define UNARY_KERNEL(name, formula) \
+  case Op::name: unaryKernel(dst, x, n, [](double a) { return formula; }); break;
+#define BINARY_KERNEL(name, formula) \
+  case Op::name: binaryKernel(dst, x, y, n, [](double a, double b) { return formula; }); break;
+      switch (node.op) {
+        UNARY_OPS(UNARY_KERNEL)
+        BINARY_OPS(BINARY_KERNEL)
+        case Op::Select: selectKernel(dst, x, y, values[node.args[2]], n); break;
+        default: break;
+      }
+#undef UNARY_KERNEL
+#undef BINARY_KERNEL
+      values[k] = {dst, 0};
+    }
+
+    // An expression without operators
+    const Operand &r = values[root];
+    if (program[root].op == Op::Const) std::fill(output + start, output + start + n, r.value);
+    if (program[root].op == Op::Input) std::copy(r.data, r.data + n, output + start);
+  }
+}
+
+void calcExpression(
+  const GDALExecutionProgress &progress,
+  const std::vector<GDALRasterBand *> &inputs,
+  GDALRasterBand *output,
+  const RasterExpression &expression,
+  bool convert_nodata,
+  bool convert_input) {
+  int w = output->GetXSize();
+  int h = output->GetYSize();
+  for (GDALRasterBand *band : inputs)
+    if (band->GetXSize() != w || band->GetYSize() != h) throw "All raster bands dimensions must match";
+
+  GDALDataType type = output->GetRasterDataType();
+  if (GDALDataTypeIsComplex(type)) throw "Complex data types are not supported";
+  int type_size = GDALGetDataTypeSizeBytes(type);
+  int has_nodata = 0;
+  double nodata = output->GetNoDataValue(&has_nodata);
+  std::vector<NoDataFilter> filters;
+  for (GDALRasterBand *band : inputs) filters.emplace_back(band);
+
+  // The output is written in whole blocks
+  int block_w, block_h;
+  output->GetBlockSize(&block_w, &block_h);
+  if (block_h < 1) block_h = 1;
+
+  std::vector<std::vector<double>> values(inputs.size());
+  std::vector<const double *> args(inputs.size(), nullptr);
+  std::vector<double> result, rounded;
+  std::vector<GByte> converted;
+  GDALProgressFunc report = progress.trampoline();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  for (int y = 0; y < h; y += block_h) {
+    if (progress.isAborted()) throw abortedError;
+    int rows = std::min(block_h, h - y);
+    size_t length = static_cast<size_t>(w) * rows;
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+      if (!expression.uses(i)) continue;
+      std::vector<double> &v = values[i];
+      v.resize(length);
+      CPLErrorReset();
+      CPLErr err = inputs[i]->RasterIO(GF_Read, 0, y, w, rows, v.data(), w, rows, GDT_Float64, 0, 0, nullptr);
+      if (err != CE_None) throw CPLGetLastErrorMsg();
+
+      // The NoData values are matched before the conversion
+      if (convert_input && type != GDT_Float64) {
+        converted.resize(length * type_size);
+        rounded.resize(length);
+        GDALCopyWords(v.data(), GDT_Float64, sizeof(double), converted.data(), type, type_size, static_cast<int>(length));
+        GDALCopyWords(
+          converted.data(), type, type_size, rounded.data(), GDT_Float64, sizeof(double), static_cast<int>(length));
+        for (size_t j = 0; j < length; j++) v[j] = convert_nodata && !filters[i].valid(v[j]) ? nan : rounded[j];
+      } else if (convert_nodata) {
+        for (size_t j = 0; j < length; j++) v[j] = filters[i].valid(v[j]) ? v[j] : nan;
+      }
+      args[i] = v.data();
+    }
+
+    result.resize(length);
+    expression.evaluate(args, result.data(), length);
+    if (convert_nodata && has_nodata) {
+      for (size_t j = 0; j < length; j++) result[j] = std::isnan(result[j]) ? nodata : result[j];
+    }
+
+    CPLErrorReset();
+    CPLErr err = output->RasterIO(GF_Write, 0, y, w, rows, result.data(), w, rows, GDT_Float64, 0, 0, nullptr);
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+    if (report != nullptr && !report(static_cast<double>(y + rows) / h, nullptr, (void *)&progress)) throw abortedError;
+  }
+}
+
+} // namespace node_gdal
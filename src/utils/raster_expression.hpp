@@ -0,0 +1,114 @@
+#ifndef __RASTER_EXPRESSION_H__
+#define __RASTER_EXPRESSION_H__
+
+// gdal
+#include <gdal_priv.h>
+
+#include "../async.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace node_gdal {
+
+// A pixel-wise arithmetic expression over named input bands, ie "125 * (t - td)"
+//
+// The expression is parsed on the main thread into a flat postfix program
+// where every node refers only to the nodes before it, the constant
+// sub-expressions are folded during the parsing
+// The program is evaluated in a worker thread over chunks of pixels that fit
+// in the CPU cache, one node at a time, with plain loops that the compiler
+// can vectorize - there are no per-pixel branches or function calls
+//
+// The values are doubles with the IEEE semantics, a NaN input (NoData)
+// propagates through the arithmetic, the comparisons and the logical
+// operators return 1 or 0, NaN is false
+class RasterExpression {
+    public:
+  enum class Op {
+    Const,
+    Input,
+    Neg,
+    Not,
+    Abs,
+    Sqrt,
+    Exp,
+    Log,
+    Log10,
+    Sin,
+    Cos,
+    Tan,
+    Asin,
+    Acos,
+    Atan,
+    Floor,
+    Ceil,
+    Round,
+    IsNaN,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Pow,
+    Atan2,
+    Min,
+    Max,
+    Lt,
+    Le,
+    Gt,
+    Ge,
+    Eq,
+    Ne,
+    And,
+    Or,
+    Select
+  };
+
+  struct Node {
+    Op op;
+    // Const
+    double value;
+    // Input
+    size_t input;
+    // The operands, indices of previous nodes
+    size_t args[3];
+  };
+
+  // The number of pixels evaluated at once
+  static const size_t chunk = 4096;
+
+  // Throws a const char * with the position of the syntax error
+  RasterExpression(const std::string &text, const std::vector<std::string> &variables);
+
+  // Is the input used by the expression
+  bool uses(size_t input) const;
+
+  // inputs[i] are the values of the i-th variable, called from any thread
+  void evaluate(const std::vector<const double *> &inputs, double *output, size_t length) const;
+
+    private:
+  std::vector<Node> program;
+  std::vector<bool> used;
+  // The register of every node and the number of registers
+  std::vector<size_t> slot;
+  size_t slots;
+};
+
+// output = expression(inputs...), the bands must have the same size
+//
+// The output is processed by block rows: the used inputs are read as doubles,
+// evaluated and written back, throws a const char * on error
+// convert_nodata replaces the NoData inputs with NaN and the NaN results with the
+// NoData value of the output, convert_input rounds the inputs to the output data type
+void calcExpression(
+  const GDALExecutionProgress &progress,
+  const std::vector<GDALRasterBand *> &inputs,
+  GDALRasterBand *output,
+  const RasterExpression &expression,
+  bool convert_nodata,
+  bool convert_input);
+
+} // namespace node_gdal
+#endif
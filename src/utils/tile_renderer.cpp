@@ -0,0 +1,304 @@
+#include "tile_renderer.hpp"
+
+#include <gdal_alg.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace node_gdal {
+
+// Half of the equator in EPSG:3857
+static const double webMercatorExtent = 20037508.342789244;
+
+// The cached transformers from the pixels of a GDAL handle to the
+// georeferenced coordinates of a matrix set, every entry is used only by
+// the job holding the lock of its handle
+struct CachedTransformer {
+  long uid;
+  void *transformer;
+};
+static std::mutex transformersLock;
+static std::map<std::pair<GDALDataset *, std::string>, CachedTransformer> transformers;
+
+static void *getTransformer(long uid, GDALDataset *ds, const std::string &srs) {
+  auto key = std::make_pair(ds, srs);
+  {
+    std::lock_guard<std::mutex> lock(transformersLock);
+    auto cached = transformers.find(key);
+    if (cached != transformers.end()) return cached->second.transformer;
+  }
+
+  char **options = CSLSetNameValue(nullptr, "DST_SRS", srs.c_str());
+  CPLErrorReset();
+  void *transformer = GDALCreateGenImgProjTransformer2(ds, nullptr, options);
+  CSLDestroy(options);
+  if (transformer == nullptr) throw CPLGetLastErrorMsg();
+
+  std::lock_guard<std::mutex> lock(transformersLock);
+  transformers[key] = {uid, transformer};
+  return transformer;
+}
+
+void releaseTileTransformers(long uid) {
+  std::lock_guard<std::mutex> lock(transformersLock);
+  for (auto it = transformers.begin(); it != transformers.end();) {
+    if (it->second.uid == uid) {
+      GDALDestroyGenImgProjTransformer(it->second.transformer);
+      it = transformers.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+const char *validateTile(const TileRequest &tile) {
+  if (tile.srs != "EPSG:3857" && tile.srs != "EPSG:4326") return "srs must be either \"EPSG:3857\" or \"EPSG:4326\"";
+  if (tile.z < 0 || tile.z > 30) return "z must be between 0 and 30";
+  long long rows = 1LL << tile.z;
+  long long columns = tile.srs == "EPSG:4326" ? rows * 2 : rows;
+  if (tile.x < 0 || tile.x >= columns || tile.y < 0 || tile.y >= rows) return "Tile coordinates out of range";
+  if (tile.size < 1 || tile.size > 4096) return "tileSize must be between 1 and 4096";
+  if (tile.format != "png" && tile.format != "webp" && tile.format != "raw")
+    return "format must be either \"png\", \"webp\" or \"raw\"";
+  return nullptr;
+}
+
+// The geotransform of the tile in the matrix set
+static void tileGeoTransform(const TileRequest &tile, double *gt) {
+  double extent, left, top;
+  if (tile.srs == "EPSG:4326") {
+    extent = 180.0 / std::pow(2.0, tile.z);
+    left = -180;
+    top = 90;
+  } else {
+    extent = 2 * webMercatorExtent / std::pow(2.0, tile.z);
+    left = -webMercatorExtent;
+    top = webMercatorExtent;
+  }
+  gt[0] = left + tile.x * extent;
+  gt[1] = extent / tile.size;
+  gt[2] = 0;
+  gt[3] = top - tile.y * extent;
+  gt[4] = 0;
+  gt[5] = -extent / tile.size;
+}
+
+// The number of full resolution source pixels per tile pixel, measured at the
+// first sample point that can be transformed, 0 if none can
+static double sourceRatio(void *transformer, int size) {
+  const double samples[][2] = {{0.5, 0.5}, {0.25, 0.25}, {0.75, 0.25}, {0.25, 0.75}, {0.75, 0.75}};
+  for (auto &s : samples) {
+    double x[3] = {s[0] * size, s[0] * size + 1, s[0] * size};
+    double y[3] = {s[1] * size, s[1] * size, s[1] * size + 1};
+    double z[3] = {0, 0, 0};
+    int success[3] = {0, 0, 0};
+    GDALGenImgProjTransform(transformer, TRUE, 3, x, y, z, success);
+    if (!success[0] || !success[1] || !success[2]) continue;
+    // The square root of the area of a tile pixel in source pixels
+    double det = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (std::isfinite(det) && det != 0) return std::sqrt(std::fabs(det));
+  }
+  return 0;
+}
+
+// The Dataset of an overview level when all the bands share it,
+// the drivers do not always expose one
+static GDALDataset *overviewDataset(GDALDataset *ds, const std::vector<int> &bands, int level) {
+  GDALRasterBand *first = ds->GetRasterBand(bands[0])->GetOverview(level);
+  if (first == nullptr) return nullptr;
+  GDALDataset *ovr = first->GetDataset();
+  if (ovr == nullptr || ovr == ds || ovr->GetRasterXSize() != first->GetXSize() ||
+      ovr->GetRasterYSize() != first->GetYSize())
+    return nullptr;
+  for (int b : bands) {
+    if (b > ovr->GetRasterCount() || ds->GetRasterBand(b)->GetOverview(level) != ovr->GetRasterBand(b)) return nullptr;
+  }
+  return ovr;
+}
+
+// The warper works in the pixels of an overview while the cached
+// transformer works in the pixels of the full resolution Dataset
+struct OverviewTransform {
+  void *base;
+  double sx, sy;
+};
+
+static int overviewTransform(
+  void *arg, int dstToSrc, int count, double *x, double *y, double *z, int *success) {
+  OverviewTransform *t = reinterpret_cast<OverviewTransform *>(arg);
+  if (!dstToSrc) {
+    for (int i = 0; i < count; i++) {
+      x[i] *= t->sx;
+      y[i] *= t->sy;
+    }
+  }
+  int r = GDALGenImgProjTransform(t->base, dstToSrc, count, x, y, z, success);
+  if (dstToSrc) {
+    for (int i = 0; i < count; i++) {
+      x[i] /= t->sx;
+      y[i] /= t->sy;
+    }
+  }
+  return r;
+}
+
+struct WarpOptionsDeleter {
+  void operator()(GDALWarpOptions *wo) {
+    GDALDestroyWarpOptions(wo);
+  }
+};
+struct DatasetDeleter {
+  void operator()(GDALDataset *ds) {
+    GDALClose(ds);
+  }
+};
+struct ApproxDeleter {
+  void operator()(void *approx) {
+    GDALDestroyApproxTransformer(approx);
+  }
+};
+struct BufferDeleter {
+  void operator()(GByte *data) {
+    VSIFree(data);
+  }
+};
+
+RenderedTile renderTile(const GDALExecutionProgress &progress, long uid, GDALDataset *ds, const TileRequest &tile) {
+  // The alpha band of the source is not a color band
+  int src_alpha = 0;
+  std::vector<int> bands = tile.bands;
+  for (int b = 1; b <= ds->GetRasterCount(); b++) {
+    GDALColorInterp ci = ds->GetRasterBand(b)->GetColorInterpretation();
+    if (ci == GCI_AlphaBand) {
+      src_alpha = b;
+    } else if (tile.bands.empty()) {
+      bands.push_back(b);
+    }
+  }
+  if (bands.empty()) throw "Dataset has no raster bands";
+  for (int b : bands) {
+    if (b < 1 || b > ds->GetRasterCount()) throw "Invalid band number";
+    if (b == src_alpha) src_alpha = 0;
+  }
+  // WEBP supports only RGB and RGBA, a gray band is expanded to RGB
+  if (tile.format == "webp") {
+    if (bands.size() == 1) bands.assign(3, bands[0]);
+    if (bands.size() != 3) throw "format \"webp\" requires 1 or 3 color bands";
+  }
+
+  void *transformer = getTransformer(uid, ds, tile.srs);
+  double gt[6];
+  tileGeoTransform(tile, gt);
+  GDALSetGenImgProjTransformerDstGeoTransform(transformer, gt);
+
+  // The coarsest overview that is at least as fine as the tile
+  double ratio = sourceRatio(transformer, tile.size);
+  GDALDataset *src = ds;
+  OverviewTransform ovr_transform = {transformer, 1, 1};
+  GDALRasterBand *first = ds->GetRasterBand(bands[0]);
+  for (int i = 0; ratio > 0 && i < first->GetOverviewCount(); i++) {
+    GDALRasterBand *ovr = first->GetOverview(i);
+    if (ovr == nullptr) continue;
+    double factor = static_cast<double>(ds->GetRasterXSize()) / ovr->GetXSize();
+    if (factor > ratio * 1.01 || factor <= ovr_transform.sx) continue;
+    GDALDataset *ovr_ds = overviewDataset(ds, bands, i);
+    if (src_alpha > 0 && ovr_ds != nullptr &&
+        (src_alpha > ovr_ds->GetRasterCount() ||
+         ds->GetRasterBand(src_alpha)->GetOverview(i) != ovr_ds->GetRasterBand(src_alpha)))
+      ovr_ds = nullptr;
+    if (ovr_ds == nullptr) continue;
+    src = ovr_ds;
+    ovr_transform.sx = factor;
+    ovr_transform.sy = static_cast<double>(ds->GetRasterYSize()) / ovr_ds->GetRasterYSize();
+  }
+
+  // An eighth of a pixel like gdalwarp
+  std::unique_ptr<void, ApproxDeleter> approx(GDALCreateApproxTransformer(overviewTransform, &ovr_transform, 0.125));
+  if (approx == nullptr) throw CPLGetLastErrorMsg();
+
+  // The tile is warped directly into a pixel-interleaved buffer wrapped in a MEM Dataset
+  GDALDataType type = first->GetRasterDataType();
+  int type_size = GDALGetDataTypeSizeBytes(type);
+  int count = static_cast<int>(bands.size()) + (tile.alpha ? 1 : 0);
+  size_t length = static_cast<size_t>(tile.size) * tile.size * count * type_size;
+  std::unique_ptr<GByte, BufferDeleter> buffer(static_cast<GByte *>(VSI_CALLOC_VERBOSE(1, length)));
+  if (buffer == nullptr) throw CPLGetLastErrorMsg();
+
+  GDALDriver *mem_driver = GetGDALDriverManager()->GetDriverByName("MEM");
+  if (mem_driver == nullptr) throw "MEM driver not available";
+  std::unique_ptr<GDALDataset, DatasetDeleter> mem(mem_driver->Create("", tile.size, tile.size, 0, type, nullptr));
+  if (mem == nullptr) throw CPLGetLastErrorMsg();
+  for (int b = 0; b < count; b++) {
+    char pointer[64];
+    int len = CPLPrintPointer(pointer, buffer.get() + static_cast<size_t>(b) * type_size, sizeof(pointer));
+    pointer[len] = '\0';
+    char **options = CSLSetNameValue(nullptr, "DATAPOINTER", pointer);
+    options = CSLSetNameValue(options, "PIXELOFFSET", CPLSPrintf("%d", count * type_size));
+    options = CSLSetNameValue(options, "LINEOFFSET", CPLSPrintf("%d", count * type_size * tile.size));
+    CPLErr err = mem->AddBand(type, options);
+    CSLDestroy(options);
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+  }
+  if (tile.alpha) mem->GetRasterBand(count)->SetColorInterpretation(GCI_AlphaBand);
+
+  std::unique_ptr<GDALWarpOptions, WarpOptionsDeleter> wo(GDALCreateWarpOptions());
+  wo->hSrcDS = src;
+  wo->hDstDS = mem.get();
+  wo->nBandCount = static_cast<int>(bands.size());
+  wo->panSrcBands = static_cast<int *>(CPLMalloc(sizeof(int) * bands.size()));
+  wo->panDstBands = static_cast<int *>(CPLMalloc(sizeof(int) * bands.size()));
+  bool nodata = true;
+  for (size_t i = 0; i < bands.size(); i++) {
+    wo->panSrcBands[i] = bands[i];
+    wo->panDstBands[i] = static_cast<int>(i) + 1;
+    int success = 0;
+    ds->GetRasterBand(bands[i])->GetNoDataValue(&success);
+    if (!success) nodata = false;
+  }
+  // The warper expects a NoData value for every band or for none
+  if (nodata) {
+    wo->padfSrcNoDataReal = static_cast<double *>(CPLMalloc(sizeof(double) * bands.size()));
+    wo->padfDstNoDataReal = static_cast<double *>(CPLMalloc(sizeof(double) * bands.size()));
+    for (size_t i = 0; i < bands.size(); i++) {
+      wo->padfSrcNoDataReal[i] = ds->GetRasterBand(bands[i])->GetNoDataValue();
+      wo->padfDstNoDataReal[i] = wo->padfSrcNoDataReal[i];
+    }
+  }
+  wo->papszWarpOptions = CSLSetNameValue(wo->papszWarpOptions, "INIT_DEST", nodata ? "NO_DATA" : "0");
+  wo->nSrcAlphaBand = src_alpha;
+  wo->nDstAlphaBand = tile.alpha ? count : 0;
+  wo->eResampleAlg = tile.resampling;
+  wo->pfnTransformer = GDALApproxTransform;
+  wo->pTransformerArg = approx.get();
+  // Unlike the utilities, the warper does not accept a null progress function
+  wo->pfnProgress = progress.trampoline() != nullptr ? progress.trampoline() : GDALDummyProgress;
+  wo->pProgressArg = (void *)&progress;
+
+  GDALWarpOperation operation;
+  CPLErrorReset();
+  if (operation.Initialize(wo.get()) != CE_None) throw CPLGetLastErrorMsg();
+  if (operation.ChunkAndWarpImage(0, 0, tile.size, tile.size) != CE_None) throw CPLGetLastErrorMsg();
+  if (progress.isAborted()) throw abortedError;
+  mem->FlushCache();
+
+  if (tile.format == "raw") return {buffer.release(), length};
+
+  GDALDriver *driver = GetGDALDriverManager()->GetDriverByName(tile.format == "png" ? "PNG" : "WEBP");
+  if (driver == nullptr) throw "Image driver not available";
+  std::string path = CPLSPrintf("/vsimem/node_gdal_tile_%p.%s", buffer.get(), tile.format.c_str());
+  GDALDataset *encoded = driver->CreateCopy(path.c_str(), mem.get(), FALSE, nullptr, nullptr, nullptr);
+  if (encoded == nullptr) {
+    VSIUnlink(path.c_str());
+    throw CPLGetLastErrorMsg();
+  }
+  GDALClose(encoded);
+  vsi_l_offset size = 0;
+  GByte *data = VSIGetMemFileBuffer(path.c_str(), &size, TRUE);
+  if (data == nullptr) throw "Failed encoding the tile";
+  return {data, static_cast<size_t>(size)};
+}
+
+} // namespace node_gdal
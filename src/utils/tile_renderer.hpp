@@ -0,0 +1,49 @@
+#ifndef __TILE_RENDERER_H__
+#define __TILE_RENDERER_H__
+
+// gdal
+#include <gdal_priv.h>
+#include <gdalwarper.h>
+
+#include "../async.hpp"
+
+#include <string>
+#include <vector>
+
+namespace node_gdal {
+
+// A tile of a XYZ tile matrix set
+struct TileRequest {
+  int z, x, y;
+  int size;
+  // EPSG:3857 (WebMercatorQuad) or EPSG:4326 (WorldCRS84Quad)
+  std::string srs;
+  GDALResampleAlg resampling;
+  // png, webp or raw
+  std::string format;
+  // Empty for all the bands except the alpha band
+  std::vector<int> bands;
+  bool alpha;
+};
+
+// The encoded tile, allocated with VSIMalloc
+struct RenderedTile {
+  GByte *data;
+  size_t length;
+};
+
+// Checks the tile coordinates and the matrix set, returns an error or nullptr
+const char *validateTile(const TileRequest &tile);
+
+// Warps a tile from the best overview of the Dataset directly into a
+// pixel-interleaved buffer and encodes it, throws a const char * on error
+//
+// The transformer from the Dataset to the matrix set is created once per
+// GDAL handle and is reused by all the tiles, the handle must be locked
+RenderedTile renderTile(const GDALExecutionProgress &progress, long uid, GDALDataset *ds, const TileRequest &tile);
+
+// Drops the cached transformers of a Dataset, called before closing it
+void releaseTileTransformers(long uid);
+
+} // namespace node_gdal
+#endif
@@ -1,64 +1,88 @@
 #include "typed_array.hpp"
 
+#include <node_buffer.h>
+
 #include <sstream>
 
 namespace node_gdal {
 
-// https://github.com/joyent/node/issues/4201#issuecomment-9837340
+// The TypedArrays are created with the V8 constructors instead of looking up
+// the JS constructors on the global object on every call
+// The "_gdal_type" key is created once per isolate
 
-Local<Value> TypedArray::New(GDALDataType type, unsigned int length) {
-  Nan::EscapableHandleScope scope;
+static thread_local Nan::Persistent<String> gdalTypeKey;
 
-  Local<Value> val;
-  Local<Function> constructor;
-  Local<Object> global = Nan::GetCurrentContext()->Global();
+static inline Local<String> GdalTypeKey() {
+  if (gdalTypeKey.IsEmpty()) gdalTypeKey.Reset(Nan::New("_gdal_type").ToLocalChecked());
+  return Nan::New(gdalTypeKey);
+}
 
-  const char *name;
+// Returns an empty handle for the unsupported data types
+// Works both with ArrayBuffer and SharedArrayBuffer
+template <typename BUFFER> static Local<Object> NewView(GDALDataType type, Local<BUFFER> buffer, size_t length) {
   switch (type) {
-    case GDT_Byte: name = "Uint8Array"; break;
-    case GDT_Int16: name = "Int16Array"; break;
-    case GDT_UInt16: name = "Uint16Array"; break;
-    case GDT_Int32: name = "Int32Array"; break;
-    case GDT_UInt32: name = "Uint32Array"; break;
-    case GDT_Float32: name = "Float32Array"; break;
-    case GDT_Float64: name = "Float64Array"; break;
-    default: Nan::ThrowError("Unsupported array type"); return scope.Escape(Nan::Undefined());
+    case GDT_Byte: return v8::Uint8Array::New(buffer, 0, length);
+    case GDT_Int16: return v8::Int16Array::New(buffer, 0, length);
+    case GDT_UInt16: return v8::Uint16Array::New(buffer, 0, length);
+    case GDT_Int32: return v8::Int32Array::New(buffer, 0, length);
+    case GDT_UInt32: return v8::Uint32Array::New(buffer, 0, length);
+    case GDT_Float32: return v8::Float32Array::New(buffer, 0, length);
+    case GDT_Float64: return v8::Float64Array::New(buffer, 0, length);
+    default: return Local<Object>();
   }
+}
 
-  // make ArrayBuffer
-  val = Nan::Get(global, Nan::New("ArrayBuffer").ToLocalChecked()).ToLocalChecked();
-
-  if (val.IsEmpty() || !val->IsFunction()) {
-    Nan::ThrowError("Error getting ArrayBuffer constructor");
-    return scope.Escape(Nan::Undefined());
+static inline bool IsSupported(GDALDataType type) {
+  switch (type) {
+    case GDT_Byte:
+    case GDT_Int16:
+    case GDT_UInt16:
+    case GDT_Int32:
+    case GDT_UInt32:
+    case GDT_Float32:
+    case GDT_Float64: return true;
+    default: return false;
   }
+}
 
-  constructor = val.As<Function>();
-  Local<Value> size = Nan::New<Integer>(length * GDALGetDataTypeSize(type) / 8);
-  Local<Value> array_buffer = Nan::NewInstance(constructor, 1, &size).ToLocalChecked();
+Local<Value> TypedArray::New(GDALDataType type, unsigned int length, bool shared) {
+  Nan::EscapableHandleScope scope;
 
-  if (array_buffer.IsEmpty() || !array_buffer->IsObject()) {
-    Nan::ThrowError("Error allocating ArrayBuffer");
+  if (!IsSupported(type)) {
+    Nan::ThrowError("Unsupported array type");
     return scope.Escape(Nan::Undefined());
   }
 
-  // make TypedArray
-  val = Nan::Get(global, Nan::New(name).ToLocalChecked()).ToLocalChecked();
-
-  if (val.IsEmpty() || !val->IsFunction()) {
-    Nan::ThrowError("Error getting typed array constructor");
+  // make ArrayBuffer, it is zero-filled like the one created by the JS constructor
+  size_t size = static_cast<size_t>(length) * GDALGetDataTypeSizeBytes(type);
+  if (size > node::Buffer::kMaxLength) {
+    Nan::ThrowRangeError("Array buffer allocation failed");
     return scope.Escape(Nan::Undefined());
   }
+  Local<Object> array;
+  if (shared) {
+    // a SharedArrayBuffer can be sent to the other worker_threads without copying
+    Local<SharedArrayBuffer> array_buffer = SharedArrayBuffer::New(v8::Isolate::GetCurrent(), size);
+    if (array_buffer.IsEmpty()) {
+      Nan::ThrowError("Error allocating SharedArrayBuffer");
+      return scope.Escape(Nan::Undefined());
+    }
+    array = NewView(type, array_buffer, length);
+  } else {
+    Local<ArrayBuffer> array_buffer = ArrayBuffer::New(v8::Isolate::GetCurrent(), size);
+    if (array_buffer.IsEmpty()) {
+      Nan::ThrowError("Error allocating ArrayBuffer");
+      return scope.Escape(Nan::Undefined());
+    }
+    array = NewView(type, array_buffer, length);
+  }
 
-  constructor = val.As<Function>();
-  Local<Object> array = Nan::NewInstance(constructor, 1, &array_buffer).ToLocalChecked();
-
-  if (array.IsEmpty() || !array->IsObject()) {
+  if (array.IsEmpty()) {
     Nan::ThrowError("Error creating TypedArray");
     return scope.Escape(Nan::Undefined());
   }
 
-  Nan::Set(array, Nan::New("_gdal_type").ToLocalChecked(), Nan::New(type));
+  Nan::Set(array, GdalTypeKey(), Nan::New(type));
 
   return scope.Escape(array);
 }
@@ -68,19 +92,7 @@ Local<Value> TypedArray::New(GDALDataType type, unsigned int length) {
 Local<Value> TypedArray::New(GDALDataType type, void *data, unsigned int length) {
   Nan::EscapableHandleScope scope;
 
-  Local<Object> global = Nan::GetCurrentContext()->Global();
-
-  const char *name;
-  switch (type) {
-    case GDT_Byte: name = "Uint8Array"; break;
-    case GDT_Int16: name = "Int16Array"; break;
-    case GDT_UInt16: name = "Uint16Array"; break;
-    case GDT_Int32: name = "Int32Array"; break;
-    case GDT_UInt32: name = "Uint32Array"; break;
-    case GDT_Float32: name = "Float32Array"; break;
-    case GDT_Float64: name = "Float64Array"; break;
-    default: throw "Unsupported array type";
-  }
+  if (!IsSupported(type)) throw "Unsupported array type";
 
   size_t size = GDALGetDataTypeSizeBytes(type);
 
@@ -92,18 +104,14 @@ Local<Value> TypedArray::New(GDALDataType type, void *data, unsigned int length)
   if (buffer.IsEmpty() || !buffer->IsObject()) { throw "Error getting creating Node.js Buffer"; }
 
   // get the underlying ArrayBuffer
-  Local<Value> underlyingAB = Nan::Get(buffer, Nan::New("buffer").ToLocalChecked()).ToLocalChecked();
+  Local<ArrayBuffer> underlyingAB = buffer.As<ArrayBufferView>()->Buffer();
 
   // make TypedArray
-  Local<Value> val = Nan::Get(global, Nan::New(name).ToLocalChecked()).ToLocalChecked();
-  if (val.IsEmpty() || !val->IsFunction()) { throw "Error getting typed array constructor"; }
-  Local<Function> constructor = val.As<Function>();
-
-  Local<Object> array = Nan::NewInstance(constructor, 1, &underlyingAB).ToLocalChecked();
+  Local<Object> array = NewView(type, underlyingAB, length);
 
-  if (array.IsEmpty() || !array->IsObject()) { throw "Error creating TypedArray"; }
+  if (array.IsEmpty()) { throw "Error creating TypedArray"; }
 
-  Nan::Set(array, Nan::New("_gdal_type").ToLocalChecked(), Nan::New(type));
+  Nan::Set(array, GdalTypeKey(), Nan::New(type));
 
   return scope.Escape(array);
 }
@@ -111,7 +119,7 @@ Local<Value> TypedArray::New(GDALDataType type, void *data, unsigned int length)
 GDALDataType TypedArray::Identify(Local<Object> obj) {
   Nan::HandleScope scope;
 
-  Local<String> sym = Nan::New("_gdal_type").ToLocalChecked();
+  Local<String> sym = GdalTypeKey();
   if (!Nan::HasOwnProperty(obj, sym).FromMaybe(false)) return GDT_Unknown;
   Local<Value> val = Nan::Get(obj, sym).ToLocalChecked();
   if (!val->IsNumber()) return GDT_Unknown;
@@ -136,6 +144,22 @@ void *TypedArray::Validate(Local<Object> obj, GDALDataType type, int min_length)
     Nan::ThrowTypeError(ss.str().c_str());
     return NULL;
   }
+  // Nan::TypedArrayContents supports only the regular ArrayBuffers
+  if (obj->IsArrayBufferView()) {
+    Local<ArrayBufferView> view = obj.As<ArrayBufferView>();
+    Local<Value> buffer = view->Buffer();
+    if (buffer->IsSharedArrayBuffer()) {
+      size_t element = GDALGetDataTypeSizeBytes(type);
+      if (ValidateLength(static_cast<int>(view->ByteLength() / element), min_length)) return NULL;
+#if V8_MAJOR_VERSION >= 8
+      uint8_t *data = static_cast<uint8_t *>(buffer.As<SharedArrayBuffer>()->GetBackingStore()->Data());
+#else
+      uint8_t *data = static_cast<uint8_t *>(buffer.As<SharedArrayBuffer>()->GetContents().Data());
+#endif
+      return data + view->ByteOffset();
+    }
+  }
+
   switch (type) {
     case GDT_Byte: {
       Nan::TypedArrayContents<GByte> contents(obj);
@@ -0,0 +1,261 @@
+#include "zonal_stats.hpp"
+#include "../gdal_spatial_reference.hpp"
+
+#include <gdal_alg.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace node_gdal {
+
+// A feature and its envelope in pixels, clamped to the grid of the blocks
+struct Zone {
+  std::unique_ptr<OGRGeometry> geom;
+  int x0, y0, x1, y1;
+};
+
+// Georeferenced coordinates <-> pixel coordinates relative to the origin of the rasterization buffer
+struct BlockTransform {
+  double gt[6], inv[6];
+  int x, y;
+};
+
+static int blockTransformer(void *arg, int dst_to_src, int count, double *x, double *y, double *, int *success) {
+  const BlockTransform *t = reinterpret_cast<const BlockTransform *>(arg);
+  for (int i = 0; i < count; i++) {
+    double a = x[i], b = y[i];
+    if (dst_to_src) {
+      a += t->x;
+      b += t->y;
+      x[i] = t->gt[0] + a * t->gt[1] + b * t->gt[2];
+      y[i] = t->gt[3] + a * t->gt[4] + b * t->gt[5];
+    } else {
+      x[i] = t->inv[0] + a * t->inv[1] + b * t->inv[2] - t->x;
+      y[i] = t->inv[3] + a * t->inv[4] + b * t->inv[5] - t->y;
+    }
+    success[i] = TRUE;
+  }
+  return TRUE;
+}
+
+// The envelope is grown by one pixel as the pixels that are only touched
+// by a boundary can be burnt with ALL_TOUCHED
+static void pixelEnvelope(const OGREnvelope &env, const double *inv, int grid_w, int grid_h, Zone &zone) {
+  double xs[] = {env.MinX, env.MaxX, env.MinX, env.MaxX};
+  double ys[] = {env.MinY, env.MinY, env.MaxY, env.MaxY};
+  double min_x = std::numeric_limits<double>::infinity(), max_x = -min_x;
+  double min_y = min_x, max_y = max_x;
+  for (int i = 0; i < 4; i++) {
+    double px = inv[0] + xs[i] * inv[1] + ys[i] * inv[2];
+    double py = inv[3] + xs[i] * inv[4] + ys[i] * inv[5];
+    min_x = std::min(min_x, px);
+    max_x = std::max(max_x, px);
+    min_y = std::min(min_y, py);
+    max_y = std::max(max_y, py);
+  }
+  zone.x0 = static_cast<int>(std::max(0.0, std::floor(min_x) - 1));
+  zone.y0 = static_cast<int>(std::max(0.0, std::floor(min_y) - 1));
+  zone.x1 = static_cast<int>(std::min(static_cast<double>(grid_w), std::ceil(max_x) + 1));
+  zone.y1 = static_cast<int>(std::min(static_cast<double>(grid_h), std::ceil(max_y) + 1));
+  if (zone.x1 <= zone.x0 || zone.y1 <= zone.y0) zone.x0 = zone.y0 = zone.x1 = zone.y1 = 0;
+}
+
+ZonalStatistics computeZonalStatistics(
+  const GDALExecutionProgress &progress,
+  long ds_uid,
+  GDALRasterBand *band,
+  OGRLayer *layer,
+  bool all_touched,
+  int parallel) {
+
+  if (GDALDataTypeIsComplex(band->GetRasterDataType())) throw "Complex data types are not supported";
+  GDALDataset *ds = band->GetDataset();
+  BlockTransform transform;
+  CPLErrorReset();
+  if (ds == nullptr || ds->GetGeoTransform(transform.gt) != CE_None) throw "The raster band has no geotransform";
+  if (!GDALInvGeoTransform(transform.gt, transform.inv)) throw "The geotransform of the raster band is not invertible";
+
+  // The geometries are reprojected when the layer and the raster have different SRS
+  std::unique_ptr<OGRCoordinateTransformation> ct;
+  OGRSpatialReference *layer_srs = layer->GetSpatialRef();
+  OGRChar *wkt = (OGRChar *)ds->GetProjectionRef();
+  if (layer_srs != nullptr && wkt != nullptr && *wkt != '\0') {
+    OGRSpatialReference raster_srs;
+    int err = raster_srs.importFromWkt(&wkt);
+    if (err) throw getOGRErrMsg(err);
+    if (!raster_srs.IsSame(layer_srs)) {
+      OGRSpatialReference layer_srs_gis(*layer_srs);
+#if GDAL_VERSION_MAJOR >= 3
+      // Both the geometries and the geotransform are in the GIS axis order
+      layer_srs_gis.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+      raster_srs.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+#endif
+      ct.reset(OGRCreateCoordinateTransformation(&layer_srs_gis, &raster_srs));
+      if (ct == nullptr) throw CPLGetLastErrorMsg();
+    }
+  }
+
+  int w = band->GetXSize(), h = band->GetYSize();
+  int block_w, block_h;
+  band->GetBlockSize(&block_w, &block_h);
+  if (block_w < 1) block_w = 1;
+  if (block_h < 1) block_h = 1;
+  int blocks_x = (w + block_w - 1) / block_w;
+  int blocks_y = (h + block_h - 1) / block_h;
+
+  ZonalStatistics result;
+  std::vector<Zone> zones;
+  // The zones intersecting each block
+  std::vector<std::vector<size_t>> blocks(static_cast<size_t>(blocks_x) * blocks_y);
+
+  layer->ResetReading();
+  OGRFeature *feature;
+  while ((feature = layer->GetNextFeature()) != nullptr) {
+    Zone zone;
+    zone.x0 = zone.y0 = zone.x1 = zone.y1 = 0;
+    result.fids.push_back(feature->GetFID());
+    zone.geom.reset(feature->StealGeometry());
+    OGRFeature::DestroyFeature(feature);
+    if (progress.isAborted()) throw abortedError;
+
+    if (zone.geom != nullptr && !zone.geom->IsEmpty()) {
+      if (ct != nullptr && zone.geom->transform(ct.get()) != OGRERR_NONE) {
+        throw "Failed reprojecting a geometry to the SRS of the raster";
+      }
+      OGREnvelope env;
+      zone.geom->getEnvelope(&env);
+      pixelEnvelope(env, transform.inv, blocks_x * block_w, blocks_y * block_h, zone);
+      for (int by = zone.y0 / block_h; zone.y1 > 0 && by <= (zone.y1 - 1) / block_h; by++)
+        for (int bx = zone.x0 / block_w; zone.x1 > 0 && bx <= (zone.x1 - 1) / block_w; bx++)
+          blocks[static_cast<size_t>(by) * blocks_x + bx].push_back(zones.size());
+    }
+    zones.push_back(std::move(zone));
+  }
+  result.zones.resize(zones.size());
+
+  // The blocks outside of all the envelopes are never read
+  std::vector<size_t> active;
+  for (size_t i = 0; i < blocks.size(); i++)
+    if (!blocks[i].empty()) active.push_back(i);
+  if (active.empty()) return result;
+
+  GDALDriver *mem_driver = GetGDALDriverManager()->GetDriverByName("MEM");
+  if (mem_driver == nullptr) throw "MEM driver not available";
+
+  bool masked = !(band->GetMaskFlags() & (GMF_ALL_VALID | GMF_NODATA));
+  NoDataFilter filter(band);
+  char **options = all_touched ? CSLSetNameValue(nullptr, "ALL_TOUCHED", "TRUE") : nullptr;
+
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  std::mutex lock;
+  std::string error;
+
+  auto fail = [&](const char *msg) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!failed) error = msg;
+    failed = true;
+  };
+
+  auto worker = [&](GDALRasterBand *src) {
+    std::vector<double> values, selected;
+    std::vector<GByte> mask, burnt;
+    std::vector<PartialStats> partial(zones.size());
+    BlockTransform block_transform = transform;
+    int burn_band = 1;
+    double burn_value = 1;
+
+    size_t i;
+    while (!failed && (i = next++) < active.size()) {
+      if (progress.isAborted()) {
+        fail(abortedError);
+        break;
+      }
+      size_t block = active[i];
+      int bx = static_cast<int>(block % blocks_x) * block_w;
+      int by = static_cast<int>(block / blocks_x) * block_h;
+      int bw = std::min(block_w, w - bx);
+      int bh = std::min(block_h, h - by);
+      if (readValues(src, bx, by, bw, bh, masked, values, mask) != CE_None) {
+        fail(CPLGetLastErrorMsg());
+        break;
+      }
+
+      for (size_t z : blocks[block]) {
+        const Zone &zone = zones[z];
+        // The envelope of the zone in the block
+        int x0 = std::max(zone.x0 - bx, 0), x1 = std::min(zone.x1 - bx, bw);
+        int y0 = std::max(zone.y0 - by, 0), y1 = std::min(zone.y1 - by, bh);
+        if (x1 <= x0 || y1 <= y0) continue;
+        int zw = x1 - x0, zh = y1 - y0;
+
+        // Every zone is burnt in a buffer the size of its envelope, the transformer
+        // maps its origin to the top left corner of the envelope
+        burnt.assign(static_cast<size_t>(zw) * zh, 0);
+        block_transform.x = bx + x0;
+        block_transform.y = by + y0;
+        CPLErrorReset();
+        GDALDataset *mem = mem_driver->Create("", zw, zh, 0, GDT_Byte, nullptr);
+        if (mem == nullptr) {
+          fail(CPLGetLastErrorMsg());
+          break;
+        }
+        char pointer[64];
+        int len = CPLPrintPointer(pointer, burnt.data(), sizeof(pointer));
+        pointer[len] = '\0';
+        char **band_options = CSLSetNameValue(nullptr, "DATAPOINTER", pointer);
+        CPLErr err = mem->AddBand(GDT_Byte, band_options);
+        CSLDestroy(band_options);
+        OGRGeometryH geom = reinterpret_cast<OGRGeometryH>(zone.geom.get());
+        if (err == CE_None)
+          err = GDALRasterizeGeometries(
+            reinterpret_cast<GDALDatasetH>(mem),
+            1,
+            &burn_band,
+            1,
+            &geom,
+            blockTransformer,
+            &block_transform,
+            &burn_value,
+            options,
+            nullptr,
+            nullptr);
+        GDALClose(mem);
+        if (err != CE_None) {
+          fail(CPLGetLastErrorMsg());
+          break;
+        }
+
+        selected.clear();
+        for (int y = y0; y < y1; y++) {
+          const GByte *row = burnt.data() + static_cast<size_t>(y - y0) * zw;
+          const double *data = values.data() + static_cast<size_t>(y) * bw;
+          for (int x = x0; x < x1; x++)
+            if (row[x - x0]) selected.push_back(data[x]);
+        }
+        partial[z].reduce(selected.data(), selected.size(), filter);
+      }
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (size_t z = 0; z < zones.size(); z++) result.zones[z].merge(partial[z]);
+  };
+
+  size_t threads = parallel > 1 ? std::min(static_cast<size_t>(parallel), active.size()) : 1;
+  runOnPooledBands(ds_uid, band, -1, threads, worker);
+  CSLDestroy(options);
+
+  if (failed) {
+    // Move the error message to this thread
+    CPLError(CE_Failure, CPLE_AppDefined, "%s", error.c_str());
+    throw CPLGetLastErrorMsg();
+  }
+  return result;
+}
+
+} // namespace node_gdal
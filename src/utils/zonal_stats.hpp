@@ -0,0 +1,36 @@
+#ifndef __ZONAL_STATS_H__
+#define __ZONAL_STATS_H__
+
+// gdal
+#include <gdal_priv.h>
+
+// ogr
+#include <ogrsf_frmts.h>
+
+#include "block_reducer.hpp"
+
+#include <vector>
+
+namespace node_gdal {
+
+// The statistics of the pixels of a band covered by each feature of a layer
+struct ZonalStatistics {
+  std::vector<GIntBig> fids;
+  std::vector<PartialStats> zones;
+};
+
+// Every feature is rasterized separately, block by block, only in the blocks
+// that intersect its envelope - the features can overlap
+// The blocks are distributed over the job's own handle and the free handles
+// of a pooled Dataset, the geometries are reprojected to the SRS of the raster
+// Throws a const char * on error
+ZonalStatistics computeZonalStatistics(
+  const GDALExecutionProgress &progress,
+  long ds_uid,
+  GDALRasterBand *band,
+  OGRLayer *layer,
+  bool all_touched,
+  int parallel);
+
+} // namespace node_gdal
+#endif
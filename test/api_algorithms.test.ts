@@ -434,6 +434,115 @@ describe('gdal', () => {
     })
   })
 
+  describe('zonalStatistics()', () => {
+    let src: gdal.Dataset, srcband: gdal.RasterBand, zones: gdal.Dataset, lyr: gdal.Layer
+
+    const addZone = (wkt: string) => {
+      const feature = new gdal.Feature(lyr)
+      feature.setGeometry(gdal.Geometry.fromWKT(wkt))
+      lyr.features.add(feature)
+    }
+
+    before(() => {
+      // the value of a pixel is its column, the pixel (x, y) covers [x, x + 1] x [63 - y, 64 - y]
+      src = gdal.open('temp', 'w', 'MEM', 64, 64, 1, gdal.GDT_Float64)
+      src.geoTransform = [ 0, 1, 0, 64, 0, -1 ]
+      srcband = src.bands.get(1)
+      const data = new Float64Array(64 * 64)
+      for (let i = 0; i < data.length; i++) data[i] = i % 64
+      srcband.pixels.write(0, 0, 64, 64, data)
+      zones = gdal.open('temp', 'w', 'Memory')
+      lyr = zones.layers.create('zones', null, gdal.Polygon)
+      addZone('POLYGON((0 54,10 54,10 64,0 64,0 54))')
+      // overlaps the first one
+      addZone('POLYGON((5 54,15 54,15 64,5 64,5 54))')
+      // outside of the raster
+      addZone('POLYGON((100 100,110 100,110 110,100 110,100 100))')
+      // inside of a pixel without covering its center
+      addZone('POLYGON((0.6 63.6,0.9 63.6,0.9 63.9,0.6 63.9,0.6 63.6))')
+    })
+    after(() => {
+      src.close()
+      zones.close()
+    })
+    it('should compute the statistics of each feature', () => {
+      const r = gdal.zonalStatistics(srcband, lyr)
+      assert.deepEqual(Array.from(r.fid), [ 0, 1, 2, 3 ])
+      assert.deepEqual(Array.from(r.count), [ 100, 100, 0, 0 ])
+      assert.deepEqual(Array.from(r.sum), [ 450, 950, 0, 0 ])
+      assert.deepEqual(Array.from(r.min.subarray(0, 2)), [ 0, 5 ])
+      assert.deepEqual(Array.from(r.max.subarray(0, 2)), [ 9, 14 ])
+      assert.closeTo(r.mean[0], 4.5, 1e-9)
+      assert.closeTo(r.mean[1], 9.5, 1e-9)
+      assert.closeTo(r.std[0], Math.sqrt(8.25), 1e-9)
+      assert.isNaN(r.mean[2])
+      assert.isNaN(r.min[3])
+    })
+    it('should return only the requested statistics', () => {
+      const r = gdal.zonalStatistics(srcband, lyr, { stats: [ 'count', 'max' ] })
+      assert.sameMembers(Object.keys(r), [ 'fid', 'count', 'max' ])
+      assert.instanceOf(r.count, Float64Array)
+    })
+    it('should support "allTouched"', () => {
+      const r = gdal.zonalStatistics(srcband, lyr, { stats: [ 'count' ], allTouched: true })
+      assert.equal(r.count[3], 1)
+    })
+    it('should ignore the NoData values', () => {
+      srcband.noDataValue = 0
+      try {
+        const r = gdal.zonalStatistics(srcband, lyr, { stats: [ 'count', 'min' ] })
+        assert.equal(r.count[0], 90)
+        assert.equal(r.min[0], 1)
+      } finally {
+        srcband.noDataValue = null
+      }
+    })
+    it('should throw on an invalid statistic', () => {
+      assert.throws(() => {
+        gdal.zonalStatistics(srcband, lyr, { stats: [ 'median' ] })
+      }, /stats must be an array/)
+    })
+    it('should throw if the raster has no geotransform', () => {
+      const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte)
+      assert.throws(() => {
+        gdal.zonalStatistics(ds.bands.get(1), lyr)
+      }, /geotransform/)
+    })
+  })
+
+  describe('zonalStatisticsAsync()', () => {
+    it('should compute the same statistics with "parallel"', () => {
+      const file = `/vsimem/zonal_parallel.${String(Math.random()).substring(2)}.tmp.tif`
+      const ds = gdal.open(file, 'w', 'GTiff', 64, 64, 1, gdal.GDT_Float64, { TILED: 'YES', BLOCKXSIZE: 16, BLOCKYSIZE: 16 })
+      ds.geoTransform = [ 0, 1, 0, 64, 0, -1 ]
+      const data = new Float64Array(64 * 64)
+      for (let i = 0; i < data.length; i++) data[i] = Math.sin(i) * 100
+      ds.bands.get(1).pixels.write(0, 0, 64, 64, data)
+      ds.close()
+
+      const zones = gdal.open('temp', 'w', 'Memory')
+      const lyr = zones.layers.create('zones', null, gdal.Polygon)
+      for (let i = 0; i < 20; i++) {
+        const feature = new gdal.Feature(lyr)
+        feature.setGeometry(gdal.Geometry.fromWKT(
+          `POLYGON((${i} ${i},${i * 3 + 5} ${i},${i * 2 + 10} ${i * 3 + 4},${i} ${i})`))
+        lyr.features.add(feature)
+      }
+      const expected = gdal.zonalStatistics(gdal.open(file).bands.get(1), lyr)
+      const pool = gdal.openPool(file, { handles: 4 })
+      return assert.isFulfilled(gdal.zonalStatisticsAsync(pool.bands.get(1), lyr, { parallel: 4 }).then((r) => {
+        assert.deepEqual(Array.from(r.fid), Array.from(expected.fid))
+        assert.deepEqual(Array.from(r.count), Array.from(expected.count))
+        assert.deepEqual(Array.from(r.min), Array.from(expected.min))
+        assert.deepEqual(Array.from(r.max), Array.from(expected.max))
+        for (let i = 0; i < r.mean.length; i++) assert.closeTo(r.mean[i], expected.mean[i], 1e-9)
+        pool.close()
+        zones.close()
+        gdal.vsimem.release(file)
+      }))
+    })
+  })
+
   describe('addPixelFunc()', () => {
     it('should throw with invalid arguments', () => {
       assert.throws(() => {
@@ -612,6 +721,41 @@ describe('gdal', () => {
         assert.closeTo(result[i], input1[i] + input2[i] + 20, 1e-6)
       }
     })
+
+    it('should support concurrent calls from several Datasets', function () {
+      if (!semver.gte(gdal.version, '3.5.0-git')) this.skip()
+      const argsSeen = new Set<Record<string, string|number>>()
+      const concurrent = (sources: gdal.TypedArray[], buffer: gdal.TypedArray, args: Record<string, string|number>) => {
+        argsSeen.add(args)
+        for (let i = 0; i < buffer.length; i++) {
+          buffer[i] = sources[0][i] - sources[1][i] + +args.k
+        }
+      }
+      gdal.addPixelFunc('concurrent', gdal.toPixelFunc(concurrent))
+
+      const input1 = band1.pixels.read(0, 0, band1.size.x, band1.size.y)
+      const input2 = band2.pixels.read(0, 0, band1.size.x, band1.size.y)
+      const datasets = [ 1, 2, 3, 4, 5, 6 ].map(() => gdal.open(gdal.wrapVRT({
+        bands: [
+          {
+            sources: [ band1, band2 ],
+            pixelFunc: 'concurrent',
+            pixelFuncArgs: { k: 7 }
+          }
+        ]
+      })))
+      return assert.isFulfilled(Promise.all(datasets.map((ds) =>
+        ds.bands.get(1).pixels.readAsync(0, 0, ds.rasterSize.x, ds.rasterSize.y)
+          .then((result) => {
+            for (let i = 0; i < ds.rasterSize.x * ds.rasterSize.y; i += 256) {
+              assert.closeTo(result[i], input1[i] - input2[i] + 7, 1e-6)
+            }
+          })))
+        .then(() => {
+          // The parsed arguments are reused
+          assert.equal(argsSeen.size, 1)
+        }))
+    })
   })
 
   describe('createPixelFunc()', () => {
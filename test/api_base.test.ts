@@ -3,6 +3,7 @@ import { assert } from 'chai'
 import * as path from 'path'
 import * as fs from 'fs'
 import * as cp from 'child_process'
+import { Worker } from 'worker_threads'
 
 if (process.env.GDAL_DATA !== undefined) {
   throw new Error(
@@ -117,6 +118,71 @@ describe('gdal', () => {
       assert.equal(gdal.decToDMS(14.12511, 'long', 1), " 14d 7'30.4\"E")
     })
   })
+  describe('stats()', () => {
+    it('should count the sync and async calls', () => {
+      gdal.resetStats()
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const band = ds.bands.get(1)
+      band.pixels.read(0, 0, 20, 30)
+      return band.pixels.readAsync(0, 0, 20, 30).then(() => {
+        const stats = gdal.stats()
+        const read = stats.methods['RasterBandPixels::read']
+        assert.equal(read.calls, 2)
+        assert.equal(read.errors, 0)
+        assert.equal(read.execute.count, 2)
+        assert.equal(read.lock.count, 1)
+        assert.equal(read.queue.count, 1)
+        assert.equal(read.pool.count, 1)
+        assert.isAtLeast(read.execute.p99, read.execute.p50)
+        assert.equal(read.execute.buckets.reduce((a, b) => a + b[1], 0), 2)
+        assert.isAtLeast(stats.datasets[(ds as any)._uid].calls, 2)
+      })
+    })
+    it('should drop the counters of a closed Dataset', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const uid = (ds as any)._uid
+      ds.bands.get(1).pixels.read(0, 0, 20, 30)
+      assert.property(gdal.stats().datasets, String(uid))
+      ds.close()
+      assert.notProperty(gdal.stats().datasets, String(uid))
+    })
+    it('should be cleared by resetStats()', () => {
+      gdal.resetStats()
+      assert.deepEqual(gdal.stats(), { methods: {}, datasets: {} })
+    })
+  })
+  describe('worker_threads', () => {
+    const gdalJS = path.resolve(fs.existsSync('./lib/gdal.js') ? './lib/gdal.js' : 'node_modules/gdal-async')
+    const runWorker = (code: string): Promise<number[]> => new Promise((resolve, reject) => {
+      const worker = new Worker(`const gdal = require(${JSON.stringify(gdalJS)});
+        const { parentPort } = require('worker_threads');
+        ${code}`, { eval: true })
+      worker.on('message', resolve)
+      worker.on('error', reject)
+    })
+    const file = `${__dirname}/data/sample.tif`
+    const readWorker = `gdal.openAsync(${JSON.stringify(file)})
+      .then((ds) => ds.bands.get(1).pixels.readAsync(0, 0, 20, 30))
+      .then((data) => parentPort.postMessage(Array.from(data)))`
+
+    it('should be loadable in a Worker', () =>
+      runWorker(readWorker).then((data) => {
+        const expected = gdal.open(file).bands.get(1).pixels.read(0, 0, 20, 30)
+        assert.deepEqual(data, Array.from(expected))
+      })
+    )
+    it('should support multiple Workers running concurrently with the main thread', () => {
+      const ds = gdal.open(file)
+      return Promise.all([
+        runWorker(readWorker),
+        runWorker(readWorker),
+        ds.bands.get(1).pixels.readAsync(0, 0, 20, 30)
+      ]).then(([ a, b, main ]) => {
+        assert.deepEqual(a, Array.from(main))
+        assert.deepEqual(b, Array.from(main))
+      })
+    })
+  })
   describe('Node.js Async callback error convention', () => {
     it('should return null for error on success', (done) => {
       gdal.openAsync(`${__dirname}/data/sample.tif`, (error, result) => {
@@ -1172,6 +1172,249 @@ describe('gdal.Dataset', () => {
         return assert.isRejected(ds.buildOverviewsAsync('NEAREST', [ 2, 4, 8 ]))
       })
     })
+    describe('batch()', () => {
+      it('should return the results of all operations', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        const data = new Uint8Array(20 * 30)
+        const r = ds.batch([
+          { op: 'rasterSize' },
+          { op: 'geoTransform' },
+          { op: 'srs' },
+          { op: 'bandCount' },
+          { op: 'band', band: 1 },
+          { op: 'read', band: 1, x: 190, y: 290, width: 20, height: 30 },
+          { op: 'read', band: 1, x: 190, y: 290, width: 20, height: 30, data }
+        ])
+        assert.lengthOf(r, 7)
+        assert.deepEqual(r[0], ds.rasterSize)
+        assert.deepEqual(r[1], ds.geoTransform)
+        assert.instanceOf(r[2], gdal.SpatialReference)
+        assert.equal(r[3], ds.bands.count())
+        assert.instanceOf(r[4], gdal.RasterBand)
+        assert.instanceOf(r[5], Uint8Array)
+        assert.equal(r[5][10 * 20 + 10], 10)
+        assert.strictEqual(r[6], data)
+        assert.equal(data[10 * 20 + 10], 10)
+      })
+      it('should throw on invalid operations', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        assert.throws(() => ds.batch([ { op: 'format' } ]), /Invalid batch operation/)
+        assert.throws(() => ds.batch([ { op: 'band', band: 2 } ]), /Invalid band number/)
+      })
+    })
+    describe('batchAsync()', () => {
+      it('should return the results of all operations', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        const p = ds.batchAsync([
+          { op: 'rasterSize' },
+          { op: 'noDataValue', band: 1 },
+          { op: 'read', band: 1, x: 190, y: 290, width: 20, height: 30 }
+        ])
+        return assert.isFulfilled(p.then((r) => {
+          assert.deepEqual(r[0], ds.rasterSize)
+          assert.equal(r[1], ds.bands.get(1).noDataValue)
+          assert.equal(r[2][10 * 20 + 10], 10)
+        }))
+      })
+      it('should reject if dataset already closed', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        ds.close()
+        return assert.isRejected(ds.batchAsync([ { op: 'rasterSize' } ]))
+      })
+    })
+    describe('renderTile()', () => {
+      // The whole WebMercatorQuad at zoom 1, one value per quadrant
+      const createWorld = (file: string, driver: string) => {
+        const extent = 20037508.342789244
+        const ds = gdal.open(file, 'w', driver, 512, 512, 1, gdal.GDT_Byte)
+        ds.srs = gdal.SpatialReference.fromEPSG(3857)
+        ds.geoTransform = [ -extent, 2 * extent / 512, 0, extent, 0, -2 * extent / 512 ]
+        const data = new Uint8Array(512 * 512)
+        for (let y = 0; y < 512; y++) {
+          for (let x = 0; x < 512; x++) {
+            data[y * 512 + x] = 10 + (x >= 256 ? 10 : 0) + (y >= 256 ? 20 : 0)
+          }
+        }
+        ds.bands.get(1).pixels.write(0, 0, 512, 512, data)
+        return ds
+      }
+      it('should render a raw tile', () => {
+        const ds = createWorld('temp', 'MEM')
+        const tile = ds.renderTile({ z: 1, x: 1, y: 0, format: 'raw' })
+        assert.instanceOf(tile, Buffer)
+        assert.lengthOf(tile, 256 * 256)
+        assert.equal(tile[0], 20)
+        assert.equal(tile[128 * 256 + 128], 20)
+        assert.equal(tile[256 * 256 - 1], 20)
+      })
+      it('should downsample a lower zoom level', () => {
+        const ds = createWorld('temp', 'MEM')
+        const tile = ds.renderTile({ z: 0, x: 0, y: 0, format: 'raw', tileSize: 128 })
+        assert.lengthOf(tile, 128 * 128)
+        assert.equal(tile[32 * 128 + 32], 10)
+        assert.equal(tile[32 * 128 + 96], 20)
+        assert.equal(tile[96 * 128 + 32], 30)
+        assert.equal(tile[96 * 128 + 96], 40)
+      })
+      it('should add an alpha band', () => {
+        const ds = createWorld('temp', 'MEM')
+        const tile = ds.renderTile({ z: 2, x: 1, y: 2, format: 'raw', alpha: true })
+        assert.lengthOf(tile, 256 * 256 * 2)
+        assert.equal(tile[0], 30)
+        assert.equal(tile[1], 255)
+      })
+      it('should render a PNG tile', () => {
+        const ds = createWorld('temp', 'MEM')
+        const tile = ds.renderTile({ z: 1, x: 0, y: 1 })
+        assert.deepEqual(Array.from(tile.subarray(0, 4)), [ 0x89, 0x50, 0x4e, 0x47 ])
+        const file = `/vsimem/tile.${String(Math.random()).substring(2)}.tmp.png`
+        gdal.vsimem.set(tile, file)
+        const png = gdal.open(file)
+        assert.equal(png.rasterSize.x, 256)
+        assert.equal(png.bands.count(), 2)
+        assert.equal(png.bands.get(1).pixels.get(128, 128), 30)
+        assert.equal(png.bands.get(2).pixels.get(128, 128), 255)
+        png.close()
+        gdal.vsimem.release(file)
+      })
+      it('should expand a single band to RGB in a WEBP tile', function () {
+        if (!gdal.drivers.get('WEBP')) this.skip()
+        const ds = createWorld('temp', 'MEM')
+        const tile = ds.renderTile({ z: 1, x: 0, y: 1, format: 'webp' })
+        const file = `/vsimem/tile.${String(Math.random()).substring(2)}.tmp.webp`
+        gdal.vsimem.set(tile, file)
+        const webp = gdal.open(file)
+        assert.equal(webp.bands.count(), 4)
+        webp.close()
+        gdal.vsimem.release(file)
+      })
+      it('should render a WorldCRS84Quad tile', () => {
+        const ds = createWorld('temp', 'MEM')
+        const tile = ds.renderTile({ z: 0, x: 1, y: 0, srs: 'EPSG:4326', format: 'raw', tileSize: 64 })
+        assert.lengthOf(tile, 64 * 64)
+        assert.equal(tile[16 * 64 + 32], 20)
+        assert.equal(tile[48 * 64 + 32], 40)
+      })
+      it('should throw on invalid tiles', () => {
+        const ds = createWorld('temp', 'MEM')
+        assert.throws(() => ds.renderTile({ z: 1, x: 2, y: 0 }), /out of range/)
+        assert.throws(() => ds.renderTile({ z: 0, x: 0, y: 0, srs: 'EPSG:2154' }), /srs must be/)
+        assert.throws(() => ds.renderTile({ z: 0, x: 0, y: 0, format: 'tiff' }), /format must be/)
+        assert.throws(() => ds.renderTile({ z: 0, x: 0, y: 0, bands: [ 2 ] }), /Invalid band number/)
+      })
+      it('should throw if dataset already closed', () => {
+        const ds = createWorld('temp', 'MEM')
+        ds.close()
+        assert.throws(() => ds.renderTile({ z: 0, x: 0, y: 0 }), /already been destroyed/)
+      })
+    })
+    describe('renderTileAsync()', () => {
+      it('should render the same tiles in parallel on a pool', () => {
+        const extent = 20037508.342789244
+        const file = `/vsimem/tiles.${String(Math.random()).substring(2)}.tmp.tif`
+        const ds = gdal.open(file, 'w', 'GTiff', 512, 512, 1, gdal.GDT_Byte, { TILED: 'YES' })
+        ds.srs = gdal.SpatialReference.fromEPSG(3857)
+        ds.geoTransform = [ -extent, 2 * extent / 512, 0, extent, 0, -2 * extent / 512 ]
+        const data = new Uint8Array(512 * 512)
+        for (let i = 0; i < data.length; i++) data[i] = i % 251
+        ds.bands.get(1).pixels.write(0, 0, 512, 512, data)
+        ds.close()
+
+        const tiles = [ [ 1, 0, 0 ], [ 1, 1, 0 ], [ 1, 0, 1 ], [ 1, 1, 1 ], [ 2, 1, 2 ], [ 2, 3, 3 ] ]
+        const reference = gdal.open(file)
+        const expected = tiles.map(([ z, x, y ]) => reference.renderTile({ z, x, y, format: 'raw' }))
+        reference.close()
+
+        const pool = gdal.openPool(file, { handles: 4 })
+        return assert.isFulfilled(Promise.all(tiles.map(([ z, x, y ]) =>
+          pool.renderTileAsync({ z, x, y, format: 'raw' }))).then((r) => {
+          for (let i = 0; i < tiles.length; i++) assert.isTrue(r[i].equals(expected[i]))
+          pool.close()
+          gdal.vsimem.release(file)
+        }))
+      })
+      it('should reject on invalid tiles', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        return assert.isRejected(ds.renderTileAsync({ z: 0, x: 0, y: 1 }), /out of range/)
+      })
+      it('should reject if dataset already closed', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        ds.close()
+        return assert.isRejected(ds.renderTileAsync({ z: 0, x: 0, y: 0 }))
+      })
+    })
+    describe('pixels', () => {
+      const readBands = (ds: gdal.Dataset, bands: number[]) =>
+        bands.map((b) => ds.bands.get(b).pixels.read(10, 20, 30, 40))
+
+      describe('read()', () => {
+        it('should read several bands pixel-interleaved', () => {
+          const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+          const expected = readBands(ds, [ 1, 2, 3 ])
+          const data = ds.pixels.read(10, 20, 30, 40, undefined, { bands: [ 1, 2, 3 ], interleave: 'pixel' })
+          assert.lengthOf(data, 30 * 40 * 3)
+          for (let i = 0; i < 30 * 40; i++) {
+            for (let b = 0; b < 3; b++) assert.equal(data[i * 3 + b], expected[b][i])
+          }
+        })
+        it('should read several bands band-interleaved', () => {
+          const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+          const expected = readBands(ds, [ 3, 1 ])
+          const data = ds.pixels.read(10, 20, 30, 40, undefined, { bands: [ 3, 1 ], interleave: 'band' })
+          assert.deepEqual(data.subarray(0, 30 * 40), expected[0])
+          assert.deepEqual(data.subarray(30 * 40), expected[1])
+        })
+        it('should read all bands by default', () => {
+          const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+          const data = ds.pixels.read(10, 20, 30, 40)
+          assert.lengthOf(data, 30 * 40 * ds.bands.count())
+        })
+        it('should convert to options.type', () => {
+          const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+          const expected = readBands(ds, [ 1, 2 ])
+          const data = ds.pixels.read(10, 20, 30, 40, undefined, { bands: [ 1, 2 ], type: gdal.GDT_Float32 })
+          assert.instanceOf(data, Float32Array)
+          assert.equal(data[1], expected[1][0])
+        })
+        it('should throw on invalid arguments', () => {
+          const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+          assert.throws(() => ds.pixels.read(0, 0, 10, 10, undefined, { bands: [ 0 ] }), /Invalid band number/)
+          assert.throws(() => ds.pixels.read(0, 0, 10, 10, new Uint8Array(10), { bands: [ 1, 2 ] }))
+        })
+      })
+      describe('readAsync()', () => {
+        it('should read several bands in a single operation', () => {
+          const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+          const expected = ds.pixels.read(10, 20, 30, 40, undefined, { bands: [ 1, 2, 3 ] })
+          return assert.isFulfilled(ds.pixels.readAsync(10, 20, 30, 40, undefined, { bands: [ 1, 2, 3 ] })
+            .then((data) => assert.deepEqual(data, expected)))
+        })
+      })
+      describe('write()', () => {
+        it('should write several bands from a single array', () => {
+          const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 3, gdal.GDT_Byte)
+          const data = new Uint8Array(16 * 16 * 3)
+          for (let i = 0; i < data.length; i++) data[i] = i % 3 + 1
+          ds.pixels.write(0, 0, 16, 16, data)
+          for (let b = 1; b <= 3; b++) {
+            assert.isTrue(ds.bands.get(b).pixels.read(0, 0, 16, 16).every((v) => v === b))
+          }
+        })
+      })
+      describe('writeAsync()', () => {
+        it('should write several bands from a single array', () => {
+          const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 2, gdal.GDT_Byte)
+          const data = new Uint8Array(16 * 16 * 2)
+          data.fill(7, 0, 16 * 16)
+          data.fill(9, 16 * 16)
+          return assert.isFulfilled(ds.pixels.writeAsync(0, 0, 16, 16, data, { interleave: 'band' }).then((r) => {
+            assert.isUndefined(r)
+            assert.isTrue(ds.bands.get(1).pixels.read(0, 0, 16, 16).every((v) => v === 7))
+            assert.isTrue(ds.bands.get(2).pixels.read(0, 0, 16, 16).every((v) => v === 9))
+          }))
+        })
+      })
+    })
   })
   describe('setGCPs()', () => {
     it('should update gcps', () => {
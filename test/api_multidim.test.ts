@@ -382,6 +382,27 @@ describe('gdal', () => {
         assert.equal(data.length, 25)
       })
 
+      it('should read into a SharedArrayBuffer', () => {
+        const pre = new Uint32Array(new SharedArrayBuffer(25 * Uint32Array.BYTES_PER_ELEMENT))
+        const data = mdarray.read({
+          origin: [ 0, 0, 0 ],
+          span: [ 1, 5, 5 ],
+          data: pre
+        })
+        assert.equal(data, pre)
+        assert.deepEqual(Array.from(data), Array.from(mdarray.read({ origin: [ 0, 0, 0 ], span: [ 1, 5, 5 ] })))
+      })
+
+      it('should allocate a SharedArrayBuffer', () => {
+        const data = mdarray.read({
+          origin: [ 0, 0, 0 ],
+          span: [ 1, 5, 5 ],
+          shared: true
+        })
+        assert.instanceOf(data.buffer, SharedArrayBuffer)
+        assert.equal(data.length, 25)
+      })
+
       it('should support different strides when reading', () => {
         const data = mdarray.read({
           origin: [ 0, 0, 0 ],
@@ -137,6 +137,69 @@ describe('gdal.RasterBandAsync', () => {
             }))
           }))
         })
+        it('should not starve the other Datasets', () => {
+          const ds1 = gdal.open(`${__dirname}/data/sample.tif`)
+          const ds2 = gdal.open(`${__dirname}/data/sample.tif`)
+          const band1 = ds1.bands.get(1)
+          const band2 = ds2.bands.get(1)
+          const order: number[] = []
+          const q1: Promise<void>[] = []
+          for (let i = 0; i < 20; i++) {
+            q1.push(band1.pixels.readAsync(0, 0, ds1.rasterSize.x, ds1.rasterSize.y).then(() => {
+              order.push(1)
+            }))
+          }
+          const q2 = band2.pixels.readAsync(0, 0, 20, 30).then(() => {
+            order.push(2)
+          })
+          return assert.isFulfilled(Promise.all([ ...q1, q2 ]).then(() => {
+            assert.lengthOf(order, 21)
+            assert.notEqual(order[order.length - 1], 2)
+          }))
+        })
+        it('should reject when aborted while waiting in the queue', function () {
+          if (typeof AbortController === 'undefined') this.skip()
+          const ds = gdal.open(`${__dirname}/data/sample.tif`)
+          const band = ds.bands.get(1)
+          const ac = new AbortController()
+          const q1 = band.pixels.readAsync(0, 0, ds.rasterSize.x, ds.rasterSize.y)
+          const q2 = band.pixels.readAsync(0, 0, 20, 30, undefined, { signal: ac.signal })
+          const q3 = band.pixels.readAsync(0, 0, 20, 30)
+          ac.abort()
+          return Promise.all([
+            assert.isFulfilled(q1),
+            assert.isRejected(q2, /aborted/),
+            assert.isFulfilled(q3)
+          ])
+        })
+        it('should start the higher priority operations first', () => {
+          const ds = gdal.open(`${__dirname}/data/sample.tif`)
+          const band = ds.bands.get(1)
+          const order: number[] = []
+          const q = [
+            band.pixels.readAsync(0, 0, ds.rasterSize.x, ds.rasterSize.y).then(() => order.push(0)),
+            band.pixels.readAsync(0, 0, 20, 30, undefined, { priority: -1 }).then(() => order.push(-1)),
+            band.pixels.readAsync(0, 0, 20, 30).then(() => order.push(1)),
+            band.pixels.readAsync(0, 0, 20, 30, undefined, { priority: 5 }).then(() => order.push(5))
+          ]
+          return assert.isFulfilled(Promise.all(q).then(() => {
+            assert.deepEqual(order, [ 0, 5, 1, -1 ])
+          }))
+        })
+        it('should reject when the deadline has expired', () => {
+          const ds = gdal.open(`${__dirname}/data/sample.tif`)
+          const band = ds.bands.get(1)
+          return assert.isRejected(band.pixels.readAsync(0, 0, 20, 30, undefined, { deadline: Date.now() - 1 }),
+            /Deadline exceeded/)
+        })
+        it('should reject when the signal is already aborted', function () {
+          if (typeof AbortController === 'undefined') this.skip()
+          const ds = gdal.open(`${__dirname}/data/sample.tif`)
+          const ac = new AbortController()
+          ac.abort()
+          return assert.isRejected(ds.bands.get(1).pixels.readAsync(0, 0, 20, 30, undefined, { signal: ac.signal }),
+            /aborted/)
+        })
         describe('w/data argument', () => {
           it('should put the data in the existing array', () => {
             const ds = gdal.openAsync('temp',
@@ -362,6 +425,144 @@ describe('gdal.RasterBandAsync', () => {
               }))
             })
           })
+          describe('"convertNoData", "unscale"', () => {
+            it('should convert the values in the worker thread', () => {
+              const ds = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Int16)
+              const band = ds.bands.get(1)
+              band.noDataValue = 7
+              band.scale = 2
+              band.offset = 1
+              band.pixels.write(0, 0, 4, 1, new Int16Array([ 1, 7, 3, 7 ]))
+              return assert.isFulfilled(band.pixels.readAsync(0, 0, 4, 1, undefined,
+                { type: gdal.GDT_Float64, convertNoData: true, unscale: true })
+                .then((data) => assert.deepEqual(Array.from(data), [ 3, NaN, 7, NaN ])))
+            })
+            it('should reject when the data type cannot hold the result', () => {
+              const ds = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Int16)
+              const band = ds.bands.get(1)
+              return assert.isRejected(band.pixels.readAsync(0, 0, 4, 1, undefined, { unscale: true }), /floating point/)
+            })
+          })
+          describe('"shared"', () => {
+            it('should allocate a SharedArrayBuffer', () => {
+              const ds = gdal.open(`${__dirname}/data/sample.tif`)
+              const band = ds.bands.get(1)
+              const expected = band.pixels.read(0, 0, 64, 32)
+              return assert.isFulfilled(band.pixels.readAsync(0, 0, 64, 32, undefined, { shared: true })
+                .then((data) => {
+                  assert.instanceOf(data.buffer, SharedArrayBuffer)
+                  assert.deepEqual(Array.from(data), Array.from(expected))
+                }))
+            })
+            it('should read into a SharedArrayBuffer', () => {
+              const ds = gdal.open(`${__dirname}/data/sample.tif`)
+              const band = ds.bands.get(1)
+              const expected = band.pixels.read(0, 0, 64, 32)
+              const sab = new SharedArrayBuffer(64 * 32 + 16)
+              const data = new Uint8Array(sab, 16)
+              return assert.isFulfilled(band.pixels.readAsync(0, 0, 64, 32, data)
+                .then((result) => {
+                  assert.strictEqual(result, data)
+                  assert.deepEqual(Array.from(new Uint8Array(sab, 16)), Array.from(expected))
+                  assert.deepEqual(Array.from(new Uint8Array(sab, 0, 16)), new Array(16).fill(0))
+                }))
+            })
+            it('should read a block into a SharedArrayBuffer', () => {
+              const ds = gdal.open(`${__dirname}/data/sample.tif`)
+              const band = ds.bands.get(1)
+              const size = band.blockSize.x * band.blockSize.y
+              const expected = band.pixels.readBlock(0, 0)
+              const small = new Uint8Array(new SharedArrayBuffer(size - 1))
+              const data = new Uint8Array(new SharedArrayBuffer(size))
+              return assert.isRejected(band.pixels.readBlockAsync(0, 0, small))
+                .then(() => band.pixels.readBlockAsync(0, 0, data))
+                .then((result) => assert.deepEqual(Array.from(result), Array.from(expected)))
+            })
+          })
+          describe('"pool"', () => {
+            it('should take the array from the pool and reuse it once released', () => {
+              const ds = gdal.open(`${__dirname}/data/sample.tif`)
+              const band = ds.bands.get(1)
+              const pool = gdal.createBufferPool({ type: gdal.GDT_Byte, length: 64 * 64, max: 2 })
+              const expected = band.pixels.read(0, 0, 64, 64)
+              return assert.isFulfilled(band.pixels.readAsync(0, 0, 64, 64, undefined, { pool })
+                .then((data) => {
+                  assert.instanceOf(data, Uint8Array)
+                  assert.deepEqual(data, expected)
+                  assert.equal(pool.available, 0)
+                  pool.release(data)
+                  assert.equal(pool.available, 1)
+                  return band.pixels.readAsync(0, 0, 64, 64, undefined, { pool })
+                    .then((again) => {
+                      assert.strictEqual(again.buffer, data.buffer)
+                      assert.equal(pool.available, 0)
+                    })
+                }))
+            })
+            it('should be accepted by readBlockAsync()', () => {
+              const ds = gdal.open(`${__dirname}/data/sample.tif`)
+              const band = ds.bands.get(1)
+              const pool = gdal.createBufferPool({ length: band.blockSize.x * band.blockSize.y })
+              return assert.isFulfilled(band.pixels.readBlockAsync(0, 0, pool)
+                .then((data) => {
+                  assert.instanceOf(data, Uint8Array)
+                  assert.equal(data.length, band.blockSize.x * band.blockSize.y)
+                }))
+            })
+            it('should not keep more than max arrays', () => {
+              const pool = gdal.createBufferPool({ type: gdal.GDT_Float32, length: 16, max: 1 })
+              const a = pool.get()
+              const b = pool.get()
+              assert.instanceOf(a, Float32Array)
+              pool.release(a)
+              pool.release(b)
+              pool.release(new Float32Array(16))
+              assert.equal(pool.available, 1)
+            })
+          })
+          describe('"parallel"', () => {
+            it('should read the same data using the handles of a pool', () => {
+              const ds = gdal.open(`${__dirname}/data/sample.tif`)
+              const pool = gdal.openPool(`${__dirname}/data/sample.tif`, { handles: 4 })
+              const w = ds.rasterSize.x, h = ds.rasterSize.y
+              const expected = ds.bands.get(1).pixels.read(0, 0, w, h)
+              let prevComplete = 0
+              return assert.isFulfilled(pool.bands.get(1).pixels.readAsync(0, 0, w, h, undefined, {
+                parallel: 4,
+                progress_cb: (complete): void => {
+                  assert.isAtLeast(complete, prevComplete)
+                  assert.isAtMost(complete, 1)
+                  prevComplete = complete
+                }
+              }).then((data) => {
+                assert.deepEqual(data, expected)
+                pool.close()
+              }))
+            })
+            it('should read a window with an offset', () => {
+              const ds = gdal.open(`${__dirname}/data/sample.tif`)
+              const pool = gdal.openPool(`${__dirname}/data/sample.tif`, { handles: 3 })
+              const expected = ds.bands.get(1).pixels.read(10, 7, 100, 150)
+              const data = new Uint8Array(100 * 150 + 5)
+              return assert.isFulfilled(pool.bands.get(1).pixels.readAsync(10, 7, 100, 150, data, { parallel: 3, offset: 5 })
+                .then((data) => {
+                  assert.deepEqual(data.subarray(5), expected)
+                  pool.close()
+                }))
+            })
+            it('should read sequentially without a pool', () => {
+              const ds = gdal.open(`${__dirname}/data/sample.tif`)
+              const w = ds.rasterSize.x, h = ds.rasterSize.y
+              const expected = ds.bands.get(1).pixels.read(0, 0, w, h)
+              return assert.isFulfilled(ds.bands.get(1).pixels.readAsync(0, 0, w, h, undefined, { parallel: 4 })
+                .then((data) => assert.deepEqual(data, expected)))
+            })
+          })
+          it('should validate the offset in elements of the array', () => {
+            const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Int16)
+            const band = ds.bands.get(1)
+            return assert.isRejected(band.pixels.readAsync(0, 0, 16, 16, new Int16Array(16 * 16 + 1), { offset: 2 }))
+          })
           it('should throw error if array is not long enough to store result', () => {
             const w = 16,
               h = 16
@@ -407,6 +608,63 @@ describe('gdal.RasterBandAsync', () => {
             }))
           })
         })
+        describe('readWithMaskAsync()', () => {
+          const create = (noData: number | null) => {
+            const ds = gdal.open('temp', 'w', 'MEM', 4, 2, 1, gdal.GDT_Byte)
+            const band = ds.bands.get(1)
+            band.noDataValue = noData
+            band.pixels.write(0, 0, 4, 2, new Uint8Array([ 1, 7, 3, 4, 7, 6, 7, 8 ]))
+            return band
+          }
+          it('should fill the mask when all pixels are valid', () => {
+            const band = create(null)
+            return assert.isFulfilled(band.pixels.readWithMaskAsync(0, 0, 4, 2).then((r) => {
+              assert.instanceOf(r.data, Uint8Array)
+              assert.deepEqual(Array.from(r.data), [ 1, 7, 3, 4, 7, 6, 7, 8 ])
+              assert.instanceOf(r.mask, Uint8Array)
+              assert.deepEqual(Array.from(r.mask), new Array(8).fill(255))
+            }))
+          })
+          it('should compute the mask from the NoData value', () => {
+            const band = create(7)
+            return assert.isFulfilled(band.pixels.readWithMaskAsync(0, 0, 4, 2).then((r) => {
+              assert.deepEqual(Array.from(r.data), [ 1, 7, 3, 4, 7, 6, 7, 8 ])
+              assert.deepEqual(Array.from(r.mask), [ 255, 0, 255, 255, 0, 255, 0, 255 ])
+            }))
+          })
+          it('should read the mask band when resampling', () => {
+            const band = create(7)
+            const expected = band.getMaskBand().pixels.read(0, 0, 4, 2, undefined, { buffer_width: 2, buffer_height: 1 })
+            return assert.isFulfilled(band.pixels.readWithMaskAsync(0, 0, 4, 2, undefined,
+              { buffer_width: 2, buffer_height: 1 }).then((r) => {
+              assert.equal(r.data.length, 2)
+              assert.deepEqual(Array.from(r.mask), Array.from(expected))
+            }))
+          })
+          it('should read a mask band', () => {
+            const band = create(null)
+            band.createMaskBand(2)
+            band.getMaskBand().pixels.write(0, 0, 4, 2, new Uint8Array([ 255, 255, 0, 0, 255, 0, 255, 0 ]))
+            const mask = new Uint8Array(8)
+            return assert.isFulfilled(band.pixels.readWithMaskAsync(0, 0, 4, 2, undefined, { mask }).then((r) => {
+              assert.strictEqual(r.mask, mask)
+              assert.deepEqual(Array.from(mask), [ 255, 255, 0, 0, 255, 0, 255, 0 ])
+            }))
+          })
+          it('should premultiply the data', () => {
+            const band = create(7)
+            return assert.isFulfilled(band.pixels.readWithMaskAsync(0, 0, 4, 2, undefined,
+              { type: gdal.GDT_Float32, premultiply: true }).then((r) => {
+              assert.instanceOf(r.data, Float32Array)
+              assert.deepEqual(Array.from(r.data), [ 1, 0, 3, 4, 0, 6, 0, 8 ])
+            }))
+          })
+          it('should reject if the mask is not an Uint8Array', () => {
+            const band = create(7)
+            return assert.isRejected(band.pixels.readWithMaskAsync(0, 0, 4, 2, undefined, { mask: new Float32Array(8) as unknown as Uint8Array }),
+              /Uint8Array/)
+          })
+        })
         describe('readBlockAsync()', () => {
           it('should return TypedArray', () => {
             const ds = gdal.open(`${__dirname}/data/sample.tif`)
@@ -457,6 +715,109 @@ describe('gdal.RasterBandAsync', () => {
             return assert.isRejected(band.pixels.readBlockAsync(0, 0))
           })
         })
+        describe('blocks()', () => {
+          // The expected pixels of a block, extracted from the whole raster read beforehand
+          const expectedBlock = (raster: gdal.TypedArray, size: { x: number }, blk: { x: number, y: number, width: number, height: number }) => {
+            const r = []
+            for (let j = 0; j < blk.height; j++) {
+              for (let i = 0; i < blk.width; i++) r.push(raster[(blk.y + j) * size.x + blk.x + i])
+            }
+            return r
+          }
+          it('should iterate over all the blocks', async () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            const raster = band.pixels.read(0, 0, band.size.x, band.size.y)
+            let pixels = 0
+            let blocks = 0
+            for await (const blk of band.pixels.blocks()) {
+              assert.instanceOf(blk.data, Uint8Array)
+              assert.equal(blk.data.length, blk.width * blk.height)
+              assert.deepEqual(Array.from(blk.data), expectedBlock(raster, band.size, blk))
+              pixels += blk.data.length
+              blocks++
+            }
+            assert.equal(pixels, band.size.x * band.size.y)
+            assert.equal(blocks,
+              Math.ceil(band.size.x / band.blockSize.x) * Math.ceil(band.size.y / band.blockSize.y))
+          })
+          it('should support a window and a data type', async () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            const raster = band.pixels.read(0, 0, band.size.x, band.size.y)
+            const window = { x: 10, y: band.blockSize.y - 3, width: 100, height: 7 }
+            let pixels = 0
+            for await (const blk of band.pixels.blocks({ type: gdal.GDT_Float32, window, prefetch: 3 })) {
+              assert.instanceOf(blk.data, Float32Array)
+              assert.isAtLeast(blk.x, window.x)
+              assert.isAtLeast(blk.y, window.y)
+              assert.isAtMost(blk.x + blk.width, window.x + window.width)
+              assert.isAtMost(blk.y + blk.height, window.y + window.height)
+              assert.deepEqual(Array.from(blk.data), expectedBlock(raster, band.size, blk))
+              pixels += blk.data.length
+            }
+            assert.equal(pixels, window.width * window.height)
+          })
+          it('should reject a window outside of the raster', () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            const it = band.pixels.blocks({ window: { x: 0, y: 0, width: band.size.x + 1, height: 1 } })
+            return assert.isRejected(it.next(), /window/)
+          })
+        })
+        describe('adviseReadAsync()', () => {
+          it('should accept a region', () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            return assert.isFulfilled(band.pixels.adviseReadAsync(0, 0, 100, 100, { buffer_width: 50, buffer_height: 50 }))
+          })
+        })
+        describe('lockBlockAsync()', () => {
+          it('should return the same data as readBlockAsync()', () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            return assert.isFulfilled(Promise.all([
+              band.pixels.lockBlockAsync(0, 1),
+              band.pixels.readBlockAsync(0, 1)
+            ]).then(([ locked, data ]) => {
+              assert.instanceOf(locked, Uint8Array)
+              assert.equal(locked.length, band.blockSize.x * band.blockSize.y)
+              assert.deepEqual(Array.from(locked), Array.from(data))
+              locked.release()
+            }))
+          })
+          it('should empty the array when released', () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            return assert.isFulfilled(band.pixels.lockBlockAsync(0, 0).then((locked) => {
+              assert.isAbove(locked.length, 0)
+              locked.release()
+              assert.equal(locked.length, 0)
+              locked.release()
+            }))
+          })
+          it('should empty the array when the dataset is closed', () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            return assert.isFulfilled(band.pixels.lockBlockAsync(0, 0).then((locked) => {
+              ds.close()
+              assert.equal(locked.length, 0)
+              locked.release()
+            }))
+          })
+          it('should reject if the dataset is closed before the block is delivered', () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            const p = band.pixels.lockBlockAsync(0, 0)
+            ds.close()
+            return assert.isRejected(p, /already been destroyed/)
+          })
+          it('should throw error if offsets are out of range', () => {
+            const ds = gdal.open(`${__dirname}/data/sample.tif`)
+            const band = ds.bands.get(1)
+            return assert.isRejected(band.pixels.lockBlockAsync(-1, 0))
+          })
+        })
         describe('writeBlockAsync()', () => {
           it('should write data from TypedArray', () => {
             let i
@@ -759,6 +1120,109 @@ describe('gdal.RasterBandAsync', () => {
           ds.close()
           return assert.isRejected(band.computeStatisticsAsync(false))
         })
+        it('should compute the same statistics with "parallel"', () => {
+          const file = `/vsimem/stats_parallel.${String(Math.random()).substring(2)}.tmp.tif`
+          const w = 64, h = 128
+          const ds = gdal.open(file, 'w', 'GTiff', w, h, 1, gdal.GDT_Float32, { TILED: 'YES', BLOCKXSIZE: 16, BLOCKYSIZE: 16 })
+          const data = new Float32Array(w * h)
+          for (let i = 0; i < data.length; i++) data[i] = i % 7 == 0 ? -1 : Math.sin(i) * 100
+          ds.bands.get(1).noDataValue = -1
+          ds.bands.get(1).pixels.write(0, 0, w, h, data)
+          ds.close()
+          const expected = gdal.open(file).bands.get(1).computeStatistics(false)
+          const pool = gdal.openPool(file, { handles: 4 })
+          return assert.isFulfilled(pool.bands.get(1).computeStatisticsAsync(false, { parallel: 4 }).then((stats) => {
+            assert.equal(stats.min, expected.min)
+            assert.equal(stats.max, expected.max)
+            assert.closeTo(stats.mean, expected.mean, 1e-9)
+            assert.closeTo(stats.std_dev, expected.std_dev, 1e-9)
+            pool.close()
+            gdal.vsimem.release(file)
+          }))
+        })
+      })
+      describe('computeHistogramAsync()', () => {
+        it('should count the values in buckets', () => {
+          const band = statsBand()
+          return assert.isFulfilled(band.computeHistogramAsync({ buckets: 4 }).then((hist) => {
+            assert.equal(hist.min, 0)
+            assert.equal(hist.max, 20)
+            assert.instanceOf(hist.counts, Float64Array)
+            assert.deepEqual(Array.from(hist.counts), [ 1, 254, 0, 1 ])
+          }))
+        })
+        it('should support a range, a window and the values out of range', () => {
+          const band = statsBand()
+          return assert.isFulfilled(Promise.all([
+            band.computeHistogramAsync({ min: 4, max: 6, buckets: 2 }).then((hist) => {
+              assert.deepEqual(Array.from(hist.counts), [ 0, 254 ])
+            }),
+            band.computeHistogramAsync({ min: 4, max: 6, buckets: 2, includeOutOfRange: true }).then((hist) => {
+              assert.deepEqual(Array.from(hist.counts), [ 1, 255 ])
+            }),
+            band.computeHistogramAsync({ window: { x: 8, y: 8, width: 4, height: 4 } }).then((hist) => {
+              assert.equal(hist.min, 5)
+              assert.equal(hist.max, 20)
+              assert.equal(hist.counts.reduce((a, x) => a + x, 0), 16)
+            })
+          ]))
+        })
+        it('should ignore the NoData values', () => {
+          const band = statsBand()
+          band.noDataValue = 0
+          return assert.isFulfilled(band.computeHistogramAsync({ buckets: 4 }).then((hist) => {
+            assert.equal(hist.min, 5)
+            assert.deepEqual(Array.from(hist.counts), [ 254, 0, 0, 1 ])
+          }))
+        })
+        it('should reject an invalid window', () => {
+          const band = statsBand()
+          return assert.isRejected(band.computeHistogramAsync({ window: { x: 8, y: 8, width: 16, height: 4 } }))
+        })
+        it('should reject an invalid range', () => {
+          const band = statsBand()
+          return assert.isRejected(band.computeHistogramAsync({ min: 6, max: 4 }), /max must be greater than min/)
+        })
+      })
+      describe('computePercentilesAsync()', () => {
+        it('should compute the percentiles', () => {
+          const ds = gdal.open('temp', 'w', 'MEM', 10, 10, 1, gdal.GDT_Float32)
+          const band = ds.bands.get(1)
+          const data = new Float32Array(100)
+          for (let i = 0; i < data.length; i++) data[i] = (i * 37) % 100
+          band.pixels.write(0, 0, 10, 10, data)
+          return assert.isFulfilled(band.computePercentilesAsync([ 0, 2, 50, 98, 100 ]).then((p) => {
+            assert.instanceOf(p, Float64Array)
+            const expected = [ 0, 1.98, 49.5, 97.02, 99 ]
+            for (let i = 0; i < expected.length; i++) assert.closeTo(p[i], expected[i], 1e-9)
+          }))
+        })
+        it('should return the value of a constant band', () => {
+          const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte)
+          ds.bands.get(1).fill(7)
+          return assert.eventually.deepEqual(
+            ds.bands.get(1).computePercentilesAsync([ 2, 98 ]).then((p) => Array.from(p)), [ 7, 7 ])
+        })
+        it('should compute the same percentiles with "parallel"', () => {
+          const file = `/vsimem/percentiles_parallel.${String(Math.random()).substring(2)}.tmp.tif`
+          const w = 64, h = 128
+          const ds = gdal.open(file, 'w', 'GTiff', w, h, 1, gdal.GDT_Float32, { TILED: 'YES', BLOCKXSIZE: 16, BLOCKYSIZE: 16 })
+          const data = new Float32Array(w * h)
+          for (let i = 0; i < data.length; i++) data[i] = Math.sin(i) * 100
+          ds.bands.get(1).pixels.write(0, 0, w, h, data)
+          ds.close()
+          const expected = gdal.open(file).bands.get(1).computePercentiles([ 2, 50, 98 ])
+          const pool = gdal.openPool(file, { handles: 4 })
+          return assert.isFulfilled(pool.bands.get(1).computePercentilesAsync([ 2, 50, 98 ], { parallel: 4 }).then((p) => {
+            assert.deepEqual(Array.from(p), Array.from(expected))
+            pool.close()
+            gdal.vsimem.release(file)
+          }))
+        })
+        it('should reject an invalid percentile', () => {
+          const band = statsBand()
+          return assert.isRejected(band.computePercentilesAsync([ 101 ]), /between 0 and 100/)
+        })
       })
     })
     describe('getMetadataAsync()', () => {
@@ -936,6 +936,52 @@ describe('gdal.RasterBand', () => {
               }, /Array length must be greater than.*/)
             })
           })
+          describe('"convertNoData", "noDataTo", "unscale"', () => {
+            const create = (type: string) => {
+              const ds = gdal.open('temp', 'w', 'MEM', 4, 2, 1, type)
+              const band = ds.bands.get(1)
+              band.noDataValue = 7
+              band.pixels.write(0, 0, 4, 2, new Float64Array([ 1, 7, 3, 4, 7, 6, 7, 8 ]))
+              return band
+            }
+            it('should replace the NoData value with NaN', () => {
+              const band = create(gdal.GDT_Int16)
+              const data = band.pixels.read(0, 0, 4, 2, undefined, { type: gdal.GDT_Float32, convertNoData: true })
+              assert.instanceOf(data, Float32Array)
+              assert.deepEqual(Array.from(data), [ 1, NaN, 3, 4, NaN, 6, NaN, 8 ])
+            })
+            it('should replace the NoData value with noDataTo', () => {
+              const band = create(gdal.GDT_Int16)
+              const data = band.pixels.read(0, 0, 4, 2, undefined, { convertNoData: true, noDataTo: -1 })
+              assert.instanceOf(data, Int16Array)
+              assert.deepEqual(Array.from(data), [ 1, -1, 3, 4, -1, 6, -1, 8 ])
+            })
+            it('should support pixel_space and line_space', () => {
+              const band = create(gdal.GDT_Float64)
+              const data = new Float64Array(16).fill(7)
+              band.pixels.read(0, 0, 4, 2, data, { pixel_space: 16, line_space: 64, convertNoData: true })
+              assert.deepEqual(Array.from(data), [ 1, 7, NaN, 7, 3, 7, 4, 7, NaN, 7, 6, 7, NaN, 7, 8, 7 ])
+            })
+            it('should throw when NaN cannot be represented', () => {
+              const band = create(gdal.GDT_Int16)
+              assert.throws(() => {
+                band.pixels.read(0, 0, 4, 2, undefined, { convertNoData: true })
+              }, /cannot be represented/)
+            })
+            it('should apply the scale and the offset', () => {
+              const band = create(gdal.GDT_Float32)
+              band.scale = 0.5
+              band.offset = 10
+              const data = band.pixels.read(0, 0, 4, 2, undefined, { convertNoData: true, unscale: true })
+              assert.deepEqual(Array.from(data), [ 10.5, NaN, 11.5, 12, NaN, 13, NaN, 14 ])
+            })
+            it('should throw when unscaling to an integer data type', () => {
+              const band = create(gdal.GDT_Int16)
+              assert.throws(() => {
+                band.pixels.read(0, 0, 4, 2, undefined, { unscale: true })
+              }, /floating point/)
+            })
+          })
           it('should throw an error if region is out of bounds', () => {
             const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte)
             const band = ds.bands.get(1)
@@ -1226,6 +1272,33 @@ describe('gdal.RasterBand', () => {
               assert.isAtLeast(calls, 1)
             })
           })
+          describe('"convertNoData", "noDataFrom", "unscale"', () => {
+            it('should replace NaN with the NoData value without modifying the array', () => {
+              const ds = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Int16)
+              const band = ds.bands.get(1)
+              band.noDataValue = -1
+              const data = new Float64Array([ 1, NaN, 3, NaN ])
+              band.pixels.write(0, 0, 4, 1, data, { convertNoData: true })
+              assert.deepEqual(Array.from(data), [ 1, NaN, 3, NaN ])
+              assert.deepEqual(Array.from(band.pixels.read(0, 0, 4, 1)), [ 1, -1, 3, -1 ])
+            })
+            it('should replace noDataFrom with the NoData value', () => {
+              const ds = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Int16)
+              const band = ds.bands.get(1)
+              band.noDataValue = -1
+              band.pixels.write(0, 0, 4, 1, new Int16Array([ 1, 99, 3, 4 ]), { convertNoData: true, noDataFrom: 99 })
+              assert.deepEqual(Array.from(band.pixels.read(0, 0, 4, 1)), [ 1, -1, 3, 4 ])
+            })
+            it('should apply the inverse of the scale and the offset', () => {
+              const ds = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Int16)
+              const band = ds.bands.get(1)
+              band.noDataValue = -1
+              band.scale = 0.5
+              band.offset = 10
+              band.pixels.write(0, 0, 4, 1, new Float32Array([ 10.5, NaN, 11.5, 12 ]), { convertNoData: true, unscale: true })
+              assert.deepEqual(Array.from(band.pixels.read(0, 0, 4, 1)), [ 1, -1, 3, 4 ])
+            })
+          })
         })
         it('should throw an error if region is out of bounds', () => {
           const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte)
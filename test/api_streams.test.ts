@@ -32,14 +32,14 @@ describe('gdal.RasterReadStream', () => {
     })
   }
 
-  function readTest(done: doneCb, file: string, blockOptimize: boolean) {
+  function readTest(done: doneCb, file: string, blockOptimize: boolean, prefetch?: number) {
     const ds = gdal.open(path.resolve(__dirname, 'data', file))
     const band = ds.bands.get(1)
     const expected = band.pixels.read(0, 0, band.size.x, band.size.y)
     const type = gdal.fromDataType(band.dataType)
     const actual = new type(band.size.x * band.size.y)
 
-    const rs = band.pixels.createReadStream({ blockOptimize })
+    const rs = band.pixels.createReadStream({ blockOptimize, prefetch })
     assert.instanceOf(rs, gdal.RasterReadStream)
     let length = 0
     rs.on('data', (chunk) => {
@@ -79,6 +79,9 @@ describe('gdal.RasterReadStream', () => {
   it('should accept a raster band w/o blockOptimize', (done) => readTest(done, 'sample.tif', false))
   it('should accept a raster band w/Float', (done) => readTest(done, 'AROME_T2m_10.tiff', true))
   it('should accept a raster band w/Float w/o blockOptimize', (done) => readTest(done, 'AROME_T2m_10.tiff', false))
+  it('should support prefetching', (done) => readTest(done, 'AROME_T2m_10.tiff', true, 4))
+  it('should support prefetching w/o blockOptimize', (done) => readTest(done, 'AROME_T2m_10.tiff', false, 4))
+  it('should support disabling the prefetching', (done) => readTest(done, 'AROME_T2m_10.tiff', true, 1))
   it('should support on the fly conversion w/ noData', (done) => noDataTest(done, 'dem_azimuth50_pa.img', undefined))
   it('should support noData conversion', (done) => noDataTest(done, 'dem_azimuth50_pa.img', true))
   for (const file of inputFiles) {
@@ -645,5 +645,110 @@ describe('gdal_utils', () => {
       output.close()
       gdal.vsimem.release(tempFile)
     })
+
+    it('should evaluate a string expression', async () => {
+      const tempFile = `/vsimem/cloudbase_expr_${String(Math.random()).substring(2)}.tiff`
+      const T2m = await gdal.openAsync(path.resolve(__dirname, 'data','AROME_T2m_10.tiff'))
+      const D2m = await gdal.openAsync(path.resolve(__dirname, 'data','AROME_D2m_10.tiff'))
+      const size = await T2m.rasterSizeAsync
+      const cloudBase = await gdal.openAsync(tempFile,
+        'w', 'GTiff', size.x, size.y, 1, gdal.GDT_Float64)
+
+      const espyFn = (t: number, td: number) => 125 * (t - td);
+      (await cloudBase.bands.getAsync(1)).noDataValue = -1e38
+
+      let done = 0
+      await gdal.calcAsync({
+        t: await T2m.bands.getAsync(1),
+        td: await D2m.bands.getAsync(1)
+      }, await cloudBase.bands.getAsync(1), '125 * (t - td)', {
+        convertNoData: true,
+        progress_cb: (complete) => {
+          assert.isAbove(complete, done)
+          done = complete
+        }
+      })
+      assert.closeTo(done, 1, 1e-6)
+
+      const t2mData = await (await T2m.bands.getAsync(1)).pixels.readAsync(0, 0, size.x, size.y)
+      const d2mData = await (await D2m.bands.getAsync(1)).pixels.readAsync(0, 0, size.x, size.y)
+      const cbData = await (await cloudBase.bands.getAsync(1)).pixels.readAsync(0, 0, size.x, size.y)
+      for (let i = 0; i < cbData.length; i+=1000) {
+        assert.closeTo(cbData[i], espyFn(t2mData[i], d2mData[i]), 1e-6)
+      }
+      cloudBase.close()
+      gdal.vsimem.release(tempFile)
+    })
+
+    it('should support functions, comparisons and conditionals in expressions', async () => {
+      const tempFile = `/vsimem/calc_expr_ops_${String(Math.random()).substring(2)}.tiff`
+      const src = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Float64)
+      const data = new Float64Array(16 * 16)
+      for (let i = 0; i < data.length; i++) data[i] = i - 128
+      src.bands.get(1).pixels.write(0, 0, 16, 16, data)
+      const output = await gdal.openAsync(tempFile, 'w', 'GTiff', 16, 16, 1, gdal.GDT_Float64)
+
+      await gdal.calcAsync({ a: src.bands.get(1) }, await output.bands.getAsync(1),
+        'a < 0 ? -sqrt(abs(a)) : max(a, 10) % 7 + 2^3')
+
+      const result = output.bands.get(1).pixels.read(0, 0, 16, 16)
+      for (let i = 0; i < data.length; i++) {
+        const a = data[i]
+        assert.closeTo(result[i], a < 0 ? -Math.sqrt(Math.abs(a)) : Math.max(a, 10) % 7 + 8, 1e-9)
+      }
+      output.close()
+      gdal.vsimem.release(tempFile)
+    })
+
+    it('should convert NoData values in expressions', async () => {
+      const tempFile = `/vsimem/calc_expr_nodata_${String(Math.random()).substring(2)}.tiff`
+      const dem = await gdal.openAsync(path.resolve(__dirname, 'data', 'dem_azimuth50_pa.img'))
+      const size = await dem.rasterSizeAsync
+      const output = await gdal.openAsync(tempFile,
+        'w', 'GTiff', size.x, size.y, 1, gdal.GDT_Float64);
+
+      (await output.bands.getAsync(1)).noDataValue = -100
+
+      await gdal.calcAsync({
+        dem: await dem.bands.getAsync(1)
+      }, await output.bands.getAsync(1), 'dem + 1', { convertNoData: true })
+      assert.equal(output.bands.get(1).pixels.get(0, 0), -100)
+
+      await gdal.calcAsync({
+        dem: await dem.bands.getAsync(1)
+      }, await output.bands.getAsync(1), 'isnan(dem) ? -1 : dem + 1', { convertNoData: true })
+      assert.equal(output.bands.get(1).pixels.get(0, 0), -1)
+
+      await gdal.calcAsync({
+        dem: await dem.bands.getAsync(1)
+      }, await output.bands.getAsync(1), 'dem + 1')
+      assert.equal(output.bands.get(1).pixels.get(0, 0), 1)
+      output.close()
+      gdal.vsimem.release(tempFile)
+    })
+
+    it('should reject invalid expressions', () => {
+      const T2m = gdal.open(path.resolve(__dirname, 'data','AROME_T2m_10.tiff'))
+      const size = T2m.rasterSize
+      const output = gdal.open('temp', 'w', 'MEM', size.x, size.y, 1, gdal.GDT_Float64).bands.get(1)
+      return Promise.all([
+        assert.isRejected(gdal.calcAsync({ t: T2m.bands.get(1) }, output, '125 * (t - td)'),
+          /Unknown variable "td"/),
+        assert.isRejected(gdal.calcAsync({ t: T2m.bands.get(1) }, output, 't +'), /Unexpected end/),
+        assert.isRejected(gdal.calcAsync({ t: T2m.bands.get(1) }, output, 'foo(t)'), /Unknown function "foo"/)
+      ])
+    })
+
+    it('should reject expressions when raster sizes do not match', () => {
+      return assert.isRejected(
+        gdal.calcAsync({
+          A: gdal.open(path.resolve(__dirname, 'data','AROME_T2m_10.tiff')).bands.get(1),
+          B: gdal.open(path.resolve(__dirname, 'data','sample.tif')).bands.get(1)
+        },
+        gdal.open('temp', 'w', 'MEM', 128, 128, 1, gdal.GDT_Float64).bands.get(1),
+        'A + B'),
+        /dimensions must match/
+      )
+    })
   })
 })
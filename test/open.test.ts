@@ -18,4 +18,28 @@ describe('Open', () => {
       gdal.open(filename)
     }, semver.gte(gdal.version, '3.0.0') ? /No such file or directory/ : /Error/)
   })
+
+  describe('pool', () => {
+    it('should open a Dataset with multiple handles', () => {
+      const ds = gdal.openPool(path.join(__dirname, 'data/sample.tif'), { handles: 3 })
+      assert.ok(ds instanceof gdal.Dataset)
+      assert.strictEqual(ds.bands.count(), 1)
+      ds.close()
+    })
+    it('should throw when the number of handles is invalid', () => {
+      assert.throws(() => {
+        gdal.openPool(path.join(__dirname, 'data/sample.tif'), { handles: 0 })
+      }, /handles must be at least 1/)
+    })
+    it('should read the same data from all handles', async () => {
+      const plain = gdal.open(path.join(__dirname, 'data/sample.tif'))
+      const expected = plain.bands.get(1).pixels.read(0, 0, 100, 100)
+      const ds = await gdal.openPoolAsync(path.join(__dirname, 'data/sample.tif'), { handles: 4 })
+      const band = ds.bands.get(1)
+      const reads = []
+      for (let i = 0; i < 16; i++) reads.push(band.pixels.readAsync(0, 0, 100, 100))
+      for (const data of await Promise.all(reads)) assert.deepStrictEqual(data, expected)
+      ds.close()
+    })
+  })
 })